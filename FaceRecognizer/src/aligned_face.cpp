@@ -0,0 +1,46 @@
+// aligned_face.cpp
+// 对齐人脸缓存：会话内复用裁剪缓冲区
+
+#include "aligned_face.h"
+
+import std;
+
+AlignedFaceCache::AlignedFaceCache(size_t capacity)
+    : capacity_(std::max<size_t>(1, capacity)), entries_(capacity_) {}
+
+std::shared_ptr<AlignedFace> AlignedFaceCache::Acquire(int width, int height, int channels) {
+    auto& slot = entries_[next_];
+    next_ = (next_ + 1) % capacity_;
+
+    // 仅缓存自身持有（use_count == 1，latest_ 另计）的条目可以改写
+    const long owners = (slot && slot == latest_) ? 2 : 1;
+    if (slot && slot.use_count() == owners) {
+        ++stats_.reused_buffers;
+    } else {
+        slot = std::make_shared<AlignedFace>();
+        ++stats_.allocations;
+    }
+
+    slot->width = width;
+    slot->height = height;
+    slot->channels = channels;
+    slot->pixels.resize(static_cast<size_t>(width) * height * channels);
+    slot->source = SeetaRect{0, 0, 0, 0};
+    slot->face_size = 0;
+    latest_ = slot;
+    ++stats_.crops;
+    return slot;
+}
+
+std::shared_ptr<const AlignedFace> AlignedFaceCache::Latest() const {
+    return latest_;
+}
+
+void AlignedFaceCache::Clear() {
+    for (auto& entry : entries_) {
+        entry.reset();
+    }
+    latest_.reset();
+    next_ = 0;
+    stats_ = AlignedFaceCacheStats{};
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <seeta/Common/CStruct.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 按 5 点关键点裁剪并对齐后的人脸（FaceRecognizer::CropFaceV2 的输出）
+ *
+ * 特征提取、质量评估与录入缩略图共用同一份对齐结果，整帧在对齐之后即可释放。
+ */
+struct AlignedFace {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<unsigned char> pixels;
+    SeetaRect source{0, 0, 0, 0};  // 原图中的人脸框
+    int face_size = 0;             // 原图人脸框短边，质量评估按此还原清晰度的尺度
+
+    bool valid() const { return width > 0 && height > 0 && !pixels.empty(); }
+    SeetaImageData view() const {
+        return SeetaImageData{width, height, channels, const_cast<unsigned char*>(pixels.data())};
+    }
+};
+
+/**
+ * @brief 对齐缓存统计
+ */
+struct AlignedFaceCacheStats {
+    int crops = 0;           // 对齐次数
+    int reused_buffers = 0;  // 复用已有缓冲区的次数
+    int allocations = 0;     // 新分配缓冲区的次数
+};
+
+/**
+ * @brief 单个识别会话内的对齐人脸缓存
+ *
+ * 以环形方式保留最近 capacity 个对齐结果：调用方持有的 shared_ptr 保证结果在跨阶段使用期间有效，
+ * 不再被外部持有的旧条目的像素缓冲区直接复用，稳态下不再分配内存。非线程安全，随 seetaface 实例使用。
+ */
+class AlignedFaceCache {
+public:
+    explicit AlignedFaceCache(size_t capacity = 4);
+
+    // 取一个可写条目：环中下一个位置仍被外部持有时改为新分配，不覆盖其内容
+    std::shared_ptr<AlignedFace> Acquire(int width, int height, int channels);
+
+    // 最近一次对齐结果，没有时为空
+    std::shared_ptr<const AlignedFace> Latest() const;
+
+    void Clear();
+    AlignedFaceCacheStats stats() const { return stats_; }
+
+private:
+    size_t capacity_;
+    std::vector<std::shared_ptr<AlignedFace>> entries_;
+    size_t next_ = 0;
+    std::shared_ptr<AlignedFace> latest_;
+    AlignedFaceCacheStats stats_;
+};
@@ -0,0 +1,245 @@
+// batch_extract.cpp
+// 离线批量录入：引擎池中的多个 seetaface 实例并行提取特征，输出供 Smile2Unlock 批量导入
+
+#include "batch_extract.h"
+#include "engine_pool.h"
+#include "models/feature_batch_file.h"
+
+import image_io;
+import std;
+
+namespace {
+
+using BatchClock = std::chrono::steady_clock;
+
+struct BatchJob {
+    std::string username;
+    std::filesystem::path image;
+};
+
+struct BatchResult {
+    bool ok = false;
+    std::string error;
+    std::vector<float> feature;
+    std::string thumbnail;
+};
+
+std::string Trim(std::string value) {
+    const auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
+    value.erase(value.begin(), std::find_if(value.begin(), value.end(), not_space));
+    value.erase(std::find_if(value.rbegin(), value.rend(), not_space).base(), value.end());
+    return value;
+}
+
+std::vector<BatchJob> CollectDirectoryJobs(const std::filesystem::path& directory) {
+    std::vector<BatchJob> jobs;
+    for (const auto& file : ListImageFiles(directory)) {
+        jobs.push_back(BatchJob{file.stem().string(), file});
+    }
+
+    std::vector<std::filesystem::path> user_dirs;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_directory()) {
+            user_dirs.push_back(entry.path());
+        }
+    }
+    std::sort(user_dirs.begin(), user_dirs.end());
+    for (const auto& user_dir : user_dirs) {
+        const std::string username = user_dir.filename().string();
+        for (const auto& file : ListImageFiles(user_dir)) {
+            jobs.push_back(BatchJob{username, file});
+        }
+    }
+    return jobs;
+}
+
+std::vector<BatchJob> CollectManifestJobs(const std::filesystem::path& manifest) {
+    std::vector<BatchJob> jobs;
+    std::ifstream in(manifest);
+    if (!in) {
+        std::cerr << "[Batch] 无法打开清单: " << manifest.string() << std::endl;
+        return jobs;
+    }
+
+    const auto base = manifest.parent_path();
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = Trim(line);
+        if (line.empty() || line.front() == '#') continue;
+        const size_t comma = line.find(',');
+        if (comma == std::string::npos) {
+            std::cerr << "[Batch] 清单第 " << line_number << " 行缺少逗号，已跳过" << std::endl;
+            continue;
+        }
+        BatchJob job;
+        job.username = Trim(line.substr(0, comma));
+        job.image = std::filesystem::path(Trim(line.substr(comma + 1)));
+        if (job.image.is_relative()) {
+            job.image = base / job.image;
+        }
+        if (job.username.empty()) {
+            std::cerr << "[Batch] 清单第 " << line_number << " 行用户名为空，已跳过" << std::endl;
+            continue;
+        }
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+// 缩略图直接取自特征提取所用的对齐人脸，不再从原图重新裁剪
+bool SaveThumbnail(const std::filesystem::path& directory, size_t index, const BatchJob& job,
+                   const AlignedFace& aligned, std::string& path) {
+    const std::filesystem::path file = directory / std::format("{:05}_{}.ppm", index, job.username);
+    if (!SavePpm(file, aligned.view())) {
+        return false;
+    }
+    path = file.string();
+    return true;
+}
+
+BatchResult ExtractOne(seetaface& engine, const BatchJob& job, int dim,
+                       const std::filesystem::path& thumbnails, size_t index) {
+    BatchResult result;
+    RgbImage image;
+    if (!LoadImageFile(job.image, image)) {
+        result.error = "无法读取图像";
+        return result;
+    }
+    const FrameAnalysis analysis = engine.analyze(image.view(), AnalysisFlags::FEATURES);
+    if (!analysis.face_found) {
+        result.error = "未检测到人脸";
+        return result;
+    }
+    if (!analysis.features) {
+        result.error = "特征提取失败";
+        return result;
+    }
+    result.feature.assign(analysis.features.get(), analysis.features.get() + dim);
+    result.ok = true;
+    if (!thumbnails.empty() && analysis.aligned &&
+        !SaveThumbnail(thumbnails, index, job, *analysis.aligned, result.thumbnail)) {
+        result.thumbnail.clear();
+    }
+    return result;
+}
+
+} // namespace
+
+int RunBatchExtract(const BatchExtractOptions& options) {
+    if (options.input.empty() || options.output.empty()) {
+        std::cerr << "[Batch] 需要通过 --input 指定图像目录或清单，--output 指定输出文件" << std::endl;
+        return -1;
+    }
+
+    const std::filesystem::path input(options.input);
+    const std::vector<BatchJob> jobs = std::filesystem::is_directory(input)
+        ? CollectDirectoryJobs(input)
+        : CollectManifestJobs(input);
+    if (jobs.empty()) {
+        std::cerr << "[Batch] 没有可处理的图像: " << options.input << std::endl;
+        return -1;
+    }
+
+    const int hardware = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int workers = std::clamp(options.workers > 0 ? options.workers : hardware, 1, static_cast<int>(jobs.size()));
+    std::println("[Batch] images={} workers={} input={}", jobs.size(), workers, options.input);
+
+    std::unique_ptr<EnginePool> pool;
+    try {
+        EngineOptions engine_options;
+        engine_options.detect_scale = options.detect_scale;
+        engine_options.threads = options.engine_threads;
+        pool = std::make_unique<EnginePool>(static_cast<size_t>(workers), engine_options);
+    } catch (const std::exception& e) {
+        std::cerr << "[Batch] 加载模型失败: " << e.what() << std::endl;
+        return -1;
+    }
+    const int dim = pool->feature_size();
+
+    const std::filesystem::path thumbnails(options.thumbnails);
+    if (!thumbnails.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(thumbnails, ec);
+        if (ec) {
+            std::cerr << "[Batch] 无法创建缩略图目录: " << options.thumbnails << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<BatchResult> results(jobs.size());
+    std::atomic<size_t> next_job{0};
+    std::atomic<int> completed{0};
+    std::vector<int> worker_jobs(workers, 0);
+    std::vector<size_t> worker_engine(workers, 0);  // Acquire 从空闲表尾部取引擎，编号不一定等于 worker 序号
+    std::mutex log_mutex;
+
+    const auto start = BatchClock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w]() {
+            EngineLease engine = pool->Acquire();
+            worker_engine[w] = engine.index();
+            for (size_t index = next_job++; index < jobs.size(); index = next_job++) {
+                try {
+                    results[index] = ExtractOne(*engine, jobs[index], dim, thumbnails, index);
+                } catch (const std::exception& e) {
+                    results[index].error = e.what();
+                }
+                ++worker_jobs[w];
+                const int done = ++completed;
+                if (!results[index].ok || done % 50 == 0) {
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    if (!results[index].ok) {
+                        std::println("[Batch] 失败 {} ({}): {}", jobs[index].image.string(),
+                                     jobs[index].username, results[index].error);
+                    }
+                    if (done % 50 == 0) {
+                        std::println("[Batch] 进度 {}/{}", done, jobs.size());
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(BatchClock::now() - start).count();
+
+    std::vector<smile2unlock::FeatureBatchRecord> records;
+    records.reserve(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!results[i].ok) continue;
+        records.push_back(smile2unlock::FeatureBatchRecord{
+            jobs[i].username, jobs[i].image.string(), std::move(results[i].feature)});
+    }
+
+    std::println("[Batch] 引擎池加载 {:.1f}ms，每引擎推理线程 {}", pool->load_ms(), pool->threads_per_engine());
+    for (int w = 0; w < workers; ++w) {
+        std::println("[Batch] worker {} engine={} load={:.1f}ms images={}", w, worker_engine[w],
+                     pool->load_timings(worker_engine[w]).total_ms, worker_jobs[w]);
+    }
+    std::println("[Batch] 完成 ok={} failed={} elapsed={:.1f}ms throughput={:.2f} img/s",
+                 records.size(), jobs.size() - records.size(), elapsed_ms,
+                 elapsed_ms > 0.0 ? jobs.size() * 1000.0 / elapsed_ms : 0.0);
+
+    if (records.empty()) {
+        std::cerr << "[Batch] 没有成功提取的特征，未写出文件" << std::endl;
+        return 1;
+    }
+    std::string error;
+    if (!smile2unlock::WriteFeatureBatchFile(options.output, static_cast<uint32_t>(dim), records, error)) {
+        std::cerr << "[Batch] " << error << std::endl;
+        return 1;
+    }
+    std::println("[Batch] 已写出 {} 条特征 (dim={}) -> {}", records.size(), dim, options.output);
+    if (!thumbnails.empty()) {
+        const auto written = std::count_if(results.begin(), results.end(),
+                                           [](const BatchResult& r) { return !r.thumbnail.empty(); });
+        std::println("[Batch] 已写出 {} 张对齐缩略图 -> {}", written, options.thumbnails);
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief 离线批量录入参数（-m batch-extract）
+ *
+ * input 为目录或清单文件：
+ *  - 目录：根目录下的图像以文件名（不含扩展名）为用户名，子目录中的图像以子目录名为用户名；
+ *  - 清单：每行 "用户名,图像路径"，相对路径相对清单所在目录，# 开头为注释。
+ */
+struct BatchExtractOptions {
+    std::string input;
+    std::string output;
+    int workers = 0;            // <= 0 时使用全部逻辑核
+    int engine_threads = 0;     // 每个引擎的推理线程数，<= 0 时按 逻辑核数 / workers 分配
+    std::string thumbnails;     // 对齐人脸缩略图输出目录（PPM），空表示不输出
+    float detect_scale = 1.0f;
+};
+
+/**
+ * @brief 多引擎并行提取特征并写入批量特征文件（common/models/feature_batch_file.h）
+ *
+ * 引擎池（engine_pool.h）为每个工作线程提供独立的 seetaface 实例，按原子计数领取任务；
+ * 输出顺序与输入顺序一致。
+ *
+ * @return int 0 表示至少成功提取一张并写出文件
+ */
+int RunBatchExtract(const BatchExtractOptions& options);
@@ -0,0 +1,1048 @@
+// benchmarks.cpp
+// 离线基准测试
+
+#include "benchmarks.h"
+#include "seetaface.h"
+#include "models/shared_frame_ipc.h"
+#include "utils/shared_region.h"
+#include <libyuv.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+import camera;
+import frame_pool;
+import frame_pipeline;
+import pixel_convert;
+import cpu_features;
+import feature_math;
+import frame_codec;
+import image_io;
+import std;
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double ElapsedMs(BenchClock::time_point since) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - since).count();
+}
+
+struct BenchRun {
+    int frames = 0;
+    double wall_ms = 0.0;
+    double analyze_ms = 0.0;
+    double frame_age_ms = 0.0;  // 推理开始时帧已等待的时间
+};
+
+void PrintRun(const char* label, const BenchRun& run) {
+    const double frames = std::max(1, run.frames);
+    std::println("[Bench] {:<8} frames={} wall={:.1f}ms fps={:.2f} analyze_avg={:.2f}ms frame_age_avg={:.2f}ms",
+                 label, run.frames, run.wall_ms,
+                 run.wall_ms > 0.0 ? run.frames * 1000.0 / run.wall_ms : 0.0,
+                 run.analyze_ms / frames, run.frame_age_ms / frames);
+}
+
+// 以回放目录为摄像头打开 CameraCapture，帧经与真实摄像头相同的 ConvertRawFrame 路径输出；
+// 原始格式沿用 --camera-replay-format（默认 YUY2）
+std::unique_ptr<CameraCapture> OpenReplayCamera(const std::string& replay_dir, double fps, int loops) {
+    CameraReplayOptions replay;
+    replay.path = replay_dir;
+    replay.format = CameraReplayConfig().format;
+    replay.fps = fps;
+    replay.loops = loops;
+
+    const CameraReplayOptions saved = CameraReplayConfig();
+    ConfigureCameraReplay(replay);
+    auto camera = std::make_unique<CameraCapture>(0);
+    ConfigureCameraReplay(saved);
+    return camera;
+}
+
+} // namespace
+
+int RunPipelineBenchmark(const std::string& replay_dir, double fps, int loops) {
+    if (replay_dir.empty()) {
+        std::cerr << "[Bench] 需要通过 --replay 指定回放图像目录" << std::endl;
+        return -1;
+    }
+
+    seetaface recognizer(false);
+
+    // 串行基线：读取与推理交替进行，与原 recognizeFace 循环一致
+    BenchRun serial;
+    {
+        auto camera = OpenReplayCamera(replay_dir, fps, loops);
+        if (!camera->IsInitialized()) {
+            std::cerr << "[Bench] 回放目录中没有可用图像: " << replay_dir << std::endl;
+            return -1;
+        }
+        PooledFrame frame;
+        const auto start = BenchClock::now();
+        while (camera->CaptureFrame(frame)) {
+            const auto analyze_start = BenchClock::now();
+            recognizer.analyze(frame.view(), AnalysisFlags::FEATURES);
+            serial.analyze_ms += ElapsedMs(analyze_start);
+            ++serial.frames;
+        }
+        serial.wall_ms = ElapsedMs(start);
+    }
+
+    // 串行 + 帧间 ROI 跟踪：与串行基线对比检测耗时
+    BenchRun tracked;
+    TrackingStats tracking_stats;
+    {
+        auto camera = OpenReplayCamera(replay_dir, fps, loops);
+        TrackingOptions tracking;
+        tracking.enabled = true;
+        recognizer.set_tracking(tracking);
+        PooledFrame frame;
+        const auto start = BenchClock::now();
+        while (camera->CaptureFrame(frame)) {
+            const auto analyze_start = BenchClock::now();
+            recognizer.analyze(frame.view(), AnalysisFlags::FEATURES);
+            tracked.analyze_ms += ElapsedMs(analyze_start);
+            ++tracked.frames;
+        }
+        tracked.wall_ms = ElapsedMs(start);
+        tracking_stats = recognizer.tracking_stats();
+        recognizer.set_tracking(TrackingOptions{});
+    }
+
+    // 流水线：采集线程按回放帧率推帧，推理只取最新帧
+    BenchRun pipelined;
+    PipelineStats stats;
+    {
+        FramePipeline pipeline(std::make_unique<CameraFrameSource>(OpenReplayCamera(replay_dir, fps, loops)));
+        const auto start = BenchClock::now();
+        pipeline.Start();
+        while (true) {
+            FrameLease lease = pipeline.AcquireLatest(std::chrono::milliseconds(100));
+            if (!lease) {
+                if (pipeline.Finished()) break;
+                continue;
+            }
+            const auto analyze_start = BenchClock::now();
+            pipelined.frame_age_ms += std::chrono::duration<double, std::milli>(
+                analyze_start - lease.frame().captured_at).count();
+            recognizer.analyze(lease.image(), AnalysisFlags::FEATURES);
+            pipelined.analyze_ms += ElapsedMs(analyze_start);
+            ++pipelined.frames;
+        }
+        pipelined.wall_ms = ElapsedMs(start);
+        pipeline.Stop();
+        stats = pipeline.Stats();
+    }
+
+    std::println("[Bench] pipeline replay={} fps={} loops={}", replay_dir, fps, loops);
+    PrintRun("serial", serial);
+    PrintRun("tracked", tracked);
+    PrintRun("pipeline", pipelined);
+    std::println("[Bench] tracking full={} roi={} roi_hit_rate={:.1f}% full_avg={:.2f}ms roi_avg={:.2f}ms",
+                 tracking_stats.full_detections, tracking_stats.roi_detections,
+                 tracking_stats.roi_hit_rate() * 100.0,
+                 tracking_stats.avg_full_ms(), tracking_stats.avg_roi_ms());
+    std::println("[Bench] pipeline captured={} consumed={} dropped={} capture_failures={} max_depth={}/{}",
+                 stats.captured, stats.consumed, stats.dropped, stats.capture_failures,
+                 stats.max_depth, stats.capacity);
+    return 0;
+}
+
+int RunFramePoolBenchmark(int frames, int width, int height) {
+    if (frames <= 0 || width <= 0 || height <= 0) {
+        std::cerr << "[Bench] 帧数与分辨率必须为正数" << std::endl;
+        return -1;
+    }
+
+    const std::size_t rgb_bytes = static_cast<std::size_t>(width) * height * 3;
+    const std::size_t argb_bytes = static_cast<std::size_t>(width) * height * 4;
+    std::uint64_t checksum = 0;
+
+    // 旧路径：每帧分配输出缓冲与临时 ARGB 缓冲，写满后释放
+    std::uint64_t naive_allocations = 0;
+    const auto naive_start = BenchClock::now();
+    for (int i = 0; i < frames; ++i) {
+        std::vector<std::uint8_t> argb_buffer(argb_bytes);
+        ++naive_allocations;
+        std::memset(argb_buffer.data(), i & 0xFF, argb_bytes);
+        auto* data = new unsigned char[rgb_bytes];
+        ++naive_allocations;
+        std::memset(data, argb_buffer[i % argb_bytes], rgb_bytes);
+        checksum += data[rgb_bytes / 2];
+        delete[] data;
+    }
+    const double naive_ms = ElapsedMs(naive_start);
+
+    // 新路径：帧池，单遍转换内核直接写出 RGB24，无中间缓冲
+    FramePool pool;
+    PooledFrame frame;
+    const auto pooled_start = BenchClock::now();
+    for (int i = 0; i < frames; ++i) {
+        unsigned char* data = frame.Prepare(pool, width, height, 3);
+        std::memset(data, i & 0xFF, rgb_bytes);
+        checksum += data[rgb_bytes / 2];
+    }
+    const double pooled_ms = ElapsedMs(pooled_start);
+    const FramePoolStats stats = pool.Stats();
+
+    std::println("[Bench] frame-pool frames={} size={}x{} (checksum {})", frames, width, height, checksum);
+    std::println("[Bench] new[]     allocations={} total={:.1f}ms per_frame={:.3f}ms",
+                 naive_allocations, naive_ms, naive_ms / frames);
+    std::println("[Bench] pool      allocations={} reuses={} total={:.1f}ms per_frame={:.3f}ms",
+                 stats.allocations, stats.reuses, pooled_ms, pooled_ms / frames);
+    return 0;
+}
+
+namespace {
+
+struct ConvertCase {
+    const char* name;
+    int src_bpp_num;  // 每像素源字节数 = num / den
+    int src_bpp_den;
+    std::function<void(const std::vector<std::uint8_t>&, std::vector<std::uint8_t>&, int, int)> convert;
+    std::function<void(const std::vector<std::uint8_t>&, std::vector<std::uint8_t>&, std::vector<std::uint8_t>&, int, int)> libyuv_two_step;
+};
+
+// 与 libyuv 两步转换的最大允许偏差：libyuv 使用 6 位系数（2.018 还被截为 2.0），
+// 融合内核使用 8 位系数，两者对全部 YUV 组合最多相差 2；超出说明转换系数或通道顺序有误
+constexpr int kLibyuvMaxDiff = 2;
+
+int MaxAbsDiff(const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b) {
+    int diff = 0;
+    for (std::size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        diff = std::max(diff, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+    return diff;
+}
+
+template <typename Fn>
+double AverageMs(int iterations, Fn&& fn) {
+    const auto start = BenchClock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return ElapsedMs(start) / iterations;
+}
+
+} // namespace
+
+int RunPixelConvertBenchmark(int iterations, int width, int height) {
+    if (iterations <= 0 || width <= 0 || height <= 1) {
+        std::cerr << "[Bench] 迭代次数与分辨率必须为正数" << std::endl;
+        return -1;
+    }
+    const int h = height & ~1;  // NV12 需要偶数高度
+
+    const std::vector<ConvertCase> cases = {
+        {"yuy2", 2, 1,
+         [](const auto& src, auto& dst, int w, int hh) { ConvertYuy2ToRgb24(src.data(), w * 2, dst.data(), w * 3, w, hh); },
+         [](const auto& src, auto& argb, auto& dst, int w, int hh) {
+             libyuv::YUY2ToARGB(src.data(), w * 2, argb.data(), w * 4, w, hh);
+             libyuv::ARGBToRAW(argb.data(), w * 4, dst.data(), w * 3, w, hh);
+         }},
+        {"nv12", 3, 2,
+         [](const auto& src, auto& dst, int w, int hh) {
+             ConvertNv12ToRgb24(src.data(), w, src.data() + static_cast<std::size_t>(w) * hh, w, dst.data(), w * 3, w, hh);
+         },
+         [](const auto& src, auto& argb, auto& dst, int w, int hh) {
+             libyuv::NV12ToARGB(src.data(), w, src.data() + static_cast<std::size_t>(w) * hh, w, argb.data(), w * 4, w, hh);
+             libyuv::ARGBToRAW(argb.data(), w * 4, dst.data(), w * 3, w, hh);
+         }},
+        {"bgr24-flip", 3, 1,
+         [](const auto& src, auto& dst, int w, int hh) { ConvertBgr24ToRgb24(src.data(), w * 3, dst.data(), w * 3, w, hh, true); },
+         nullptr},
+        {"bgra32", 4, 1,
+         [](const auto& src, auto& dst, int w, int hh) { ConvertBgra32ToRgb24(src.data(), w * 4, dst.data(), w * 3, w, hh); },
+         [](const auto& src, auto& argb, auto& dst, int w, int hh) {
+             (void)argb;
+             libyuv::ARGBToRAW(src.data(), w * 4, dst.data(), w * 3, w, hh);
+         }},
+    };
+
+    const std::vector<ConvertIsa> isas = {ConvertIsa::Scalar, ConvertIsa::SSSE3, ConvertIsa::AVX2, ConvertIsa::NEON};
+    const ConvertIsa original_isa = ActiveConvertIsa();
+    std::mt19937 rng(20240601);
+    bool all_exact = true;
+    bool libyuv_agrees = true;
+
+    std::println("[Bench] pixel-convert size={}x{} iterations={} cpu=[{}]",
+                 width, h, iterations, smile2unlock::cpu::DescribeCpuFeatures());
+    for (const auto& c : cases) {
+        std::vector<std::uint8_t> src(static_cast<std::size_t>(width) * h * c.src_bpp_num / c.src_bpp_den);
+        for (auto& b : src) b = static_cast<std::uint8_t>(rng());
+        std::vector<std::uint8_t> reference(static_cast<std::size_t>(width) * h * 3);
+        std::vector<std::uint8_t> output(reference.size());
+        std::vector<std::uint8_t> argb(static_cast<std::size_t>(width) * h * 4);
+
+        SetConvertIsa(ConvertIsa::Scalar);
+        c.convert(src, reference, width, h);
+
+        if (c.libyuv_two_step) {
+            c.libyuv_two_step(src, argb, output, width, h);
+            const int diff = MaxAbsDiff(reference, output);
+            libyuv_agrees = libyuv_agrees && diff <= kLibyuvMaxDiff;
+            const double ms = AverageMs(iterations, [&]() { c.libyuv_two_step(src, argb, output, width, h); });
+            std::println("[Bench] {:<11} libyuv     {:8.3f} ms  max_diff_vs_fused={}{}", c.name, ms, diff,
+                         diff <= kLibyuvMaxDiff ? "" : " EXCEEDS TOLERANCE");
+        }
+
+        for (const ConvertIsa isa : isas) {
+            if (SetConvertIsa(isa) != isa) continue;  // 当前 CPU 不支持
+            std::fill(output.begin(), output.end(), 0);
+            c.convert(src, output, width, h);
+            const bool exact = output == reference;
+            all_exact = all_exact && exact;
+            const double ms = AverageMs(iterations, [&]() { c.convert(src, output, width, h); });
+            std::println("[Bench] {:<11} {:<10} {:8.3f} ms  {}", c.name, ActiveConvertIsaName(), ms,
+                         exact ? "bit-exact" : "MISMATCH vs scalar");
+        }
+    }
+
+    // 检测缩放内核：2:1 均值与任意比例双线性
+    const std::vector<std::pair<int, int>> downscale_sizes = {{width / 2, h / 2}, {width * 3 / 4, h * 3 / 4}, {width / 3, h / 3}};
+    std::vector<std::uint8_t> rgb(static_cast<std::size_t>(width) * h * 3);
+    for (auto& b : rgb) b = static_cast<std::uint8_t>(rng());
+    for (const auto& [dst_width, dst_height] : downscale_sizes) {
+        std::vector<std::uint8_t> reference(static_cast<std::size_t>(dst_width) * dst_height * 3);
+        std::vector<std::uint8_t> output(reference.size());
+        auto downscale = [&]() {
+            DownscaleRgb24(rgb.data(), width * 3, width, h, output.data(), dst_width * 3, dst_width, dst_height);
+        };
+        SetConvertIsa(ConvertIsa::Scalar);
+        DownscaleRgb24(rgb.data(), width * 3, width, h, reference.data(), dst_width * 3, dst_width, dst_height);
+        for (const ConvertIsa isa : isas) {
+            if (SetConvertIsa(isa) != isa) continue;
+            std::fill(output.begin(), output.end(), 0);
+            downscale();
+            const bool exact = output == reference;
+            all_exact = all_exact && exact;
+            const double ms = AverageMs(iterations, downscale);
+            std::println("[Bench] down-{}x{} {:<10} {:8.3f} ms  {}", dst_width, dst_height, ActiveConvertIsaName(), ms,
+                         exact ? "bit-exact" : "MISMATCH vs scalar");
+        }
+    }
+
+    SetConvertIsa(original_isa);
+    return (all_exact && libyuv_agrees) ? 0 : 1;
+}
+
+namespace {
+
+double RectIou(const SeetaRect& a, const SeetaRect& b) {
+    const int x0 = std::max(a.x, b.x);
+    const int y0 = std::max(a.y, b.y);
+    const int x1 = std::min(a.x + a.width, b.x + b.width);
+    const int y1 = std::min(a.y + a.height, b.y + b.height);
+    if (x1 <= x0 || y1 <= y0) return 0.0;
+    const double inter = static_cast<double>(x1 - x0) * (y1 - y0);
+    const double uni = static_cast<double>(a.width) * a.height + static_cast<double>(b.width) * b.height - inter;
+    return uni > 0.0 ? inter / uni : 0.0;
+}
+
+std::vector<float> ParseScales(const std::string& text) {
+    std::vector<float> scales;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        try {
+            const float scale = std::stof(item);
+            if (scale >= 0.25f && scale <= 1.0f) {
+                scales.push_back(scale);
+            } else {
+                std::cerr << "[Bench] 忽略超出范围的缩放比例: " << item << std::endl;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "[Bench] 无效的缩放比例: " << item << std::endl;
+        }
+    }
+    // 1.0 作为召回基准，总是最先运行
+    std::erase(scales, 1.0f);
+    scales.insert(scales.begin(), 1.0f);
+    return scales;
+}
+
+} // namespace
+
+int RunDetectScaleBenchmark(const std::string& image_dir, const std::string& scales_text) {
+    if (image_dir.empty()) {
+        std::cerr << "[Bench] 需要通过 --replay 指定测试图像目录" << std::endl;
+        return -1;
+    }
+
+    std::vector<RgbImage> images;
+    for (const auto& file : ListImageFiles(image_dir)) {
+        RgbImage image;
+        if (LoadImageFile(file, image)) {
+            images.push_back(std::move(image));
+        }
+    }
+    if (images.empty()) {
+        std::cerr << "[Bench] 测试目录中没有可用图像: " << image_dir << std::endl;
+        return -1;
+    }
+
+    const std::vector<float> scales = ParseScales(scales_text);
+    seetaface recognizer(false);
+
+    struct Baseline {
+        bool found = false;
+        SeetaRect face{0, 0, 0, 0};
+        std::shared_ptr<float> features;
+    };
+    std::vector<Baseline> baseline(images.size());
+
+    std::println("[Bench] detect-scale images={} dir={}", images.size(), image_dir);
+    double baseline_detect_ms = 0.0;
+    for (const float scale : scales) {
+        recognizer.set_detect_scale(scale);
+        recognizer.analyze(images.front().view(), AnalysisFlags::DETECT_ONLY);  // 预热缓冲区
+
+        const bool is_baseline = scale == 1.0f;
+        double detect_ms = 0.0;
+        int found = 0;
+        int baseline_found = 0;
+        int matched = 0;
+        double iou_sum = 0.0;
+        double similarity_sum = 0.0;
+        int similarity_count = 0;
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            const FrameAnalysis analysis = recognizer.analyze(images[i].view(), AnalysisFlags::FEATURES);
+            detect_ms += analysis.timings.detect_ms;
+            found += analysis.face_found ? 1 : 0;
+
+            if (is_baseline) {
+                baseline[i] = Baseline{analysis.face_found, analysis.face, analysis.features};
+                continue;
+            }
+            if (!baseline[i].found) continue;
+            ++baseline_found;
+            if (!analysis.face_found) continue;
+            const double iou = RectIou(baseline[i].face, analysis.face);
+            if (iou >= 0.5) {
+                ++matched;
+                iou_sum += iou;
+                if (analysis.features && baseline[i].features) {
+                    similarity_sum += recognizer.feat_compare(baseline[i].features, analysis.features);
+                    ++similarity_count;
+                }
+            }
+        }
+
+        const double avg_detect_ms = detect_ms / images.size();
+        if (is_baseline) {
+            baseline_detect_ms = avg_detect_ms;
+            std::println("[Bench] scale={:.2f} detect_avg={:.2f}ms found={}/{} (baseline)",
+                         scale, avg_detect_ms, found, images.size());
+            continue;
+        }
+        std::println("[Bench] scale={:.2f} detect_avg={:.2f}ms speedup={:.2f}x found={}/{} recall={:.1f}% "
+                     "iou_avg={:.3f} feature_similarity_avg={:.4f}",
+                     scale, avg_detect_ms,
+                     avg_detect_ms > 0.0 ? baseline_detect_ms / avg_detect_ms : 0.0,
+                     found, images.size(),
+                     baseline_found > 0 ? matched * 100.0 / baseline_found : 0.0,
+                     matched > 0 ? iou_sum / matched : 0.0,
+                     similarity_count > 0 ? similarity_sum / similarity_count : 0.0);
+    }
+
+    recognizer.set_detect_scale(1.0f);
+    return 0;
+}
+
+int RunQualityBenchmark(const std::string& image_dir, const QualityThresholds& thresholds) {
+    if (image_dir.empty()) {
+        std::cerr << "[Bench] 需要通过 --replay 指定测试图像目录" << std::endl;
+        return -1;
+    }
+    const auto files = ListImageFiles(image_dir);
+    if (files.empty()) {
+        std::cerr << "[Bench] 测试目录中没有可用图像: " << image_dir << std::endl;
+        return -1;
+    }
+
+    seetaface recognizer(false);
+    QualityThresholds gate = thresholds;
+    gate.enabled = true;
+    recognizer.set_quality_gate(gate);
+
+    FaceQualityScorer simd_scorer(true);
+    FaceQualityScorer scalar_scorer(false);
+    std::array<int, static_cast<std::size_t>(QualityIssue::COUNT)> issues{};
+    double simd_ms = 0.0;
+    double scalar_ms = 0.0;
+    int scored = 0;
+    bool consistent = true;
+    constexpr int kRepeats = 20;
+
+    std::println("[Bench] quality images={} dir={}", files.size(), image_dir);
+    for (const auto& file : files) {
+        RgbImage image;
+        if (!LoadImageFile(file, image)) continue;
+        const FrameAnalysis analysis = recognizer.analyze(image.view(), AnalysisFlags::QUALITY_GATE);
+        if (!analysis.face_found) {
+            std::println("[Bench] {:<32} no face", file.filename().string());
+            continue;
+        }
+        if (analysis.points.empty()) {
+            // 人脸过小，未定位关键点
+            ++issues[static_cast<std::size_t>(QualityIssue::TOO_SMALL)];
+            std::println("[Bench] {:<32} size={} -> {}", file.filename().string(),
+                         analysis.quality.face_size, QualityIssueName(analysis.quality.issue));
+            continue;
+        }
+
+        const int point_count = static_cast<int>(analysis.points.size());
+        FaceQuality simd_quality;
+        FaceQuality scalar_quality;
+        auto start = BenchClock::now();
+        for (int i = 0; i < kRepeats; ++i) {
+            simd_quality = simd_scorer.Score(image.view(), analysis.face, analysis.points.data(), point_count, gate);
+        }
+        simd_ms += ElapsedMs(start) / kRepeats;
+        start = BenchClock::now();
+        for (int i = 0; i < kRepeats; ++i) {
+            scalar_quality = scalar_scorer.Score(image.view(), analysis.face, analysis.points.data(), point_count, gate);
+        }
+        scalar_ms += ElapsedMs(start) / kRepeats;
+        ++scored;
+
+        const bool same = simd_quality.brightness == scalar_quality.brightness &&
+                          simd_quality.contrast == scalar_quality.contrast &&
+                          simd_quality.sharpness == scalar_quality.sharpness;
+        consistent = consistent && same;
+        ++issues[static_cast<std::size_t>(simd_quality.issue)];
+        std::println("[Bench] {:<32} size={} brightness={:.1f} contrast={:.1f} sharpness={:.1f} yaw={:.2f} -> {}{}",
+                     file.filename().string(), simd_quality.face_size, simd_quality.brightness,
+                     simd_quality.contrast, simd_quality.sharpness, simd_quality.yaw,
+                     QualityIssueName(simd_quality.issue), same ? "" : " (MISMATCH vs scalar)");
+    }
+
+    std::string summary;
+    for (std::size_t i = 0; i < issues.size(); ++i) {
+        summary += std::format(" {}={}", QualityIssueName(static_cast<QualityIssue>(i)), issues[i]);
+    }
+    std::println("[Bench] quality verdicts:{}", summary);
+    if (scored > 0) {
+        std::println("[Bench] quality score_avg simd={:.3f}ms scalar={:.3f}ms ({})",
+                     simd_ms / scored, scalar_ms / scored, consistent ? "consistent" : "MISMATCH");
+    }
+    return consistent ? 0 : 1;
+}
+
+int RunFusionBenchmark(const std::string& image_dir, const FusionOptions& options) {
+    if (image_dir.empty()) {
+        std::cerr << "[Bench] 需要通过 --replay 指定测试图像目录" << std::endl;
+        return -1;
+    }
+
+    seetaface recognizer(false);
+    const int dim = recognizer.feature_size();
+    struct Frame {
+        std::shared_ptr<float> features;
+        float weight = 0.0f;
+    };
+    std::vector<Frame> frames;
+    for (const auto& file : ListImageFiles(image_dir)) {
+        RgbImage image;
+        if (!LoadImageFile(file, image)) continue;
+        const FrameAnalysis analysis = recognizer.analyze(image.view(), AnalysisFlags::FEATURES | AnalysisFlags::QUALITY_GATE);
+        if (!analysis.features) continue;
+        frames.push_back(Frame{analysis.features,
+                               FusionWeight(analysis.face_score, analysis.quality_checked ? &analysis.quality : nullptr)});
+    }
+    if (frames.size() < 2) {
+        std::cerr << "[Bench] 至少需要两张可提取特征的图像（首张为模板）: " << image_dir << std::endl;
+        return -1;
+    }
+
+    const Frame& enrolled = frames.front();
+    std::vector<GalleryEntry> gallery(1);
+    gallery[0].label = 0;
+    gallery[0].feature.assign(enrolled.features.get(), enrolled.features.get() + dim);
+    const std::size_t probes = frames.size() - 1;
+
+    int single_pass = 0;
+    int fused_pass = 0;
+    int confident = 0;
+    int frames_used = 0;
+    int converge_frames = 0;
+    double fused_similarity = 0.0;
+    double add_ms = 0.0;
+    int adds = 0;
+    EmbeddingFusion with_gallery(options);
+    EmbeddingFusion without_gallery(options);
+    for (std::size_t start = 1; start < frames.size(); ++start) {
+        single_pass += recognizer.feat_compare(enrolled.features, frames[start].features) >= options.match_threshold ? 1 : 0;
+
+        with_gallery.SetGallery(gallery);
+        without_gallery.Reset();
+        FusionState state;
+        for (std::size_t i = start; i < frames.size(); ++i) {
+            const auto begin = BenchClock::now();
+            state = with_gallery.Add(frames[i].features.get(), dim, frames[i].weight);
+            add_ms += ElapsedMs(begin);
+            ++adds;
+            if (state.decision != FusionDecision::CONTINUE) break;
+        }
+        fused_pass += state.best_score >= options.match_threshold ? 1 : 0;
+        confident += state.decision == FusionDecision::CONFIDENT ? 1 : 0;
+        frames_used += state.frames;
+        fused_similarity += state.best_score;
+
+        FusionState converge;
+        for (std::size_t i = start; i < frames.size(); ++i) {
+            converge = without_gallery.Add(frames[i].features.get(), dim, frames[i].weight);
+            if (converge.decision != FusionDecision::CONTINUE) break;
+        }
+        converge_frames += converge.frames;
+    }
+
+    const double sessions = static_cast<double>(probes);
+    std::println("[Bench] fusion frames={} sessions={} top_k={} max_frames={} min_margin={:.3f} threshold={:.3f}",
+                 frames.size(), probes, options.top_k, options.max_frames, options.min_margin, options.match_threshold);
+    std::println("[Bench] single-frame pass={}/{} ({:.1f}%)", single_pass, probes, single_pass * 100.0 / sessions);
+    std::println("[Bench] fused        pass={}/{} ({:.1f}%) confident={} frames_avg={:.2f} similarity_avg={:.4f}",
+                 fused_pass, probes, fused_pass * 100.0 / sessions, confident,
+                 frames_used / sessions, fused_similarity / sessions);
+    std::println("[Bench] no-gallery   frames_avg={:.2f} (收敛判定)", converge_frames / sessions);
+    std::println("[Bench] fusion add_avg={:.4f}ms dim={}", adds > 0 ? add_ms / adds : 0.0, dim);
+    return 0;
+}
+
+int RunCameraReplayBenchmark(const std::string& image_dir, int frames) {
+    if (image_dir.empty() || frames <= 0) {
+        std::cerr << "[Bench] 需要通过 --replay 指定测试图像目录，--frames 为正数" << std::endl;
+        return -1;
+    }
+    const auto files = ListImageFiles(image_dir);
+    RgbImage first;
+    if (files.empty() || !LoadImageFile(files.front(), first)) {
+        std::cerr << "[Bench] 目录中没有可读取的图像: " << image_dir << std::endl;
+        return -1;
+    }
+
+    const CameraReplayOptions saved = CameraReplayConfig();
+    bool all_ok = true;
+    std::println("[Bench] camera-replay images={} frames={} size={}x{}", files.size(), frames, first.width, first.height);
+    for (const RawFrameFormat format : {RawFrameFormat::YUY2, RawFrameFormat::NV12,
+                                        RawFrameFormat::BGR24, RawFrameFormat::BGRA32}) {
+        CameraReplayOptions replay;
+        replay.path = image_dir;
+        replay.format = format;
+        replay.fps = 0.0;
+        replay.loops = 0;
+        ConfigureCameraReplay(replay);
+
+        CameraCapture camera(0);
+        PooledFrame frame;
+        if (!camera.IsInitialized() || !camera.CaptureFrame(frame)) {
+            std::println("[Bench] {:<7} 初始化失败", RawFrameFormatName(format));
+            all_ok = false;
+            continue;
+        }
+
+        // 首帧与原图比较：YUV 格式受色度下采样与有限范围量化影响，BGR 格式应无误差
+        double error = 0.0;
+        const int w = std::min(frame.width, first.width);
+        const int h = std::min(frame.height, first.height);
+        const unsigned char* data = frame.buffer.data();
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w * 3; ++x) {
+                error += std::abs(static_cast<int>(data[static_cast<std::size_t>(y) * frame.width * 3 + x]) -
+                                  static_cast<int>(first.pixels[static_cast<std::size_t>(y) * first.width * 3 + x]));
+            }
+        }
+        error /= std::max(1.0, static_cast<double>(w) * h * 3);
+
+        int captured = 0;
+        const auto begin = BenchClock::now();
+        for (int i = 0; i < frames && camera.CaptureFrame(frame); ++i) {
+            ++captured;
+        }
+        const double ms = ElapsedMs(begin);
+        all_ok = all_ok && captured == frames;
+        std::println("[Bench] {:<7} frames={} capture_avg={:.3f}ms fps={:.1f} mean_abs_err={:.2f}",
+                     RawFrameFormatName(format), captured, captured > 0 ? ms / captured : 0.0,
+                     ms > 0.0 ? captured * 1000.0 / ms : 0.0, error);
+    }
+    ConfigureCameraReplay(saved);
+    return all_ok ? 0 : 1;
+}
+
+int RunFeatureMathBenchmark(int gallery_size, int dim) {
+    if (gallery_size <= 0 || dim <= 0) {
+        std::cerr << "[Bench] 图库大小与特征维度必须为正数" << std::endl;
+        return -1;
+    }
+    namespace feature = smile2unlock::feature;
+    const std::size_t count = static_cast<std::size_t>(gallery_size);
+    const std::size_t n = static_cast<std::size_t>(dim);
+    std::mt19937 rng(20240601);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> vectors(count * n);
+    for (auto& v : vectors) v = dist(rng);
+    for (std::size_t i = 0; i < count; ++i) feature::Normalize(vectors.data() + i * n, n);
+
+    std::vector<float> reference(count * count);
+    std::vector<float> scores(reference.size());
+    feature::SetFeatureIsa(feature::FeatureIsa::Scalar);
+    feature::ScoreMatrix(vectors.data(), count, vectors.data(), count, n, reference.data());
+
+    bool all_close = true;
+    std::println("[Bench] feature-math vectors={} dim={} cpu=[{}]", count, n, smile2unlock::cpu::DescribeCpuFeatures());
+    for (const auto isa : {feature::FeatureIsa::Scalar, feature::FeatureIsa::SSE2,
+                           feature::FeatureIsa::AVX2, feature::FeatureIsa::NEON}) {
+        if (feature::SetFeatureIsa(isa) != isa) continue;  // 当前 CPU 不支持
+        const auto begin = BenchClock::now();
+        feature::ScoreMatrix(vectors.data(), count, vectors.data(), count, n, scores.data());
+        const double ms = ElapsedMs(begin);
+        float max_diff = 0.0f;
+        for (std::size_t i = 0; i < scores.size(); ++i) {
+            max_diff = std::max(max_diff, std::abs(scores[i] - reference[i]));
+        }
+        all_close = all_close && max_diff <= 1e-4f;
+        std::println("[Bench] {:<7} {:8.2f} ms  {:.1f}M pairs/s  max_diff_vs_scalar={:.2e}",
+                     feature::ActiveFeatureIsaName(), ms, ms > 0.0 ? scores.size() / ms / 1000.0 : 0.0, max_diff);
+    }
+    feature::SetFeatureIsa(feature::FeatureIsa::Auto);
+    return all_close ? 0 : 1;
+}
+
+int RunMotionGateBenchmark(int frames, const MotionGateOptions& options) {
+    if (frames <= 0) {
+        std::cerr << "[Bench] 帧数必须为正数" << std::endl;
+        return -1;
+    }
+    constexpr int kWidth = 640;
+    constexpr int kHeight = 480;
+    constexpr int kSquare = 96;
+    const auto frame_interval = std::chrono::milliseconds(33);
+
+    // 固定背景 + 每帧 ±2 的传感器噪声，运动段叠加一个逐帧平移的亮方块
+    std::mt19937 rng(20240601);
+    std::vector<std::uint8_t> background(static_cast<std::size_t>(kWidth) * kHeight * 3);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            std::uint8_t* px = background.data() + (static_cast<std::size_t>(y) * kWidth + x) * 3;
+            px[0] = static_cast<std::uint8_t>((x * 255) / kWidth);
+            px[1] = static_cast<std::uint8_t>((y * 255) / kHeight);
+            px[2] = static_cast<std::uint8_t>(((x / 40 + y / 40) % 2) ? 160 : 60);
+        }
+    }
+    std::vector<std::uint8_t> pixels(background.size());
+    std::uniform_int_distribution<int> noise(-2, 2);
+    const auto render = [&](int square_x) {
+        for (std::size_t i = 0; i < pixels.size(); ++i) {
+            pixels[i] = static_cast<std::uint8_t>(std::clamp(background[i] + noise(rng), 0, 255));
+        }
+        if (square_x < 0) return;
+        for (int y = 160; y < 160 + kSquare; ++y) {
+            for (int x = square_x; x < std::min(kWidth, square_x + kSquare); ++x) {
+                std::uint8_t* px = pixels.data() + (static_cast<std::size_t>(y) * kWidth + x) * 3;
+                px[0] = px[1] = px[2] = 240;
+            }
+        }
+    };
+    const SeetaImageData image{kWidth, kHeight, 3, pixels.data()};
+
+    // SIMD 与标量块差一致性：相邻两帧噪声场景与方块场景
+    MotionGateOptions always_check = options;
+    always_check.enabled = true;
+    bool consistent = true;
+    {
+        std::vector<std::uint8_t> a(static_cast<std::size_t>(MotionGate::kPlaneWidth) * MotionGate::kPlaneHeight);
+        std::vector<std::uint8_t> b(a.size());
+        std::uniform_int_distribution<int> byte(0, 255);
+        for (int round = 0; round < 16; ++round) {
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                a[i] = static_cast<std::uint8_t>(byte(rng));
+                b[i] = static_cast<std::uint8_t>(byte(rng));
+            }
+            const float simd = MotionGate::MaxBlockDifference(a.data(), b.data(), MotionGate::kPlaneWidth, MotionGate::kPlaneHeight, true);
+            const float scalar = MotionGate::MaxBlockDifference(a.data(), b.data(), MotionGate::kPlaneWidth, MotionGate::kPlaneHeight, false);
+            consistent = consistent && simd == scalar;
+        }
+    }
+
+    // 两段模拟会话：静止段每帧推理后都判为无人脸，运动段方块每帧右移 8 像素
+    const auto run_segment = [&](bool moving, bool use_simd, MotionGateStats& stats, int& inferred) {
+        MotionGate gate(always_check, use_simd);
+        auto now = MotionGate::Clock::time_point{} + std::chrono::hours(1);
+        inferred = 0;
+        for (int i = 0; i < frames; ++i) {
+            render(moving ? (i * 8) % (kWidth - kSquare) : -1);
+            if (gate.ShouldInfer(image, now)) {
+                ++inferred;
+                gate.OnInferred(false, now);
+            }
+            now += frame_interval;
+        }
+        stats = gate.stats();
+    };
+
+    std::println("[Bench] motion-gate frames={} size={}x{} threshold={:.1f} force_interval={}ms",
+                 frames, kWidth, kHeight, always_check.block_threshold, always_check.force_interval_ms);
+    bool gated_static = true;
+    bool passed_motion = true;
+    for (const bool use_simd : {false, true}) {
+        for (const bool moving : {false, true}) {
+            MotionGateStats stats;
+            int inferred = 0;
+            run_segment(moving, use_simd, stats, inferred);
+            const double checked = std::max(1, stats.checked);
+            std::println("[Bench] {:<6} {:<6} inferred={}/{} skipped={} changed={} forced={} gate_avg={:.3f}ms",
+                         use_simd ? "simd" : "scalar", moving ? "motion" : "static",
+                         inferred, frames, stats.skipped, stats.changed, stats.forced, stats.gate_ms / checked);
+            if (moving) {
+                passed_motion = passed_motion && stats.skipped == 0;
+            } else {
+                gated_static = gated_static && (frames < 2 || stats.skipped > 0);
+            }
+        }
+    }
+    std::println("[Bench] simd_vs_scalar={} static_gated={} motion_passed={}",
+                 consistent ? "一致" : "不一致", gated_static ? "是" : "否", passed_motion ? "是" : "否");
+    return consistent && gated_static && passed_motion ? 0 : 1;
+}
+
+namespace {
+
+// 帧内容完全由帧号决定：首 4 字节为帧号，其余字节为帧号派生的常量，读端据此判断是否撕裂
+void FillRingFrame(std::vector<std::uint8_t>& frame, std::uint32_t sequence) {
+    std::memset(frame.data(), static_cast<int>((sequence * 31u) & 0xFFu), frame.size());
+    std::memcpy(frame.data(), &sequence, sizeof(sequence));
+}
+
+bool RingFrameIntact(const std::uint8_t* data, std::size_t bytes, std::uint32_t& sequence) {
+    std::memcpy(&sequence, data, sizeof(sequence));
+    const auto expected = static_cast<std::uint8_t>((sequence * 31u) & 0xFFu);
+    for (std::size_t i = sizeof(sequence); i < bytes; ++i) {
+        if (data[i] != expected) return false;
+    }
+    return true;
+}
+
+struct RingReaderStats {
+    std::uint64_t reads = 0;
+    std::uint64_t torn = 0;
+    std::uint64_t contended = 0;
+    std::uint64_t out_of_order = 0;
+};
+
+} // namespace
+
+int RunSharedFrameRingBenchmark(int frames, int readers) {
+    if (frames <= 0 || readers <= 0) {
+        std::cerr << "[Bench] 帧数与读端数必须为正数" << std::endl;
+        return -1;
+    }
+    namespace ipc = smile2unlock;
+    constexpr int kWidth = 640;
+    constexpr int kHeight = 480;
+    const std::size_t frame_bytes = static_cast<std::size_t>(kWidth) * kHeight * 3;
+    const std::size_t mapping_bytes = ipc::SharedFrameMappingBytes();
+#if defined(_WIN32)
+    const std::string name = std::format("Local\\Smile2Unlock_RingBench_{}", GetCurrentProcessId());
+#else
+    const std::string name = std::format("smile2unlock_ring_bench_{}", getpid());
+#endif
+
+    // 写端与读端各自映射一次，与 FR / SU 跨进程时的访问方式一致
+    const ipc::SharedRegion writer_region = ipc::SharedRegion::Create(name, mapping_bytes);
+    if (!writer_region) {
+        std::cerr << "[Bench] 创建共享内存失败: " << name << " error=" << writer_region.error() << std::endl;
+        return -1;
+    }
+    std::println("[Bench] shm-ring frames={} readers={} frame={}x{} slots={} mapping={:.1f}MB",
+                 frames, readers, kWidth, kHeight, ipc::SharedFrameHeader::SLOT_COUNT,
+                 mapping_bytes / (1024.0 * 1024.0));
+
+    // legacy：v2 的做法，单一缓冲区原地写入后递增帧号，读端直接拷贝；ring：v3 多槽位 seqlock
+    bool ring_ok = true;
+    for (const bool use_ring : {false, true}) {
+        auto* header = new (writer_region.data()) ipc::SharedFrameHeader{};
+        std::atomic<bool> done{false};
+        std::vector<RingReaderStats> stats(static_cast<std::size_t>(readers));
+        std::vector<std::thread> threads;
+
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                const auto reader_region =
+                    ipc::SharedRegion::Open(name, mapping_bytes, ipc::SharedRegionAccess::ReadWrite);
+                const auto* shared = reader_region.as<const ipc::SharedFrameHeader>();
+                if (shared == nullptr) return;
+                RingReaderStats& local = stats[static_cast<std::size_t>(r)];
+                std::vector<std::uint8_t> image;
+                std::uint32_t last = 0;
+                std::uint32_t last_seen = 0;
+                while (!done.load(std::memory_order_acquire)) {
+                    std::uint32_t sequence = 0;
+                    if (use_ring) {
+                        ipc::SharedFrameSlot info;
+                        const auto result = ipc::ReadLatestSharedFrame(shared, last, info, image);
+                        if (result == ipc::SharedFrameRead::CONTENDED) ++local.contended;
+                        if (result != ipc::SharedFrameRead::OK) continue;
+                        last = info.frame_sequence;
+                    } else {
+                        const std::uint32_t published = ipc::LatestSharedFrameSequence(shared);
+                        if (published == 0 || published == last) continue;
+                        image.assign(ipc::SharedFrameSlotData(shared, 0), ipc::SharedFrameSlotData(shared, 0) + frame_bytes);
+                        last = published;
+                    }
+                    ++local.reads;
+                    if (!RingFrameIntact(image.data(), image.size(), sequence)) {
+                        ++local.torn;
+                    } else if (sequence < last_seen) {
+                        ++local.out_of_order;
+                    } else {
+                        last_seen = sequence;
+                    }
+                }
+            });
+        }
+
+        std::vector<std::uint8_t> frame(frame_bytes);
+        ipc::SharedFrameSlot info;
+        info.width = kWidth;
+        info.height = kHeight;
+        info.channels = 3;
+        info.image_bytes = static_cast<std::uint32_t>(frame_bytes);
+        const auto start = BenchClock::now();
+        for (int i = 1; i <= frames; ++i) {
+            FillRingFrame(frame, static_cast<std::uint32_t>(i));
+            if (use_ring) {
+                ipc::PublishSharedFrame(header, info, frame.data());
+            } else {
+                std::memcpy(ipc::SharedFrameSlotData(header, 0), frame.data(), frame_bytes);
+                std::atomic_ref<std::uint32_t>(header->frame_sequence).store(static_cast<std::uint32_t>(i), std::memory_order_release);
+            }
+        }
+        const double write_ms = ElapsedMs(start);
+        done.store(true, std::memory_order_release);
+        for (auto& thread : threads) thread.join();
+
+        RingReaderStats total;
+        for (const auto& local : stats) {
+            total.reads += local.reads;
+            total.torn += local.torn;
+            total.contended += local.contended;
+            total.out_of_order += local.out_of_order;
+        }
+        std::println("[Bench] {:<6} write_avg={:.3f}ms writer_fps={:.0f} reads={} torn={} out_of_order={} contended={}",
+                     use_ring ? "ring" : "legacy", write_ms / frames, write_ms > 0.0 ? frames * 1000.0 / write_ms : 0.0,
+                     total.reads, total.torn, total.out_of_order, total.contended);
+        if (use_ring) {
+            ring_ok = total.torn == 0 && total.out_of_order == 0;
+        }
+    }
+    std::println("[Bench] ring 结果{}", ring_ok ? "无撕裂帧" : "出现撕裂或乱序帧");
+    return ring_ok ? 0 : 1;
+}
+
+int RunPreviewCodecBenchmark(int iterations, int width, int height) {
+    if (iterations <= 0 || width <= 0 || height <= 0) {
+        std::cerr << "[Bench] 迭代次数与分辨率必须为正数" << std::endl;
+        return -1;
+    }
+    namespace codec = smile2unlock::codec;
+
+    // 平滑渐变 + 噪声，接近摄像头画面
+    std::mt19937 rng(20240601);
+    std::vector<std::uint8_t> rgb(static_cast<std::size_t>(width) * height * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            std::uint8_t* p = rgb.data() + (static_cast<std::size_t>(y) * width + x) * 3;
+            p[0] = static_cast<std::uint8_t>(std::clamp(x * 255 / width + static_cast<int>(rng() % 9) - 4, 0, 255));
+            p[1] = static_cast<std::uint8_t>(std::clamp(y * 255 / height + static_cast<int>(rng() % 9) - 4, 0, 255));
+            p[2] = static_cast<std::uint8_t>(rng());
+        }
+    }
+
+    // 1. 各指令集编解码与标量逐位比对，往返误差不超过量化步长
+    std::vector<std::uint8_t> reference_565(codec::Rgb565Bytes(width, height));
+    std::vector<std::uint8_t> reference_rgb(rgb.size());
+    codec::SetCodecIsa(codec::CodecIsa::Scalar);
+    codec::EncodeRgb565(rgb.data(), width * 3, width, height, reference_565.data());
+    codec::DecodeRgb565(reference_565.data(), width, height, reference_rgb.data(), width * 3);
+    const int round_trip_error = MaxAbsDiff(rgb, reference_rgb);
+    bool all_ok = round_trip_error <= 7;
+
+    std::vector<std::uint8_t> encoded(reference_565.size());
+    std::vector<std::uint8_t> decoded(rgb.size());
+    std::println("[Bench] preview-codec size={}x{} iterations={} cpu=[{}] round_trip_max_err={}",
+                 width, height, iterations, smile2unlock::cpu::DescribeCpuFeatures(), round_trip_error);
+    for (const auto isa : {codec::CodecIsa::Scalar, codec::CodecIsa::SSSE3, codec::CodecIsa::NEON}) {
+        if (codec::SetCodecIsa(isa) != isa) continue;  // 当前 CPU 不支持
+        std::fill(encoded.begin(), encoded.end(), 0);
+        std::fill(decoded.begin(), decoded.end(), 0);
+        codec::EncodeRgb565(rgb.data(), width * 3, width, height, encoded.data());
+        codec::DecodeRgb565(reference_565.data(), width, height, decoded.data(), width * 3);
+        const bool exact = encoded == reference_565 && decoded == reference_rgb;
+        all_ok = all_ok && exact;
+        const double encode_ms = AverageMs(iterations, [&]() {
+            codec::EncodeRgb565(rgb.data(), width * 3, width, height, encoded.data());
+        });
+        const double decode_ms = AverageMs(iterations, [&]() {
+            codec::DecodeRgb565(reference_565.data(), width, height, decoded.data(), width * 3);
+        });
+        std::println("[Bench] {:<7} encode {:7.3f} ms  decode {:7.3f} ms  {}", codec::ActiveCodecIsaName(),
+                     encode_ms, decode_ms, exact ? "bit-exact" : "MISMATCH vs scalar");
+    }
+    codec::SetCodecIsa(codec::CodecIsa::Auto);
+
+    // 2. 完整预览链路：写端缩小 + 编码 + 发布到共享帧环，读端拷出 + 解码为 RGB24
+    std::vector<unsigned char> region(smile2unlock::SharedFrameMappingBytes());
+    auto* header = new (region.data()) smile2unlock::SharedFrameHeader{};
+    std::vector<std::uint8_t> scaled;
+    std::vector<unsigned char> payload;
+    std::vector<std::uint8_t> output;
+    double raw_ms = 0.0;
+    std::println("[Bench] {:<9} {:<6} {:>10} {:>11} {:>11} {:>7}", "downscale", "format", "bytes", "writer_ms", "reader_ms", "saving");
+    for (const int downscale : {1, 2, 4}) {
+        for (const bool rgb565 : {false, true}) {
+            const int w = width / downscale;
+            const int h = height / downscale;
+            smile2unlock::SharedFrameSlot info;
+            info.width = w;
+            info.height = h;
+            info.channels = 3;
+            info.compression = rgb565 ? smile2unlock::CompressionType::RGB565 : smile2unlock::CompressionType::NONE;
+            info.image_bytes = static_cast<std::uint32_t>(rgb565 ? codec::Rgb565Bytes(w, h) : static_cast<std::size_t>(w) * h * 3);
+            scaled.resize(static_cast<std::size_t>(w) * h * 3);
+            encoded.resize(codec::Rgb565Bytes(w, h));
+            output.resize(static_cast<std::size_t>(w) * h * 3);
+
+            const double writer_ms = AverageMs(iterations, [&]() {
+                const std::uint8_t* pixels = rgb.data();
+                if (downscale > 1) {
+                    DownscaleRgb24(rgb.data(), width * 3, width, height, scaled.data(), w * 3, w, h);
+                    pixels = scaled.data();
+                }
+                if (rgb565) {
+                    codec::EncodeRgb565(pixels, w * 3, w, h, encoded.data());
+                    pixels = encoded.data();
+                }
+                smile2unlock::PublishSharedFrame(header, info, pixels);
+            });
+            const double reader_ms = AverageMs(iterations, [&]() {
+                smile2unlock::SharedFrameSlot read;
+                if (smile2unlock::ReadLatestSharedFrame(header, 0, read, payload) != smile2unlock::SharedFrameRead::OK) {
+                    all_ok = false;
+                    return;
+                }
+                if (read.compression == smile2unlock::CompressionType::RGB565) {
+                    codec::DecodeRgb565(payload.data(), read.width, read.height, output.data(), read.width * 3);
+                } else {
+                    output.swap(payload);
+                }
+            });
+            if (downscale == 1 && !rgb565) raw_ms = writer_ms + reader_ms;
+            std::println("[Bench] {:<9} {:<6} {:>10} {:>11.3f} {:>11.3f} {:>6.1f}x",
+                         downscale, rgb565 ? "rgb565" : "rgb24", info.image_bytes, writer_ms, reader_ms,
+                         static_cast<double>(width) * height * 3 / info.image_bytes);
+        }
+    }
+    std::println("[Bench] raw rgb24 round trip {:.3f} ms/frame", raw_ms);
+    return all_ok ? 0 : 1;
+}
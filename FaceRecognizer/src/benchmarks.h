@@ -0,0 +1,126 @@
+#pragma once
+
+#include <string>
+
+#include "embedding_fusion.h"
+#include "face_quality.h"
+#include "motion_gate.h"
+
+// 离线基准测试（-m bench），使用回放帧源，不依赖摄像头
+
+/**
+ * @brief 采集/推理流水线基准：对比串行读取+推理、串行+ROI 跟踪与流水线模式的吞吐、丢帧与帧龄
+ *
+ * @param replay_dir 回放图像目录（PPM / BMP）
+ * @param fps 回放帧率，<= 0 表示不限速
+ * @param loops 回放循环次数
+ * @return int 0 表示成功
+ */
+int RunPipelineBenchmark(const std::string& replay_dir, double fps, int loops);
+
+/**
+ * @brief 帧缓冲分配基准：对比逐帧 new[] + 临时 ARGB 缓冲与帧池的分配次数和耗时
+ *
+ * @param frames 模拟帧数
+ * @param width 帧宽度
+ * @param height 帧高度
+ * @return int 0 表示成功
+ */
+int RunFramePoolBenchmark(int frames, int width, int height);
+
+/**
+ * @brief 像素转换基准：各指令集实现与标量实现逐位比对，并与 libyuv 两步转换比较耗时和误差；
+ *        同时校验并计时检测用的 RGB24 缩小内核
+ *
+ * @param iterations 每种实现的重复次数
+ * @param width 帧宽度
+ * @param height 帧高度
+ * @return int 0 表示所有实现与标量一致
+ */
+int RunPixelConvertBenchmark(int iterations, int width, int height);
+
+/**
+ * @brief 缩放检测基准：在图像目录上对比各检测缩放比例的检测耗时与召回
+ *
+ * 以 1.0 比例的检测结果为基准：召回为基准检出且在该比例下以 IoU >= 0.5 检出的比例；
+ * 同时报告基于原图关键点提取的特征与基准特征的相似度，衡量缩放对识别的影响。
+ *
+ * @param image_dir 测试图像目录（PPM / BMP）
+ * @param scales 逗号分隔的检测缩放比例，如 "1.0,0.75,0.5"
+ * @return int 0 表示成功
+ */
+int RunDetectScaleBenchmark(const std::string& image_dir, const std::string& scales);
+
+/**
+ * @brief 人脸质量基准：在图像目录上输出各图的质量指标与门限判定，
+ *        并对比 SIMD 与标量统计的耗时与一致性
+ *
+ * @param image_dir 测试图像目录（PPM / BMP）
+ * @param thresholds 质量门限（来自配置）
+ * @return int 0 表示 SIMD 与标量结果一致
+ */
+int RunQualityBenchmark(const std::string& image_dir, const QualityThresholds& thresholds);
+
+/**
+ * @brief 多帧融合基准：目录中首张图作为录入模板，其余按文件名顺序视为连续帧
+ *
+ * 从每一帧起各模拟一次识别会话，对比“首帧即上报”与多帧融合的通过率、
+ * 结束所需帧数与融合特征相似度，并给出无图库（收敛判定）时的结束帧数与单次融合耗时。
+ *
+ * @param image_dir 测试图像目录（PPM / BMP）
+ * @param options 融合参数（来自配置）
+ * @return int 0 表示成功
+ */
+int RunFusionBenchmark(const std::string& image_dir, const FusionOptions& options);
+
+/**
+ * @brief 回放摄像头基准：把图像目录预编码为各摄像头原始格式，经 CameraCapture 不限速采集，
+ *        报告每帧采集 + 转换耗时、帧率，以及转换回 RGB 后与原图的平均误差
+ *
+ * @param image_dir 测试图像目录（PPM / BMP）
+ * @param frames 每种格式采集的帧数
+ * @return int 0 表示所有格式均采集成功
+ */
+int RunCameraReplayBenchmark(const std::string& image_dir, int frames);
+
+/**
+ * @brief 特征比对基准：随机归一化特征上各指令集的分数矩阵与标量实现比较误差和吞吐
+ *
+ * @param gallery_size 图库（与探针）向量数
+ * @param dim 特征维度
+ * @return int 0 表示所有实现与标量的误差在 1e-4 以内
+ */
+int RunFeatureMathBenchmark(int gallery_size, int dim);
+
+/**
+ * @brief 运动门控基准：合成 640x480 带噪声的静止场景，后半段加入移动方块，
+ *        报告静止段跳过率、运动段放行率与单帧门控耗时，并校验 SIMD 与标量块差一致
+ *
+ * @param frames 每段模拟帧数
+ * @param options 门控参数（来自配置）
+ * @return int 0 表示 SIMD 与标量一致且静止段被跳过、运动段被放行
+ */
+int RunMotionGateBenchmark(int frames, const MotionGateOptions& options);
+
+/**
+ * @brief 共享帧环压力测试：一个写端线程不限速发布 640x480 帧，多个读端线程各自映射同一块具名共享内存
+ *        持续读取最新帧，逐帧校验内容是否撕裂；对比 v2 单缓冲区原地写入与 v3 多槽位 seqlock 环
+ *
+ * Windows 使用页面文件映射，其他平台使用 POSIX shm_open。
+ *
+ * @param frames 写端发布的帧数
+ * @param readers 读端线程数
+ * @return int 0 表示 v3 环没有读到撕裂或乱序的帧
+ */
+int RunSharedFrameRingBenchmark(int frames, int readers);
+
+/**
+ * @brief 预览编码基准：RGB565 编解码各指令集实现与标量逐位比对并报告往返误差，
+ *        再按缩小倍数 1 / 2 / 4 与 RGB24 / RGB565 组合测量写端（缩小 + 编码 + 发布）与读端（拷出 + 解码）耗时和每帧字节数
+ *
+ * @param iterations 每项测量的迭代次数
+ * @param width 源画面宽度
+ * @param height 源画面高度
+ * @return int 0 表示各实现逐位一致且往返误差不超过 7
+ */
+int RunPreviewCodecBenchmark(int iterations, int width, int height);
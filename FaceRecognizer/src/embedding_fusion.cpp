@@ -0,0 +1,193 @@
+// embedding_fusion.cpp
+// 多帧特征融合：质量加权平均 + 重新归一化，匹配领先量稳定后提前结束
+
+#include "embedding_fusion.h"
+
+import feature_math;
+import std;
+
+namespace {
+
+constexpr float kMinWeight = 1e-3f;
+// 清晰度半饱和点：拉普拉斯方差为该值时清晰度因子为 0.5
+constexpr float kSharpnessHalf = 50.0f;
+
+} // namespace
+
+float FusionWeight(float face_score, const FaceQuality* quality) {
+    float weight = std::clamp(face_score, 0.0f, 1.0f);
+    if (quality) {
+        const float sharpness = std::max(quality->sharpness, 0.0f);
+        weight *= sharpness / (sharpness + kSharpnessHalf);
+        weight *= std::clamp(1.0f - 2.0f * std::abs(quality->yaw), 0.0f, 1.0f);
+    }
+    return std::max(weight, kMinWeight);
+}
+
+EmbeddingFusion::EmbeddingFusion(const FusionOptions& options) : options_(options) {
+    options_.top_k = std::max(options_.top_k, 1);
+    options_.stable_frames = std::max(options_.stable_frames, 1);
+    options_.max_frames = std::max(options_.max_frames, 1);
+}
+
+void EmbeddingFusion::SetGallery(std::vector<GalleryEntry> gallery) {
+    gallery_.clear();
+    gallery_.reserve(gallery.size());
+    for (auto& entry : gallery) {
+        if (!smile2unlock::feature::Normalize(entry.feature.data(), entry.feature.size())) continue;
+        gallery_.push_back(std::move(entry));
+    }
+
+    gallery_matrix_.clear();
+    gallery_labels_.clear();
+    gallery_dim_ = gallery_.empty() ? 0 : static_cast<int>(gallery_.front().feature.size());
+    for (const auto& entry : gallery_) {
+        if (static_cast<int>(entry.feature.size()) != gallery_dim_) continue;
+        gallery_matrix_.insert(gallery_matrix_.end(), entry.feature.begin(), entry.feature.end());
+        gallery_labels_.push_back(entry.label);
+    }
+    Reset();
+}
+
+void EmbeddingFusion::Reset() {
+    samples_.clear();
+    fused_.clear();
+    previous_fused_.clear();
+    state_ = FusionState{};
+    dim_ = 0;
+}
+
+FusionState EmbeddingFusion::Add(const float* feature, int dim, float weight) {
+    if (!feature || dim <= 0 || (dim_ != 0 && dim != dim_)) return state_;
+
+    Sample sample;
+    sample.feature.assign(feature, feature + dim);
+    if (!smile2unlock::feature::Normalize(sample.feature.data(), sample.feature.size())) return state_;
+    sample.weight = std::max(weight, kMinWeight);
+    dim_ = dim;
+
+    // 只保留权重最高的 top_k 帧
+    if (static_cast<int>(samples_.size()) < options_.top_k) {
+        samples_.push_back(std::move(sample));
+    } else {
+        auto weakest = std::min_element(samples_.begin(), samples_.end(),
+                                        [](const Sample& a, const Sample& b) { return a.weight < b.weight; });
+        if (weakest->weight < sample.weight) *weakest = std::move(sample);
+    }
+
+    previous_fused_.swap(fused_);
+    RecomputeFused();
+    ++state_.frames;
+
+    bool stable = false;
+    state_.has_gallery = !gallery_labels_.empty() && dim_ == gallery_dim_;
+
+    if (state_.has_gallery) {
+        float best = 0.0f;
+        float second = 0.0f;
+        int64_t label = -1;
+        ScoreGallery(best, label, second);
+        const float margin = best - std::max(second, options_.match_threshold);
+        stable = label >= 0 && label == state_.best_label && margin >= options_.min_margin;
+        // 首帧没有可比较的上一帧，单独按领先量计入
+        if (state_.frames == 1) stable = label >= 0 && margin >= options_.min_margin;
+        state_.best_label = label;
+        state_.best_score = best;
+        state_.margin = margin;
+    } else if (!previous_fused_.empty()) {
+        state_.margin = smile2unlock::feature::Dot(fused_.data(), previous_fused_.data(), static_cast<size_t>(dim_));
+        stable = state_.margin >= options_.convergence;
+    }
+
+    state_.stable_count = stable ? state_.stable_count + 1 : 0;
+    if (state_.stable_count >= options_.stable_frames) {
+        state_.decision = FusionDecision::CONFIDENT;
+    } else if (state_.frames >= options_.max_frames) {
+        state_.decision = FusionDecision::EXHAUSTED;
+    } else {
+        state_.decision = FusionDecision::CONTINUE;
+    }
+    return state_;
+}
+
+void EmbeddingFusion::RecomputeFused() {
+    fused_.assign(dim_, 0.0f);
+    for (const auto& sample : samples_) {
+        for (int i = 0; i < dim_; ++i) fused_[i] += sample.weight * sample.feature[i];
+    }
+    // 加权和方向即加权平均方向，归一化后权重总和无需再除
+    if (!smile2unlock::feature::Normalize(fused_.data(), fused_.size())) fused_ = samples_.front().feature;
+}
+
+void EmbeddingFusion::ScoreGallery(float& best_score, int64_t& best_label, float& second_score) const {
+    best_score = -1.0f;
+    second_score = -1.0f;
+    best_label = -1;
+    if (gallery_labels_.empty() || dim_ != gallery_dim_) return;
+
+    // 与 MatchGallery 使用同一分数矩阵实现，融合特征与候选人脸的分数可直接比较
+    const size_t gallery_count = gallery_labels_.size();
+    std::vector<float> scores(gallery_count);
+    smile2unlock::feature::ScoreMatrix(fused_.data(), 1, gallery_matrix_.data(), gallery_count,
+                                       static_cast<size_t>(dim_), scores.data());
+
+    // 每个身份取其所有条目中的最高相似度
+    std::vector<std::pair<uint32_t, float>> per_label;
+    for (size_t g = 0; g < gallery_count; ++g) {
+        auto it = std::find_if(per_label.begin(), per_label.end(),
+                               [&](const auto& item) { return item.first == gallery_labels_[g]; });
+        if (it == per_label.end()) {
+            per_label.emplace_back(gallery_labels_[g], scores[g]);
+        } else {
+            it->second = std::max(it->second, scores[g]);
+        }
+    }
+
+    for (const auto& [label, score] : per_label) {
+        if (score > best_score) {
+            second_score = best_score;
+            best_score = score;
+            best_label = label;
+        } else if (score > second_score) {
+            second_score = score;
+        }
+    }
+}
+
+std::vector<GalleryMatch> EmbeddingFusion::MatchGallery(const std::vector<const float*>& probes, int dim) const {
+    std::vector<GalleryMatch> matches(probes.size());
+    if (probes.empty() || gallery_labels_.empty() || dim != gallery_dim_) return matches;
+
+    // 有效探针归一化后按行排列，与图库一次算出全部分数
+    const size_t n = static_cast<size_t>(dim);
+    std::vector<float> probe_matrix;
+    std::vector<size_t> probe_index;
+    probe_matrix.reserve(probes.size() * n);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        if (probes[i] == nullptr) continue;
+        const size_t offset = probe_matrix.size();
+        probe_matrix.insert(probe_matrix.end(), probes[i], probes[i] + n);
+        if (!smile2unlock::feature::Normalize(probe_matrix.data() + offset, n)) {
+            probe_matrix.resize(offset);
+            continue;
+        }
+        probe_index.push_back(i);
+    }
+    if (probe_index.empty()) return matches;
+
+    const size_t gallery_count = gallery_labels_.size();
+    std::vector<float> scores(probe_index.size() * gallery_count);
+    smile2unlock::feature::ScoreMatrix(probe_matrix.data(), probe_index.size(),
+                                       gallery_matrix_.data(), gallery_count, n, scores.data());
+    for (size_t p = 0; p < probe_index.size(); ++p) {
+        GalleryMatch& match = matches[probe_index[p]];
+        const float* row = scores.data() + p * gallery_count;
+        for (size_t g = 0; g < gallery_count; ++g) {
+            if (row[g] > match.score) {
+                match.score = row[g];
+                match.label = gallery_labels_[g];
+            }
+        }
+    }
+    return matches;
+}
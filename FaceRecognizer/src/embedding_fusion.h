@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "face_quality.h"
+
+/**
+ * @brief 多帧特征融合参数
+ */
+struct FusionOptions {
+    int top_k = 3;                  // 参与融合的最优帧数
+    int max_frames = 8;             // 最多累积的有效帧数，达到后直接输出当前融合结果
+    int stable_frames = 2;          // 连续多少帧判定稳定后提前结束
+    float min_margin = 0.05f;       // 有图库时：最佳得分领先（阈值与次佳身份中较高者）的最小差值
+    float match_threshold = 0.62f;  // 有图库时：识别阈值（与 SU 的 face_threshold 一致）
+    float convergence = 0.995f;     // 无图库时：相邻两次融合特征的余弦相似度下限
+};
+
+/**
+ * @brief 图库条目：label 相同的条目属于同一身份
+ */
+struct GalleryEntry {
+    uint32_t label = 0;
+    std::vector<float> feature;
+};
+
+enum class FusionDecision : uint8_t {
+    CONTINUE = 0,   // 继续累积
+    CONFIDENT,      // 结果已稳定，可以提前结束
+    EXHAUSTED,      // 达到 max_frames，输出当前融合结果
+};
+
+/**
+ * @brief 单次 Add 之后的融合状态
+ */
+struct FusionState {
+    FusionDecision decision = FusionDecision::CONTINUE;
+    int frames = 0;             // 已累积的有效帧数
+    int stable_count = 0;       // 当前连续稳定帧数
+    bool has_gallery = false;
+    int64_t best_label = -1;    // 有图库时的最佳身份，-1 表示无
+    float best_score = 0.0f;
+    float margin = 0.0f;        // 有图库时为得分领先量；无图库时为与上次融合特征的相似度
+};
+
+/**
+ * @brief 单个探针特征与图库的最佳匹配
+ */
+struct GalleryMatch {
+    int64_t label = -1;   // -1 表示探针无效或维度与图库不一致
+    float score = -1.0f;
+};
+
+/**
+ * @brief 根据检测得分与质量指标计算融合权重（0~1）
+ */
+float FusionWeight(float face_score, const FaceQuality* quality);
+
+/**
+ * @brief 多帧特征融合器
+ *
+ * 保留权重最高的 top_k 帧特征（均先归一化），融合结果为加权平均后重新归一化。
+ * 有图库时以最佳身份及其得分领先量连续稳定作为提前结束条件；无图库时以融合特征收敛为条件，
+ * 最终匹配仍由 SU 完成。
+ */
+class EmbeddingFusion {
+public:
+    explicit EmbeddingFusion(const FusionOptions& options = FusionOptions{});
+
+    // 设置图库（特征会被归一化）；维度不一致的条目在 Add 时忽略
+    void SetGallery(std::vector<GalleryEntry> gallery);
+    void Reset();
+
+    FusionState Add(const float* feature, int dim, float weight);
+
+    // 多个探针（如同一帧的多张候选人脸）一次与图库计算分数矩阵，返回每个探针的最佳身份；
+    // 不影响融合状态。空指针探针的结果为 label = -1
+    std::vector<GalleryMatch> MatchGallery(const std::vector<const float*>& probes, int dim) const;
+    bool has_gallery() const { return !gallery_.empty(); }
+
+    const FusionState& state() const { return state_; }
+    // 当前融合特征（单位向量），无有效帧时为空
+    const std::vector<float>& fused() const { return fused_; }
+
+private:
+    struct Sample {
+        std::vector<float> feature;
+        float weight = 0.0f;
+    };
+
+    void RecomputeFused();
+    void ScoreGallery(float& best_score, int64_t& best_label, float& second_score) const;
+
+    FusionOptions options_;
+    std::vector<GalleryEntry> gallery_;
+    std::vector<float> gallery_matrix_;   // 维度为 gallery_dim_ 的条目按行紧密排列，供 MatchGallery 使用
+    std::vector<uint32_t> gallery_labels_;
+    int gallery_dim_ = 0;
+    std::vector<Sample> samples_;
+    std::vector<float> fused_;
+    std::vector<float> previous_fused_;
+    FusionState state_;
+    int dim_ = 0;
+};
@@ -0,0 +1,132 @@
+// engine_pool.cpp
+// 多 seetaface 实例引擎池：并行加载，按 RAII 租约分发
+
+#include "engine_pool.h"
+
+import std;
+
+namespace {
+
+using PoolClock = std::chrono::steady_clock;
+
+} // namespace
+
+EngineLease::EngineLease(EngineLease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      engine_(std::exchange(other.engine_, nullptr)),
+      index_(other.index_) {}
+
+EngineLease& EngineLease::operator=(EngineLease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = std::exchange(other.pool_, nullptr);
+        engine_ = std::exchange(other.engine_, nullptr);
+        index_ = other.index_;
+    }
+    return *this;
+}
+
+EngineLease::~EngineLease() {
+    reset();
+}
+
+void EngineLease::reset() {
+    if (pool_ != nullptr && engine_ != nullptr) {
+        pool_->Release(index_);
+    }
+    pool_ = nullptr;
+    engine_ = nullptr;
+}
+
+int EnginePool::DefaultThreadsPerEngine(size_t pool_size) {
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<int>(std::max<size_t>(1, hardware / std::max<size_t>(1, pool_size)));
+}
+
+EnginePool::EnginePool(size_t size, const EngineOptions& options) {
+    size = std::max<size_t>(1, size);
+    threads_per_engine_ = options.threads > 0 ? options.threads : DefaultThreadsPerEngine(size);
+    detect_scale_ = options.detect_scale;
+    const auto start = PoolClock::now();
+
+    // 每个 seetaface 内部已并行加载三个模型；多个引擎再各占一个线程同时构造
+    std::vector<std::future<std::unique_ptr<seetaface>>> futures;
+    futures.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        futures.push_back(std::async(std::launch::async, [&options]() {
+            return std::make_unique<seetaface>(options.preload_liveness);
+        }));
+    }
+
+    // 必须等待所有引擎构造结束后再抛出，否则仍在加载的线程会访问已销毁的 options
+    std::exception_ptr load_error;
+    engines_.reserve(size);
+    for (auto& future : futures) {
+        try {
+            engines_.push_back(future.get());
+        } catch (...) {
+            if (!load_error) load_error = std::current_exception();
+        }
+    }
+    if (load_error) {
+        std::rethrow_exception(load_error);
+    }
+
+    for (size_t i = 0; i < engines_.size(); ++i) {
+        engines_[i]->set_detect_scale(options.detect_scale);
+        engines_[i]->set_num_threads(threads_per_engine_);
+        idle_.push_back(engines_.size() - 1 - i);
+    }
+    feature_size_ = engines_.front()->feature_size();
+    load_ms_ = std::chrono::duration<double, std::milli>(PoolClock::now() - start).count();
+    std::println("[EnginePool] 引擎 {} 个，每引擎推理线程 {}，加载耗时 {:.1f} ms",
+                 engines_.size(), threads_per_engine_, load_ms_);
+}
+
+EnginePool::~EnginePool() = default;
+
+EngineLease EnginePool::TakeLocked() {
+    const size_t index = idle_.back();
+    idle_.pop_back();
+    return EngineLease(this, engines_[index].get(), index);
+}
+
+EngineLease EnginePool::Acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_cv_.wait(lock, [this]() { return !idle_.empty(); });
+    return TakeLocked();
+}
+
+EngineLease EnginePool::TryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.empty()) return EngineLease();
+    return TakeLocked();
+}
+
+EngineLease EnginePool::AcquireFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!available_cv_.wait_for(lock, timeout, [this]() { return !idle_.empty(); })) {
+        return EngineLease();
+    }
+    return TakeLocked();
+}
+
+size_t EnginePool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+ModelLoadTimings EnginePool::load_timings(size_t index) const {
+    return engines_.at(index)->load_timings();
+}
+
+// 异常退出的会话也经租约析构归还，在此统一清除会话状态，而不是依赖调用方在正常路径上复位
+void EnginePool::Release(size_t index) {
+    engines_[index]->reset_session_state();
+    engines_[index]->set_detect_scale(detect_scale_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(index);
+    }
+    available_cv_.notify_one();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "seetaface.h"
+
+/**
+ * @brief 引擎池参数
+ */
+struct EngineOptions {
+    bool preload_liveness = false;  // 各引擎是否后台预加载活体模型
+    float detect_scale = 1.0f;
+    int threads = 0;                // 每个引擎的内部推理线程数，<= 0 时按 逻辑核数 / 引擎数 分配
+};
+
+class EnginePool;
+
+/**
+ * @brief 引擎租约：持有期间独占一个 seetaface 实例，析构时归还
+ *
+ * seetaface 持有的 SeetaFace 模型对象不能跨线程共享，同一时刻只能被一个租约使用。
+ * 跟踪、质量门限、活体会话等会话级设置在归还时（包括异常退出时的析构）恢复为默认值，
+ * 调用方在使用前按需设置即可。
+ */
+class EngineLease {
+public:
+    EngineLease() = default;
+    EngineLease(EngineLease&& other) noexcept;
+    EngineLease& operator=(EngineLease&& other) noexcept;
+    EngineLease(const EngineLease&) = delete;
+    EngineLease& operator=(const EngineLease&) = delete;
+    ~EngineLease();
+
+    explicit operator bool() const { return engine_ != nullptr; }
+    seetaface* get() const { return engine_; }
+    seetaface* operator->() const { return engine_; }
+    seetaface& operator*() const { return *engine_; }
+    size_t index() const { return index_; }
+
+    // 提前归还引擎
+    void reset();
+
+private:
+    friend class EnginePool;
+    EngineLease(EnginePool* pool, seetaface* engine, size_t index)
+        : pool_(pool), engine_(engine), index_(index) {}
+
+    EnginePool* pool_ = nullptr;
+    seetaface* engine_ = nullptr;
+    size_t index_ = 0;
+};
+
+/**
+ * @brief 多个独立 seetaface 实例组成的引擎池
+ *
+ * 构造时并行加载全部引擎，任一引擎加载失败时抛出其异常。Acquire / TryAcquire 返回 RAII 租约，
+ * 守护进程、批量录入等路径借此在多核上并行推理，而不必把所有推理串行到同一个实例上。
+ * 池必须比所有租约活得更久。
+ */
+class EnginePool {
+public:
+    EnginePool(size_t size, const EngineOptions& options);
+    ~EnginePool();
+
+    EnginePool(const EnginePool&) = delete;
+    EnginePool& operator=(const EnginePool&) = delete;
+
+    // 阻塞直到有空闲引擎
+    EngineLease Acquire();
+    // 无空闲引擎时返回空租约
+    EngineLease TryAcquire();
+    // 最多等待 timeout，超时返回空租约
+    EngineLease AcquireFor(std::chrono::milliseconds timeout);
+
+    size_t size() const { return engines_.size(); }
+    size_t available() const;
+    int feature_size() const { return feature_size_; }
+    int threads_per_engine() const { return threads_per_engine_; }
+    double load_ms() const { return load_ms_; }
+    ModelLoadTimings load_timings(size_t index) const;
+
+    // 按逻辑核数平均分配给每个引擎的推理线程数（至少为 1）
+    static int DefaultThreadsPerEngine(size_t pool_size);
+
+private:
+    friend class EngineLease;
+    EngineLease TakeLocked();
+    void Release(size_t index);
+
+    std::vector<std::unique_ptr<seetaface>> engines_;
+    std::vector<size_t> idle_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_cv_;
+    int feature_size_ = 0;
+    int threads_per_engine_ = 0;
+    float detect_scale_ = 1.0f;
+    double load_ms_ = 0.0;
+};
@@ -0,0 +1,288 @@
+// face_quality.cpp
+// 人脸质量评估：尺寸、亮度 / 对比度、清晰度（拉普拉斯方差）与偏航
+
+#include "face_quality.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FACE_QUALITY_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FACE_QUALITY_NEON 1
+#include <arm_neon.h>
+#endif
+
+import pixel_convert;
+import std;
+
+namespace {
+
+// 亮度平面统计的整数累加结果
+struct LumaSums {
+    std::uint64_t sum = 0;
+    std::uint64_t sum_sq = 0;
+    std::int64_t lap_sum = 0;
+    std::uint64_t lap_sum_sq = 0;
+};
+
+inline int LaplacianAt(const std::uint8_t* row, int x, std::ptrdiff_t stride) {
+    return 4 * row[x] - row[x - 1] - row[x + 1] - row[x - stride] - row[x + stride];
+}
+
+void AccumulateRowScalar(const std::uint8_t* row, int begin, int width, LumaSums& sums) {
+    for (int x = begin; x < width; ++x) {
+        sums.sum += row[x];
+        sums.sum_sq += static_cast<std::uint64_t>(row[x]) * row[x];
+    }
+}
+
+void AccumulateLaplacianScalar(const std::uint8_t* row, std::ptrdiff_t stride, int begin, int end, LumaSums& sums) {
+    for (int x = begin; x < end; ++x) {
+        const int lap = LaplacianAt(row, x, stride);
+        sums.lap_sum += lap;
+        sums.lap_sum_sq += static_cast<std::uint64_t>(lap * lap);
+    }
+}
+
+void ComputeSumsScalar(const std::uint8_t* luma, int width, int height, LumaSums& sums) {
+    for (int y = 0; y < height; ++y) {
+        const std::uint8_t* row = luma + static_cast<std::ptrdiff_t>(y) * width;
+        AccumulateRowScalar(row, 0, width, sums);
+        if (y > 0 && y + 1 < height) {
+            AccumulateLaplacianScalar(row, width, 1, width - 1, sums);
+        }
+    }
+}
+
+#if defined(FACE_QUALITY_SSE2)
+
+// 每行结果先在 32 位通道内累加，行末归约到 64 位（行宽不超过 kQualityCropSide，不会溢出）
+std::int64_t HorizontalSum32(__m128i v) {
+    alignas(16) std::int32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return static_cast<std::int64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+void ComputeSumsSimd(const std::uint8_t* luma, int width, int height, LumaSums& sums) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    for (int y = 0; y < height; ++y) {
+        const std::uint8_t* row = luma + static_cast<std::ptrdiff_t>(y) * width;
+
+        // 亮度和（sad 对 0 求和）与平方和（madd）
+        __m128i sum = zero;
+        __m128i sum_sq = zero;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(v, zero));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            sum_sq = _mm_add_epi32(sum_sq, _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+        }
+        sums.sum += static_cast<std::uint64_t>(_mm_cvtsi128_si32(sum)) +
+                    static_cast<std::uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+        sums.sum_sq += static_cast<std::uint64_t>(HorizontalSum32(sum_sq));
+        AccumulateRowScalar(row, x, width, sums);
+
+        if (y == 0 || y + 1 >= height) {
+            continue;
+        }
+
+        // 拉普拉斯 4c - l - r - u - d，范围 [-1020, 1020]，16 位足够
+        __m128i lap_sum = zero;
+        __m128i lap_sq = zero;
+        x = 1;
+        for (; x + 8 <= width - 1; x += 8) {
+            auto load8 = [zero](const std::uint8_t* p) {
+                return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), zero);
+            };
+            const __m128i c = load8(row + x);
+            const __m128i neighbors = _mm_add_epi16(
+                _mm_add_epi16(load8(row + x - 1), load8(row + x + 1)),
+                _mm_add_epi16(load8(row + x - width), load8(row + x + width)));
+            const __m128i lap = _mm_sub_epi16(_mm_slli_epi16(c, 2), neighbors);
+            lap_sum = _mm_add_epi32(lap_sum, _mm_madd_epi16(lap, ones));
+            lap_sq = _mm_add_epi32(lap_sq, _mm_madd_epi16(lap, lap));
+        }
+        sums.lap_sum += HorizontalSum32(lap_sum);
+        sums.lap_sum_sq += static_cast<std::uint64_t>(HorizontalSum32(lap_sq));
+        AccumulateLaplacianScalar(row, width, x, width - 1, sums);
+    }
+}
+
+#elif defined(FACE_QUALITY_NEON)
+
+void ComputeSumsSimd(const std::uint8_t* luma, int width, int height, LumaSums& sums) {
+    for (int y = 0; y < height; ++y) {
+        const std::uint8_t* row = luma + static_cast<std::ptrdiff_t>(y) * width;
+
+        uint32x4_t sum = vdupq_n_u32(0);
+        uint32x4_t sum_sq = vdupq_n_u32(0);
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16_t v = vld1q_u8(row + x);
+            sum = vpadalq_u16(sum, vpaddlq_u8(v));
+            const uint16x8_t sq_lo = vmull_u8(vget_low_u8(v), vget_low_u8(v));
+            const uint16x8_t sq_hi = vmull_u8(vget_high_u8(v), vget_high_u8(v));
+            sum_sq = vpadalq_u16(vpadalq_u16(sum_sq, sq_lo), sq_hi);
+        }
+        sums.sum += vaddvq_u32(sum);
+        sums.sum_sq += vaddlvq_u32(sum_sq);
+        AccumulateRowScalar(row, x, width, sums);
+
+        if (y == 0 || y + 1 >= height) {
+            continue;
+        }
+
+        int32x4_t lap_sum = vdupq_n_s32(0);
+        int32x4_t lap_sq = vdupq_n_s32(0);
+        x = 1;
+        for (; x + 8 <= width - 1; x += 8) {
+            auto load8 = [](const std::uint8_t* p) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p))); };
+            const int16x8_t neighbors = vaddq_s16(vaddq_s16(load8(row + x - 1), load8(row + x + 1)),
+                                                  vaddq_s16(load8(row + x - width), load8(row + x + width)));
+            const int16x8_t lap = vsubq_s16(vshlq_n_s16(load8(row + x), 2), neighbors);
+            lap_sum = vpadalq_s16(lap_sum, lap);
+            lap_sq = vmlal_s16(lap_sq, vget_low_s16(lap), vget_low_s16(lap));
+            lap_sq = vmlal_s16(lap_sq, vget_high_s16(lap), vget_high_s16(lap));
+        }
+        sums.lap_sum += vaddlvq_s32(lap_sum);
+        sums.lap_sum_sq += static_cast<std::uint64_t>(vaddlvq_s32(lap_sq));
+        AccumulateLaplacianScalar(row, width, x, width - 1, sums);
+    }
+}
+
+#else
+
+void ComputeSumsSimd(const std::uint8_t* luma, int width, int height, LumaSums& sums) {
+    ComputeSumsScalar(luma, width, height, sums);
+}
+
+#endif
+
+} // namespace
+
+const char* QualityIssueName(QualityIssue issue) {
+    switch (issue) {
+        case QualityIssue::NONE: return "ok";
+        case QualityIssue::TOO_SMALL: return "too_small";
+        case QualityIssue::TOO_DARK: return "too_dark";
+        case QualityIssue::TOO_BRIGHT: return "too_bright";
+        case QualityIssue::LOW_CONTRAST: return "low_contrast";
+        case QualityIssue::BLURRY: return "blurry";
+        case QualityIssue::POSE: return "pose";
+        default: return "unknown";
+    }
+}
+
+bool FaceQualityScorer::SizeAcceptable(const SeetaRect& face, const QualityThresholds& thresholds) {
+    return !thresholds.enabled || std::min(face.width, face.height) >= thresholds.min_face_size;
+}
+
+/**
+ * @brief 评估人脸质量
+ *
+ * 按 尺寸 -> 亮度 -> 对比度 -> 清晰度 -> 姿态 的顺序判定，issue 记录第一项不达标的指标；
+ * 所有指标都会计算，便于调试输出与阈值标定。
+ */
+FaceQuality FaceQualityScorer::Score(const SeetaImageData& image, const SeetaRect& face,
+                                     const SeetaPointF* points, int point_count,
+                                     const QualityThresholds& thresholds) {
+    return ScoreRegion(image, face, std::min(face.width, face.height), kQualityCropSide,
+                       points, point_count, thresholds);
+}
+
+/**
+ * @brief 在对齐人脸上评估质量，省去从整帧再次裁剪
+ *
+ * 统计区域为对齐图中央 3/4（去掉四角背景）；该区域先缩小到不超过原图人脸尺寸，
+ * 使清晰度与在原图上评估时处于同一尺度，门限无需重新标定。
+ */
+FaceQuality FaceQualityScorer::ScoreAligned(const AlignedFace& aligned,
+                                            const SeetaPointF* points, int point_count,
+                                            const QualityThresholds& thresholds) {
+    const SeetaImageData image = aligned.view();
+    const SeetaRect center{aligned.width / 8, aligned.height / 8, aligned.width * 3 / 4, aligned.height * 3 / 4};
+    return ScoreRegion(image, center, aligned.face_size, std::clamp(aligned.face_size, 3, kQualityCropSide),
+                       points, point_count, thresholds);
+}
+
+FaceQuality FaceQualityScorer::ScoreRegion(const SeetaImageData& image, const SeetaRect& face, int face_size,
+                                           int max_side, const SeetaPointF* points, int point_count,
+                                           const QualityThresholds& thresholds) {
+    FaceQuality quality;
+    quality.face_size = face_size;
+
+    const int x0 = std::clamp(face.x, 0, image.width);
+    const int y0 = std::clamp(face.y, 0, image.height);
+    const int x1 = std::clamp(face.x + face.width, 0, image.width);
+    const int y1 = std::clamp(face.y + face.height, 0, image.height);
+    const int crop_width = x1 - x0;
+    const int crop_height = y1 - y0;
+    if (image.data == nullptr || image.channels != 3 || crop_width < 3 || crop_height < 3) {
+        quality.issue = QualityIssue::TOO_SMALL;
+        return quality;
+    }
+
+    // 人脸区域缩小到不超过 max_side，再转亮度
+    const int frame_stride = image.width * 3;
+    const unsigned char* origin = image.data + static_cast<std::ptrdiff_t>(y0) * frame_stride + x0 * 3;
+    const int longest = std::max(crop_width, crop_height);
+    int width = crop_width;
+    int height = crop_height;
+    const unsigned char* rgb = origin;
+    int rgb_stride = frame_stride;
+    if (longest > max_side) {
+        width = std::max(3, crop_width * max_side / longest);
+        height = std::max(3, crop_height * max_side / longest);
+        crop_.resize(static_cast<std::size_t>(width) * height * 3);
+        DownscaleRgb24(origin, frame_stride, crop_width, crop_height, crop_.data(), width * 3, width, height);
+        rgb = crop_.data();
+        rgb_stride = width * 3;
+    }
+    luma_.resize(static_cast<std::size_t>(width) * height);
+    ConvertRgb24ToLuma(rgb, rgb_stride, luma_.data(), width, width, height);
+
+    LumaSums sums;
+    if (use_simd_) {
+        ComputeSumsSimd(luma_.data(), width, height, sums);
+    } else {
+        ComputeSumsScalar(luma_.data(), width, height, sums);
+    }
+
+    const double pixels = static_cast<double>(width) * height;
+    const double mean = sums.sum / pixels;
+    quality.brightness = static_cast<float>(mean);
+    quality.contrast = static_cast<float>(std::sqrt(std::max(0.0, sums.sum_sq / pixels - mean * mean)));
+    const double lap_pixels = static_cast<double>(width - 2) * (height - 2);
+    const double lap_mean = sums.lap_sum / lap_pixels;
+    quality.sharpness = static_cast<float>(std::max(0.0, sums.lap_sum_sq / lap_pixels - lap_mean * lap_mean));
+
+    bool pose_known = false;
+    if (points != nullptr && point_count >= 5) {
+        const double eye_distance = points[1].x - points[0].x;
+        if (std::abs(eye_distance) > 1.0) {
+            const double eye_center = (points[0].x + points[1].x) * 0.5;
+            quality.yaw = static_cast<float>((points[2].x - eye_center) / eye_distance);
+            pose_known = true;
+        }
+    }
+
+    if (!thresholds.enabled) {
+        return quality;
+    }
+    if (quality.face_size < thresholds.min_face_size) {
+        quality.issue = QualityIssue::TOO_SMALL;
+    } else if (quality.brightness < thresholds.min_brightness) {
+        quality.issue = QualityIssue::TOO_DARK;
+    } else if (quality.brightness > thresholds.max_brightness) {
+        quality.issue = QualityIssue::TOO_BRIGHT;
+    } else if (quality.contrast < thresholds.min_contrast) {
+        quality.issue = QualityIssue::LOW_CONTRAST;
+    } else if (quality.sharpness < thresholds.min_sharpness) {
+        quality.issue = QualityIssue::BLURRY;
+    } else if (pose_known && std::abs(quality.yaw) > thresholds.max_yaw) {
+        quality.issue = QualityIssue::POSE;
+    }
+    return quality;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <seeta/Common/CStruct.h>
+#include <cstdint>
+#include <vector>
+
+#include "aligned_face.h"
+
+/**
+ * @brief 人脸质量门限
+ *
+ * 只有全部指标达标的帧才会进入活体检测与特征提取。亮度 / 对比度 / 清晰度在缩放到
+ * 不超过 kQualityCropSide 的人脸亮度图上计算，与人脸在画面中的大小无关。
+ */
+struct QualityThresholds {
+    bool enabled = true;
+    int min_face_size = 64;         // 人脸框短边（原图像素）
+    float min_brightness = 40.0f;   // 亮度均值下限
+    float max_brightness = 220.0f;  // 亮度均值上限
+    float min_contrast = 15.0f;     // 亮度标准差下限
+    float min_sharpness = 25.0f;    // 拉普拉斯方差下限
+    float max_yaw = 0.35f;          // 偏航比例上限，见 FaceQuality::yaw
+};
+
+enum class QualityIssue : uint8_t {
+    NONE = 0,
+    TOO_SMALL,
+    TOO_DARK,
+    TOO_BRIGHT,
+    LOW_CONTRAST,
+    BLURRY,
+    POSE,
+    COUNT,
+};
+
+const char* QualityIssueName(QualityIssue issue);
+
+/**
+ * @brief 单个人脸的质量指标
+ */
+struct FaceQuality {
+    int face_size = 0;
+    float brightness = 0.0f;
+    float contrast = 0.0f;
+    float sharpness = 0.0f;
+    // 鼻尖相对双眼中点的水平偏移 / 眼距：正脸约为 0，侧转约 ±0.5
+    float yaw = 0.0f;
+    QualityIssue issue = QualityIssue::NONE;
+
+    bool passed() const { return issue == QualityIssue::NONE; }
+};
+
+/**
+ * @brief 人脸质量评估
+ *
+ * 裁剪人脸框（或取对齐人脸的中央区域）-> 缩小 -> 亮度图（pixel_convert 运行时分派的 SIMD 内核），
+ * 亮度统计与拉普拉斯方差使用基线指令集（x86 SSE2 / ARM NEON）单遍计算。
+ * 缓冲区随实例复用，非线程安全。
+ */
+class FaceQualityScorer {
+public:
+    static constexpr int kQualityCropSide = 128;
+
+    explicit FaceQualityScorer(bool use_simd = true) : use_simd_(use_simd) {}
+
+    // 仅检查人脸尺寸，可在关键点定位前调用以尽早丢弃远处人脸
+    static bool SizeAcceptable(const SeetaRect& face, const QualityThresholds& thresholds);
+
+    // points 为 5 点关键点（左眼、右眼、鼻尖、左嘴角、右嘴角），point_count 不足 5 时不评估姿态
+    FaceQuality Score(const SeetaImageData& image, const SeetaRect& face,
+                      const SeetaPointF* points, int point_count,
+                      const QualityThresholds& thresholds);
+
+    // 在已对齐的人脸上评估（aligned.face_size 为原图人脸尺寸），points 仍为原图坐标，仅用于姿态
+    FaceQuality ScoreAligned(const AlignedFace& aligned,
+                             const SeetaPointF* points, int point_count,
+                             const QualityThresholds& thresholds);
+
+private:
+    FaceQuality ScoreRegion(const SeetaImageData& image, const SeetaRect& face, int face_size, int max_side,
+                            const SeetaPointF* points, int point_count,
+                            const QualityThresholds& thresholds);
+
+
+    bool use_simd_ = true;
+    std::vector<unsigned char> crop_;
+    std::vector<unsigned char> luma_;
+};
@@ -0,0 +1,72 @@
+// face_ranking.cpp
+// 多人脸排序：按大小、检测得分与居中程度选出候选人脸
+
+#include "face_ranking.h"
+
+import std;
+
+namespace {
+
+// 选定人脸的加分，大于其余三项之和，保证其排在首位
+constexpr float kFocusBonus = 1.0f;
+
+} // namespace
+
+float RectIoU(const SeetaRect& a, const SeetaRect& b) {
+    const int x0 = std::max(a.x, b.x);
+    const int y0 = std::max(a.y, b.y);
+    const int x1 = std::min(a.x + a.width, b.x + b.width);
+    const int y1 = std::min(a.y + a.height, b.y + b.height);
+    if (x1 <= x0 || y1 <= y0) return 0.0f;
+    const double inter = static_cast<double>(x1 - x0) * (y1 - y0);
+    const double uni = static_cast<double>(a.width) * a.height + static_cast<double>(b.width) * b.height - inter;
+    return uni > 0.0 ? static_cast<float>(inter / uni) : 0.0f;
+}
+
+std::vector<RankedFace> RankFaces(const std::vector<SeetaFaceInfo>& faces,
+                                  int frame_width, int frame_height,
+                                  const FaceRankOptions& options,
+                                  const SeetaRect* focus) {
+    std::vector<RankedFace> ranked;
+    ranked.reserve(faces.size());
+
+    int largest_side = 1;
+    for (const auto& face : faces) {
+        largest_side = std::max(largest_side, std::min(face.pos.width, face.pos.height));
+    }
+    const double half_diagonal = 0.5 * std::hypot(static_cast<double>(frame_width), static_cast<double>(frame_height));
+
+    // 同一张人脸只认与 focus 重叠最多的那一个
+    int focus_index = -1;
+    float focus_iou = kSameFaceIoU;
+    for (size_t i = 0; focus != nullptr && i < faces.size(); ++i) {
+        const float iou = RectIoU(*focus, faces[i].pos);
+        if (iou >= focus_iou) {
+            focus_iou = iou;
+            focus_index = static_cast<int>(i);
+        }
+    }
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const SeetaRect& pos = faces[i].pos;
+        const float size = static_cast<float>(std::min(pos.width, pos.height)) / largest_side;
+        const double dx = pos.x + pos.width * 0.5 - frame_width * 0.5;
+        const double dy = pos.y + pos.height * 0.5 - frame_height * 0.5;
+        const float centrality = half_diagonal > 0.0
+            ? static_cast<float>(std::clamp(1.0 - std::hypot(dx, dy) / half_diagonal, 0.0, 1.0))
+            : 1.0f;
+
+        RankedFace face;
+        face.info = faces[i];
+        face.focused = static_cast<int>(i) == focus_index;
+        face.rank_score = options.size_weight * size +
+                          options.score_weight * std::clamp(static_cast<float>(faces[i].score), 0.0f, 1.0f) +
+                          options.center_weight * centrality +
+                          (face.focused ? kFocusBonus : 0.0f);
+        ranked.push_back(face);
+    }
+
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const RankedFace& a, const RankedFace& b) { return a.rank_score > b.rank_score; });
+    return ranked;
+}
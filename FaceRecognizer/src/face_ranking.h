@@ -0,0 +1,46 @@
+#pragma once
+
+#include <seeta/Common/CStruct.h>
+#include <vector>
+
+/**
+ * @brief 多人脸排序参数（来自 [core] max_faces）
+ *
+ * 排序分 = size_weight * 相对大小 + score_weight * 检测得分 + center_weight * 居中程度，
+ * 三项均归一化到 0~1。与 focus 人脸框重叠的人脸额外加 1，保证已选定的人脸在后续帧中保持首位。
+ */
+struct FaceRankOptions {
+    int max_faces = 1;            // 每帧做关键点与特征提取的人脸数（按排序取前 K 个）
+    float size_weight = 0.5f;
+    float score_weight = 0.3f;
+    float center_weight = 0.2f;
+};
+
+/**
+ * @brief 排序后的人脸
+ */
+struct RankedFace {
+    SeetaFaceInfo info{};
+    float rank_score = 0.0f;
+    bool focused = false;  // 与 focus 人脸框为同一张人脸
+};
+
+// 两个人脸框的交并比
+float RectIoU(const SeetaRect& a, const SeetaRect& b);
+
+// 低于该交并比视为不同的人脸（视频活体换脸判断、focus 匹配共用）
+constexpr float kSameFaceIoU = 0.3f;
+
+/**
+ * @brief 对检测结果排序，返回按排序分降序的全部人脸
+ *
+ * @param faces 检测结果（整帧坐标）
+ * @param frame_width 画面宽度，用于计算居中程度
+ * @param frame_height 画面高度
+ * @param options 排序权重
+ * @param focus 已选定的人脸框，为空表示没有
+ */
+std::vector<RankedFace> RankFaces(const std::vector<SeetaFaceInfo>& faces,
+                                  int frame_width, int frame_height,
+                                  const FaceRankOptions& options,
+                                  const SeetaRect* focus = nullptr);
@@ -0,0 +1,254 @@
+// feature_compare.cpp
+// 无模型特征比对：批量读取特征集，向量化余弦分数矩阵与阈值统计
+
+#include "feature_compare.h"
+#include "models/feature_batch_file.h"
+
+import feature_math;
+import std;
+
+namespace {
+
+using CompareClock = std::chrono::steady_clock;
+
+std::string Trim(std::string value) {
+    const auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
+    value.erase(value.begin(), std::find_if(value.begin(), value.end(), not_space));
+    value.erase(std::find_if(value.rbegin(), value.rend(), not_space).base(), value.end());
+    return value;
+}
+
+bool IsFeatureBatchFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return in && magic == smile2unlock::FeatureBatchFileHeader::MAGIC;
+}
+
+bool AppendFeature(FeatureSet& set, std::string label, std::string id, std::vector<float> feature,
+                   std::string& error_message) {
+    if (set.dim == 0) {
+        set.dim = static_cast<int>(feature.size());
+    } else if (static_cast<int>(feature.size()) != set.dim) {
+        error_message = std::format("特征维度不一致: {} (期望 {}，实际 {})", id, set.dim, feature.size());
+        return false;
+    }
+    if (!smile2unlock::feature::Normalize(feature.data(), feature.size())) {
+        error_message = "特征为零向量或包含无效数值: " + id;
+        return false;
+    }
+    set.labels.push_back(std::move(label));
+    set.ids.push_back(std::move(id));
+    set.features.insert(set.features.end(), feature.begin(), feature.end());
+    return true;
+}
+
+std::string CsvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (const char ch : text) {
+        if (ch == '"') quoted += '"';
+        quoted += ch;
+    }
+    return quoted + "\"";
+}
+
+bool WriteScoreCsv(const std::string& path, const FeatureSet& probes, const FeatureSet& gallery,
+                   const std::vector<float>& scores, std::string& error_message) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        error_message = "无法写入分数矩阵: " + path;
+        return false;
+    }
+    out << "probe";
+    for (const auto& id : gallery.ids) out << ',' << CsvField(id);
+    out << '\n';
+    for (size_t p = 0; p < probes.size(); ++p) {
+        out << CsvField(probes.ids[p]);
+        const float* row = scores.data() + p * gallery.size();
+        for (size_t g = 0; g < gallery.size(); ++g) {
+            out << std::format(",{:.6f}", row[g]);
+        }
+        out << '\n';
+    }
+    if (!out) {
+        error_message = "写入分数矩阵失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+// 错误接受率：异人分数 >= threshold 的比例；错误拒绝率：同人分数 < threshold 的比例（输入已升序）
+double FalseAcceptRate(const std::vector<float>& impostor, float threshold) {
+    if (impostor.empty()) return 0.0;
+    const auto it = std::lower_bound(impostor.begin(), impostor.end(), threshold);
+    return static_cast<double>(impostor.end() - it) / static_cast<double>(impostor.size());
+}
+
+double FalseRejectRate(const std::vector<float>& genuine, float threshold) {
+    if (genuine.empty()) return 0.0;
+    const auto it = std::lower_bound(genuine.begin(), genuine.end(), threshold);
+    return static_cast<double>(it - genuine.begin()) / static_cast<double>(genuine.size());
+}
+
+void PrintLabelStats(const FeatureSet& probes, const FeatureSet& gallery, const std::vector<float>& scores,
+                     bool same_set, float threshold) {
+    std::vector<float> genuine;
+    std::vector<float> impostor;
+    int rank1_hits = 0;
+    int rank1_total = 0;
+    for (size_t p = 0; p < probes.size(); ++p) {
+        const float* row = scores.data() + p * gallery.size();
+        float best = -2.0f;
+        const std::string* best_label = nullptr;
+        bool has_mate = false;
+        for (size_t g = 0; g < gallery.size(); ++g) {
+            if (same_set && g == p) continue;
+            const bool mate = probes.labels[p] == gallery.labels[g];
+            has_mate = has_mate || mate;
+            (mate ? genuine : impostor).push_back(row[g]);
+            if (row[g] > best) {
+                best = row[g];
+                best_label = &gallery.labels[g];
+            }
+        }
+        if (has_mate) {
+            ++rank1_total;
+            rank1_hits += (best_label != nullptr && *best_label == probes.labels[p]) ? 1 : 0;
+        }
+    }
+    if (genuine.empty() || impostor.empty()) {
+        std::println("[Compare] 同人 {} 对 / 异人 {} 对，不足以统计错误率", genuine.size(), impostor.size());
+        return;
+    }
+
+    std::sort(genuine.begin(), genuine.end());
+    std::sort(impostor.begin(), impostor.end());
+    const auto mean = [](const std::vector<float>& v) {
+        return std::accumulate(v.begin(), v.end(), 0.0) / static_cast<double>(v.size());
+    };
+    std::println("[Compare] genuine  pairs={} mean={:.4f} min={:.4f} max={:.4f}",
+                 genuine.size(), mean(genuine), genuine.front(), genuine.back());
+    std::println("[Compare] impostor pairs={} mean={:.4f} min={:.4f} max={:.4f}",
+                 impostor.size(), mean(impostor), impostor.front(), impostor.back());
+    std::println("[Compare] threshold={:.4f} FAR={:.4f}% FRR={:.4f}%",
+                 threshold, FalseAcceptRate(impostor, threshold) * 100.0, FalseRejectRate(genuine, threshold) * 100.0);
+
+    // 在所有出现过的分数上扫描，取 FAR 与 FRR 最接近的阈值作为 EER 近似
+    float eer_threshold = threshold;
+    double eer_gap = 2.0;
+    double eer = 0.0;
+    for (const auto* scores_side : {&genuine, &impostor}) {
+        for (const float candidate : *scores_side) {
+            const double far = FalseAcceptRate(impostor, candidate);
+            const double frr = FalseRejectRate(genuine, candidate);
+            if (std::abs(far - frr) < eer_gap) {
+                eer_gap = std::abs(far - frr);
+                eer = (far + frr) / 2.0;
+                eer_threshold = candidate;
+            }
+        }
+    }
+    std::println("[Compare] EER≈{:.4f}% @ threshold={:.4f}", eer * 100.0, eer_threshold);
+    if (rank1_total > 0) {
+        std::println("[Compare] rank-1 {}/{} ({:.2f}%)", rank1_hits, rank1_total, rank1_hits * 100.0 / rank1_total);
+    }
+}
+
+} // namespace
+
+bool LoadFeatureSet(const std::string& path, FeatureSet& set, std::string& error_message) {
+    set = FeatureSet{};
+    if (IsFeatureBatchFile(path)) {
+        uint32_t dim = 0;
+        std::vector<smile2unlock::FeatureBatchRecord> records;
+        if (!smile2unlock::ReadFeatureBatchFile(path, dim, records, error_message)) {
+            return false;
+        }
+        for (size_t i = 0; i < records.size(); ++i) {
+            auto& record = records[i];
+            std::string id = record.source.empty() ? std::format("#{}", i) : record.source;
+            if (!AppendFeature(set, std::move(record.username), std::move(id), std::move(record.feature), error_message)) {
+                return false;
+            }
+        }
+    } else {
+        std::ifstream in(path);
+        if (!in) {
+            error_message = "无法打开特征文件: " + path;
+            return false;
+        }
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line)) {
+            ++line_number;
+            line = Trim(line);
+            if (line.empty() || line.front() == '#') continue;
+            const size_t comma = line.find(',');
+            std::string label = comma == std::string::npos ? std::string() : Trim(line.substr(0, comma));
+            const std::string hex = comma == std::string::npos ? line : Trim(line.substr(comma + 1));
+            std::vector<float> feature;
+            if (!smile2unlock::feature::DecodeFeatureHex(hex, feature)) {
+                error_message = std::format("第 {} 行特征 hex 无效: {}", line_number, path);
+                return false;
+            }
+            if (!AppendFeature(set, std::move(label), std::format("{}:{}", path, line_number), std::move(feature),
+                               error_message)) {
+                return false;
+            }
+        }
+    }
+    if (set.size() == 0) {
+        error_message = "特征文件为空: " + path;
+        return false;
+    }
+    return true;
+}
+
+int RunCompareBatch(const CompareBatchOptions& options) {
+    if (options.probe.empty() || options.gallery.empty()) {
+        std::cerr << "[Compare] 需要通过 --probe 与 --gallery 指定特征文件" << std::endl;
+        return -1;
+    }
+
+    FeatureSet probes;
+    FeatureSet gallery;
+    std::string error;
+    if (!LoadFeatureSet(options.probe, probes, error) || !LoadFeatureSet(options.gallery, gallery, error)) {
+        std::cerr << "[Compare] " << error << std::endl;
+        return -1;
+    }
+    if (probes.dim != gallery.dim) {
+        std::cerr << "[Compare] 探针与图库特征维度不一致: " << probes.dim << " vs " << gallery.dim << std::endl;
+        return -1;
+    }
+
+    std::vector<float> scores(probes.size() * gallery.size());
+    const auto start = CompareClock::now();
+    smile2unlock::feature::ScoreMatrix(probes.features.data(), probes.size(),
+                                       gallery.features.data(), gallery.size(),
+                                       static_cast<size_t>(probes.dim), scores.data());
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(CompareClock::now() - start).count();
+    std::println("[Compare] probes={} gallery={} dim={} pairs={} elapsed={:.2f}ms ({:.1f}M pairs/s, {})",
+                 probes.size(), gallery.size(), probes.dim, scores.size(), elapsed_ms,
+                 elapsed_ms > 0.0 ? scores.size() / elapsed_ms / 1000.0 : 0.0,
+                 smile2unlock::feature::ActiveFeatureIsaName());
+
+    if (!options.output.empty()) {
+        if (!WriteScoreCsv(options.output, probes, gallery, scores, error)) {
+            std::cerr << "[Compare] " << error << std::endl;
+            return 1;
+        }
+        std::println("[Compare] 分数矩阵已写入 {}", options.output);
+    }
+
+    const auto labelled = [](const FeatureSet& set) {
+        return std::none_of(set.labels.begin(), set.labels.end(), [](const std::string& label) { return label.empty(); });
+    };
+    if (labelled(probes) && labelled(gallery)) {
+        std::error_code ec;
+        const bool same_set = std::filesystem::equivalent(options.probe, options.gallery, ec) && !ec;
+        PrintLabelStats(probes, gallery, scores, same_set, options.threshold);
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一组带标签的特征（compare-batch 的探针集或图库集）
+ *
+ * 读取自批量特征文件（common/models/feature_batch_file.h，标签为用户名），
+ * 或文本文件：每行 "标签,特征hex" 或仅 "特征hex"（标签为空），# 开头为注释。
+ * 读取后各行已 L2 归一化。
+ */
+struct FeatureSet {
+    int dim = 0;
+    std::vector<std::string> labels;
+    std::vector<std::string> ids;       // 输出中的行 / 列名：来源路径或行号
+    std::vector<float> features;        // labels.size() x dim，按行紧密排列
+
+    size_t size() const { return labels.size(); }
+};
+
+bool LoadFeatureSet(const std::string& path, FeatureSet& set, std::string& error_message);
+
+/**
+ * @brief 离线批量比对参数（-m compare-batch）
+ */
+struct CompareBatchOptions {
+    std::string probe;
+    std::string gallery;
+    std::string output;         // 分数矩阵 CSV，空表示不写出
+    float threshold = 0.62f;    // 统计 FAR / FRR 的阈值（face_threshold）
+};
+
+/**
+ * @brief 计算探针集与图库集的完整相似度矩阵，不加载任何模型
+ *
+ * 两侧都带标签时额外输出同人 / 异人分数分布、给定阈值下的 FAR / FRR、
+ * 近似等错误率（EER）阈值与 Rank-1 识别率；探针与图库为同一文件时跳过对角线。
+ *
+ * @return int 0 表示成功
+ */
+int RunCompareBatch(const CompareBatchOptions& options);
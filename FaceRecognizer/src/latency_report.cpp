@@ -0,0 +1,157 @@
+// latency_report.cpp
+// 端到端延迟测试的分阶段统计与报告输出
+
+#include "latency_report.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+import std;
+
+namespace {
+
+// 最近秩法：第 ceil(p * n) 个样本（从 1 开始计）
+double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string EscapeJson(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (const char ch : text) {
+        switch (ch) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    result += std::format("\\u{:04x}", static_cast<unsigned char>(ch));
+                } else {
+                    result += ch;
+                }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+const char* LatencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::CAPTURE: return "capture";
+        case LatencyStage::CONVERT: return "convert";
+        case LatencyStage::DETECT: return "detect";
+        case LatencyStage::LANDMARK: return "landmark";
+        case LatencyStage::ALIGN: return "align";
+        case LatencyStage::QUALITY: return "quality";
+        case LatencyStage::LIVENESS: return "liveness";
+        case LatencyStage::EXTRACT: return "extract";
+        case LatencyStage::ENCODE: return "encode";
+        case LatencyStage::SEND: return "send";
+        case LatencyStage::TOTAL: return "total";
+        case LatencyStage::COUNT: break;
+    }
+    return "unknown";
+}
+
+LatencyRecorder::LatencyRecorder(size_t expected_iterations) {
+    for (auto& samples : samples_) {
+        samples.reserve(expected_iterations);
+    }
+}
+
+void LatencyRecorder::Record(LatencyStage stage, double ms) {
+    if (stage == LatencyStage::COUNT) return;
+    samples_[static_cast<size_t>(stage)].push_back(ms);
+}
+
+LatencySummary LatencyRecorder::Summarize(LatencyStage stage) const {
+    LatencySummary summary;
+    if (stage == LatencyStage::COUNT) return summary;
+    std::vector<double> sorted = samples_[static_cast<size_t>(stage)];
+    if (sorted.empty()) return summary;
+    std::sort(sorted.begin(), sorted.end());
+    summary.count = sorted.size();
+    summary.mean_ms = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+    summary.p50_ms = Percentile(sorted, 0.50);
+    summary.p95_ms = Percentile(sorted, 0.95);
+    summary.p99_ms = Percentile(sorted, 0.99);
+    summary.max_ms = sorted.back();
+    return summary;
+}
+
+void LatencyRecorder::PrintText(const LatencyRunInfo& info) const {
+    std::println("[Test] source={} iterations={} faces={} features={} wall={:.1f}ms fps={:.2f} peak_rss={:.1f}MB",
+                 info.source, info.iterations, info.faces, info.features, info.wall_ms,
+                 info.wall_ms > 0.0 ? info.iterations * 1000.0 / info.wall_ms : 0.0,
+                 info.peak_rss_bytes / (1024.0 * 1024.0));
+    std::println("[Test] {:<9} {:>6} {:>9} {:>9} {:>9} {:>9} {:>9}", "stage", "count", "mean", "p50", "p95", "p99", "max");
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        const auto stage = static_cast<LatencyStage>(i);
+        const LatencySummary s = Summarize(stage);
+        std::println("[Test] {:<9} {:>6} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}",
+                     LatencyStageName(stage), s.count, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms);
+    }
+}
+
+bool LatencyRecorder::WriteJson(const std::string& path, const LatencyRunInfo& info, std::string& error_message) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        error_message = "无法写入报告文件: " + path;
+        return false;
+    }
+
+    out << "{\n";
+    out << std::format("  \"source\": \"{}\",\n", EscapeJson(info.source));
+    out << std::format("  \"iterations\": {},\n", info.iterations);
+    out << std::format("  \"faces\": {},\n", info.faces);
+    out << std::format("  \"features\": {},\n", info.features);
+    out << std::format("  \"wall_ms\": {:.3f},\n", info.wall_ms);
+    out << std::format("  \"fps\": {:.3f},\n", info.wall_ms > 0.0 ? info.iterations * 1000.0 / info.wall_ms : 0.0);
+    out << std::format("  \"peak_rss_bytes\": {},\n", info.peak_rss_bytes);
+    out << "  \"stages\": {\n";
+    for (size_t i = 0; i < samples_.size(); ++i) {
+        const auto stage = static_cast<LatencyStage>(i);
+        const LatencySummary s = Summarize(stage);
+        out << std::format("    \"{}\": {{\"count\": {}, \"mean_ms\": {:.4f}, \"p50_ms\": {:.4f}, \"p95_ms\": {:.4f}, "
+                           "\"p99_ms\": {:.4f}, \"max_ms\": {:.4f}}}{}\n",
+                           LatencyStageName(stage), s.count, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms,
+                           i + 1 < samples_.size() ? "," : "");
+    }
+    out << "  }\n";
+    out << "}\n";
+
+    if (!out) {
+        error_message = "写入报告文件失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+uint64_t PeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);          // macOS 以字节为单位
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024u;  // Linux 以 KB 为单位
+#endif
+    }
+    return 0;
+#endif
+}
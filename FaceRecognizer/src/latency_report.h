@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 端到端识别路径的计时阶段（-m test）
+ *
+ * CAPTURE 为取帧等待（不含转换），TOTAL 为单次迭代从取帧到发送的总耗时。
+ */
+enum class LatencyStage : uint8_t {
+    CAPTURE = 0,
+    CONVERT,
+    DETECT,
+    LANDMARK,
+    ALIGN,
+    QUALITY,
+    LIVENESS,
+    EXTRACT,
+    ENCODE,
+    SEND,
+    TOTAL,
+    COUNT,
+};
+
+const char* LatencyStageName(LatencyStage stage);
+
+/**
+ * @brief 单个阶段的分位数统计（毫秒），分位数按最近秩法计算
+ */
+struct LatencySummary {
+    size_t count = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief 一次测试运行的整体信息
+ */
+struct LatencyRunInfo {
+    int iterations = 0;
+    int faces = 0;              // 检出人脸的迭代数
+    int features = 0;           // 完成特征提取并发送的迭代数
+    double wall_ms = 0.0;
+    uint64_t peak_rss_bytes = 0;
+    std::string source;         // 帧源描述（回放路径或摄像头索引）
+};
+
+/**
+ * @brief 逐阶段收集耗时样本，输出文本与 JSON 报告
+ *
+ * 阶段只在实际执行时记录（如未检出人脸的迭代不记录关键点与提取），
+ * 各阶段的 count 因此可能小于迭代数。
+ */
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(size_t expected_iterations = 0);
+
+    void Record(LatencyStage stage, double ms);
+    LatencySummary Summarize(LatencyStage stage) const;
+
+    void PrintText(const LatencyRunInfo& info) const;
+    bool WriteJson(const std::string& path, const LatencyRunInfo& info, std::string& error_message) const;
+
+private:
+    std::array<std::vector<double>, static_cast<size_t>(LatencyStage::COUNT)> samples_;
+};
+
+/**
+ * @brief 当前进程的峰值常驻内存（字节），不可用时返回 0
+ */
+uint64_t PeakResidentBytes();
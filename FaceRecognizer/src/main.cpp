@@ -3,18 +3,35 @@
 
 #include "managers/ipc/udp/udp_sender.h"
 #include "models/shared_frame_ipc.h"
+#include "models/shared_feature_block.h"
+#include "models/shared_gallery_ipc.h"
+#include "utils/shared_region.h"
+#include "utils/frame_signal.h"
 #include "seetaface.h"
+#include "engine_pool.h"
+#include "embedding_fusion.h"
+#include "benchmarks.h"
+#include "batch_extract.h"
+#include "latency_report.h"
+#include "feature_compare.h"
+#include "recognition_scheduler.h"
+#include "motion_gate.h"
 #include "exceptions.h"
 #include "utils/logger.h"
 #include <cxxopts.hpp>
 #include "registryhelper.h"
 
 import camera;
+import frame_pool;
+import frame_pipeline;
 import app_paths;
 import utils;
 import config;
 import std;
 import crypto;
+import feature_math;
+import pixel_convert;
+import frame_codec;
 
 
 // 全局 UDP 发送器 - 使用 Boost.Asio 实现
@@ -43,246 +60,356 @@ std::string EncodeBytesToHex(const unsigned char* data, size_t size) {
     return result;
 }
 
-std::vector<unsigned char> DecodeHexToBytes(const std::string& hex) {
-    if (hex.size() % 2 != 0) {
-        throw std::runtime_error("Hex string length must be even");
-    }
-
-    auto hex_value = [](char ch) -> int {
-        if (ch >= '0' && ch <= '9') return ch - '0';
-        if (ch >= 'a' && ch <= 'f') return 10 + (ch - 'a');
-        if (ch >= 'A' && ch <= 'F') return 10 + (ch - 'A');
-        return -1;
-    };
-
-    std::vector<unsigned char> bytes;
-    bytes.reserve(hex.size() / 2);
-    for (size_t i = 0; i < hex.size(); i += 2) {
-        const int high = hex_value(hex[i]);
-        const int low = hex_value(hex[i + 1]);
-        if (high < 0 || low < 0) {
-            throw std::runtime_error("Invalid hex character");
-        }
-        bytes.push_back(static_cast<unsigned char>((high << 4) | low));
-    }
-    return bytes;
-}
-
 } // namespace
 
-int captureImageToSharedMemory(int camera_index, const std::string& map_name, bool extract_feature) {
+// warm_recognizer 非空时复用守护进程已加载的模型，否则按需临时加载
+int captureImageToSharedMemory(int camera_index, const std::string& map_name, bool extract_feature,
+                               seetaface* warm_recognizer = nullptr) {
     if (map_name.empty()) {
         std::cerr << "[Capture] 共享内存名称不能为空" << std::endl;
         return -1;
     }
 
-    const size_t mapping_size =
-        sizeof(smile2unlock::SharedFrameHeader) +
-        smile2unlock::SharedFrameHeader::MAX_IMAGE_BYTES +
-        smile2unlock::SharedFrameHeader::MAX_FEATURE_BYTES;
-    HANDLE mapping = nullptr;
-    for (int attempt = 0; attempt < 10 && mapping == nullptr; ++attempt) {
-        mapping = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, map_name.c_str());
-        if (mapping == nullptr) {
-            Sleep(50);
-        }
-    }
-    if (mapping == nullptr) {
+    // SU 先创建映射再启动本进程，这里短暂重试等待映射可见
+    smile2unlock::SharedRegion region = smile2unlock::SharedRegion::Open(
+        map_name, smile2unlock::SharedFrameMappingBytes(), smile2unlock::SharedRegionAccess::ReadWrite, 10);
+    if (!region) {
         std::cerr << "[Capture] 打开共享内存失败, map=" << map_name
-                  << ", GetLastError=" << GetLastError() << std::endl;
-        return -1;
-    }
-
-    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, mapping_size);
-    if (view == nullptr) {
-        CloseHandle(mapping);
-        std::cerr << "[Capture] 映射共享内存失败, GetLastError=" << GetLastError() << std::endl;
+                  << ", error=" << region.error() << std::endl;
         return -1;
     }
 
-    auto* header = static_cast<smile2unlock::SharedFrameHeader*>(view);
+    auto* header = region.as<smile2unlock::SharedFrameHeader>();
     *header = smile2unlock::SharedFrameHeader{};
 
     CameraCapture cam(camera_index);
     if (!cam.IsInitialized()) {
-        header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
-        UnmapViewOfFile(view);
-        CloseHandle(mapping);
+        smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
         throw FaceRecognition::CameraException("无法打开摄像头");
     }
 
-    SeetaImageData image{};
-    if (!cam.CaptureFrame(image) || image.data == nullptr || image.width <= 0 || image.height <= 0) {
-        header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
-        UnmapViewOfFile(view);
-        CloseHandle(mapping);
+    PooledFrame frame;
+    if (!cam.CaptureFrame(frame) || !frame.valid()) {
+        smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
         return -1;
     }
 
-    const uint32_t image_bytes = static_cast<uint32_t>(image.width * image.height * image.channels);
+    const SeetaImageData image = frame.view();
+    const uint32_t image_bytes = static_cast<uint32_t>(frame.bytes());
     if (image_bytes == 0 || image_bytes > smile2unlock::SharedFrameHeader::MAX_IMAGE_BYTES) {
-        delete[] image.data;
-        header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::INVALID_FRAME);
-        UnmapViewOfFile(view);
-        CloseHandle(mapping);
+        smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::INVALID_FRAME);
         return -1;
     }
 
-    header->width = image.width;
-    header->height = image.height;
-    header->channels = image.channels;
-    header->image_bytes = image_bytes;
-    header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::READY);
-
-    auto* bytes = reinterpret_cast<unsigned char*>(header + 1);
-    memcpy(bytes, image.data, image_bytes);
+    smile2unlock::SharedFrameSlot info;
+    info.width = image.width;
+    info.height = image.height;
+    info.channels = image.channels;
+    info.image_bytes = image_bytes;
+    smile2unlock::SharedFrameStatus status = smile2unlock::SharedFrameStatus::READY;
+    std::vector<unsigned char> feature_block;
 
     if (extract_feature) {
         try {
-            seetaface recognizer;
-            auto feature = recognizer.img2features(image);
+            std::unique_ptr<seetaface> owned_recognizer;
+            seetaface* recognizer = warm_recognizer;
+            if (recognizer == nullptr) {
+                owned_recognizer = std::make_unique<seetaface>(false);
+                recognizer = owned_recognizer.get();
+            }
+            auto feature = recognizer->img2features(image);
             if (!feature) {
-                header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::FEATURE_EXTRACTION_FAILED);
+                status = smile2unlock::SharedFrameStatus::FEATURE_EXTRACTION_FAILED;
             } else {
-                const int feature_size = recognizer.feature_size();
-                const auto* feature_bytes = reinterpret_cast<const unsigned char*>(feature.get());
-                const std::string feature_hex = EncodeBytesToHex(feature_bytes, static_cast<size_t>(feature_size) * sizeof(float));
-                if (feature_hex.size() > smile2unlock::SharedFrameHeader::MAX_FEATURE_BYTES) {
-                    header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::FEATURE_TOO_LARGE);
-                } else {
-                    header->feature_bytes = static_cast<uint32_t>(feature_hex.size());
-                    memcpy(bytes + image_bytes, feature_hex.data(), feature_hex.size());
+                // 二进制特征块直接写入共享内存，SU 按 float 视图读取，不再经过 hex 文本
+                const auto feature_size = static_cast<size_t>(recognizer->feature_size());
+                feature_block = smile2unlock::EncodeSharedFeatureBlock(std::span<const float>(feature.get(), feature_size));
+                if (feature_block.empty() ||
+                    feature_block.size() > smile2unlock::SharedFrameHeader::MAX_FEATURE_BYTES) {
+                    status = smile2unlock::SharedFrameStatus::FEATURE_TOO_LARGE;
+                    feature_block.clear();
                 }
             }
         } catch (const std::exception& e) {
             std::cerr << "[Capture] 特征提取失败: " << e.what() << std::endl;
-            header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::FEATURE_EXTRACTION_FAILED);
+            status = smile2unlock::SharedFrameStatus::FEATURE_EXTRACTION_FAILED;
         }
     }
 
-    delete[] image.data;
-    UnmapViewOfFile(view);
-    CloseHandle(mapping);
+    // 图像与特征一并发布，SU 读到的总是同一帧的完整数据
+    info.feature_bytes = static_cast<uint32_t>(feature_block.size());
+    smile2unlock::PublishSharedFrame(header, info, image.data, feature_block.data());
+    smile2unlock::SetSharedFrameStatus(header, status);
+
     return 0;
 }
 
-int streamPreviewToSharedMemory(int camera_index, const std::string& map_name) {
-    if (map_name.empty()) {
-        std::cerr << "[Preview] 共享内存名称不能为空" << std::endl;
-        return -1;
+// 按读端请求编码一帧预览：先按倍数缩小，再转 RGB565；不支持的请求原样输出。
+// 返回待发布的数据，scaled / encoded 为循环间复用的缓冲区
+const unsigned char* EncodePreviewFrame(const SeetaImageData& image, smile2unlock::SharedFrameEncoding encoding,
+                                        std::vector<unsigned char>& scaled, std::vector<unsigned char>& encoded,
+                                        smile2unlock::SharedFrameSlot& info) {
+    info.width = image.width;
+    info.height = image.height;
+    info.channels = image.channels;
+    info.image_bytes = static_cast<uint32_t>(static_cast<size_t>(image.width) * image.height * image.channels);
+    info.compression = smile2unlock::CompressionType::NONE;
+    if (image.channels != 3) {
+        return image.data;
     }
 
-    const size_t mapping_size =
-        sizeof(smile2unlock::SharedFrameHeader) +
-        smile2unlock::SharedFrameHeader::MAX_IMAGE_BYTES +
-        smile2unlock::SharedFrameHeader::MAX_FEATURE_BYTES;
-    HANDLE mapping = nullptr;
-    for (int attempt = 0; attempt < 10 && mapping == nullptr; ++attempt) {
-        mapping = OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, map_name.c_str());
-        if (mapping == nullptr) {
-            Sleep(50);
+    const unsigned char* pixels = image.data;
+    const int width = std::max(1, image.width / encoding.downscale);
+    const int height = std::max(1, image.height / encoding.downscale);
+    if (encoding.downscale > 1 && (width != image.width || height != image.height)) {
+        scaled.resize(static_cast<size_t>(width) * height * 3);
+        if (DownscaleRgb24(image.data, image.width * 3, image.width, image.height,
+                           scaled.data(), width * 3, width, height)) {
+            pixels = scaled.data();
+            info.width = width;
+            info.height = height;
+            info.image_bytes = static_cast<uint32_t>(scaled.size());
         }
     }
-    if (mapping == nullptr) {
-        std::cerr << "[Preview] 打开共享内存失败, map=" << map_name
-                  << ", GetLastError=" << GetLastError() << std::endl;
+
+    if (encoding.compression == smile2unlock::CompressionType::RGB565) {
+        encoded.resize(smile2unlock::codec::Rgb565Bytes(info.width, info.height));
+        if (smile2unlock::codec::EncodeRgb565(pixels, info.width * 3, info.width, info.height, encoded.data())) {
+            info.image_bytes = static_cast<uint32_t>(encoded.size());
+            info.compression = smile2unlock::CompressionType::RGB565;
+            return encoded.data();
+        }
+    }
+    return pixels;
+}
+
+int streamPreviewToSharedMemory(int camera_index, const std::string& map_name) {
+    if (map_name.empty()) {
+        std::cerr << "[Preview] 共享内存名称不能为空" << std::endl;
         return -1;
     }
 
-    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, mapping_size);
-    if (view == nullptr) {
-        CloseHandle(mapping);
-        std::cerr << "[Preview] 映射共享内存失败, GetLastError=" << GetLastError() << std::endl;
+    smile2unlock::SharedRegion region = smile2unlock::SharedRegion::Open(
+        map_name, smile2unlock::SharedFrameMappingBytes(), smile2unlock::SharedRegionAccess::ReadWrite, 10);
+    if (!region) {
+        std::cerr << "[Preview] 打开共享内存失败, map=" << map_name
+                  << ", error=" << region.error() << std::endl;
         return -1;
     }
 
-    auto* header = static_cast<smile2unlock::SharedFrameHeader*>(view);
+    auto* header = region.as<smile2unlock::SharedFrameHeader>();
+    // SU 在启动本进程前已写入编码请求，清零头部时保留
+    const smile2unlock::SharedFrameEncoding requested = smile2unlock::LoadRequestedSharedFrameEncoding(header);
     *header = smile2unlock::SharedFrameHeader{};
+    smile2unlock::RequestSharedFrameEncoding(header, requested);
+
+    // SU 创建的新帧通知；打开失败时 SU 退回轮询帧号，预览仍可用
+    const smile2unlock::FrameReadySignal frame_ready =
+        smile2unlock::FrameReadySignal::Open(map_name, &header->frame_sequence);
+    if (!frame_ready.valid()) {
+        std::cerr << "[Preview] 打开新帧通知失败, error=" << frame_ready.error() << std::endl;
+    }
 
     CameraCapture cam(camera_index);
     if (!cam.IsInitialized()) {
-        header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
-        UnmapViewOfFile(view);
-        CloseHandle(mapping);
+        smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
         throw FaceRecognition::CameraException("无法打开摄像头");
     }
 
-    auto* bytes = reinterpret_cast<unsigned char*>(header + 1);
-    while (header->stop_requested == 0) {
-        SeetaImageData image{};
-        if (!cam.CaptureFrame(image) || image.data == nullptr || image.width <= 0 || image.height <= 0) {
-            header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
+    // 预览帧在循环间复用同一块缓冲区；每帧写入环中空闲的槽位，SU 读取不会与写入交叠
+    PooledFrame frame;
+    std::vector<unsigned char> scaled;
+    std::vector<unsigned char> encoded;
+    while (!smile2unlock::SharedFrameStopRequested(header)) {
+        if (!cam.CaptureFrame(frame) || !frame.valid()) {
+            smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::CAPTURE_FAILED);
             std::this_thread::sleep_for(std::chrono::milliseconds(30));
             continue;
         }
 
-        const uint32_t image_bytes = static_cast<uint32_t>(image.width * image.height * image.channels);
+        const SeetaImageData image = frame.view();
+        const uint32_t image_bytes = static_cast<uint32_t>(frame.bytes());
         if (image_bytes == 0 || image_bytes > smile2unlock::SharedFrameHeader::MAX_IMAGE_BYTES) {
-            header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::INVALID_FRAME);
-            delete[] image.data;
+            smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::INVALID_FRAME);
             std::this_thread::sleep_for(std::chrono::milliseconds(30));
             continue;
         }
 
-        memcpy(bytes, image.data, image_bytes);
-        header->width = image.width;
-        header->height = image.height;
-        header->channels = image.channels;
-        header->image_bytes = image_bytes;
-        header->feature_bytes = 0;
-        header->status_code = static_cast<int32_t>(smile2unlock::SharedFrameStatus::READY);
-        ++header->frame_sequence;
-
-        delete[] image.data;
-        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        // 编码请求每帧重新读取，SU 可在预览过程中切换
+        smile2unlock::SharedFrameSlot info;
+        const unsigned char* payload = EncodePreviewFrame(
+            image, smile2unlock::LoadRequestedSharedFrameEncoding(header), scaled, encoded, info);
+        smile2unlock::PublishSharedFrame(header, info, payload);
+        smile2unlock::SetSharedFrameStatus(header, smile2unlock::SharedFrameStatus::READY);
+        frame_ready.Notify();
+        // 不再额外休眠：CaptureFrame 阻塞到摄像头（或回放）的下一帧，发布节奏即摄像头帧率
     }
 
-    UnmapViewOfFile(view);
-    CloseHandle(mapping);
     return 0;
 }
 
+// 比较两个 hex 特征串的余弦相似度（无需加载模型）；expected_dim > 0 时要求维度一致，
+// hex 无效、维度不匹配或特征为零向量时返回 false
+bool CompareFeatureHex(std::string_view feature_a_hex, std::string_view feature_b_hex,
+                       int expected_dim, float& similarity) {
+    std::vector<float> feature_a;
+    std::vector<float> feature_b;
+    if (!smile2unlock::feature::DecodeFeatureHex(feature_a_hex, feature_a) ||
+        !smile2unlock::feature::DecodeFeatureHex(feature_b_hex, feature_b) ||
+        feature_a.size() != feature_b.size()) {
+        return false;
+    }
+    if (expected_dim > 0 && feature_a.size() != static_cast<size_t>(expected_dim)) {
+        return false;
+    }
+    return smile2unlock::feature::CosineSimilarity(feature_a.data(), feature_b.data(), feature_a.size(), similarity);
+}
+
 int compareFeatures(const std::string& feature_a_hex, const std::string& feature_b_hex) {
     if (feature_a_hex.empty() || feature_b_hex.empty()) {
         std::cerr << "[Compare] 特征字符串不能为空" << std::endl;
         return -1;
     }
 
-    seetaface recognizer;
-    const int feature_size = recognizer.feature_size();
-    const size_t feature_bytes = static_cast<size_t>(feature_size) * sizeof(float);
-
-    auto bytes_a = DecodeHexToBytes(feature_a_hex);
-    auto bytes_b = DecodeHexToBytes(feature_b_hex);
-    if (bytes_a.size() != feature_bytes || bytes_b.size() != feature_bytes) {
-        std::cerr << "[Compare] 特征尺寸不匹配" << std::endl;
+    float similarity = 0.0f;
+    if (!CompareFeatureHex(feature_a_hex, feature_b_hex, 0, similarity)) {
+        std::cerr << "[Compare] 特征无效或尺寸不匹配" << std::endl;
         return -1;
     }
 
-    std::shared_ptr<float> feature_a(new float[feature_size], [](float* p) { delete[] p; });
-    std::shared_ptr<float> feature_b(new float[feature_size], [](float* p) { delete[] p; });
-    memcpy(feature_a.get(), bytes_a.data(), feature_bytes);
-    memcpy(feature_b.get(), bytes_b.data(), feature_bytes);
-
-    const float similarity = recognizer.feat_compare(feature_a, feature_b);
     std::cout << similarity << std::endl;
     return 0;
 }
 
+// [core] quality_* 键 -> 质量门限
+QualityThresholds QualityThresholdsFromConfig(const ConfigManager::CoreConfig& config) {
+    QualityThresholds thresholds;
+    thresholds.enabled = config.quality_gate;
+    thresholds.min_face_size = config.quality_min_face_size;
+    thresholds.min_brightness = config.quality_min_brightness;
+    thresholds.max_brightness = config.quality_max_brightness;
+    thresholds.min_contrast = config.quality_min_contrast;
+    thresholds.min_sharpness = config.quality_min_sharpness;
+    thresholds.max_yaw = config.quality_max_yaw;
+    return thresholds;
+}
+
+// [core] fusion_* 键 -> 多帧融合参数
+FusionOptions FusionOptionsFromConfig(const ConfigManager::CoreConfig& config) {
+    FusionOptions fusion;
+    fusion.top_k = config.fusion_frames;
+    // fusion_frames=1 时退化为首帧即上报
+    fusion.max_frames = config.fusion_frames == 1 ? 1 : std::max(config.fusion_max_frames, config.fusion_frames);
+    fusion.min_margin = config.fusion_min_margin;
+    fusion.match_threshold = config.face_threshold;
+    return fusion;
+}
+
+/**
+ * @brief 一次识别会话的参数
+ */
+struct RecognizeOptions {
+    int camera_index = 0;
+    bool liveness_detection = true;
+    float liveness_threshold = 0.8f;
+    bool debug = false;
+    float detect_scale = 1.0f;
+    QualityThresholds quality_gate;
+    FusionOptions fusion;
+    SchedulerOptions schedule;
+    LivenessSessionOptions liveness_session;
+    MotionGateOptions motion_gate;
+    FaceRankOptions ranking;
+    std::vector<GalleryEntry> gallery;  // 为空时以融合特征收敛作为提前结束条件
+};
+
+RecognizeOptions RecognizeOptionsFromConfig(const ConfigManager::CoreConfig& config, float liveness_threshold) {
+    RecognizeOptions options;
+    options.camera_index = config.camera;
+    options.liveness_detection = config.liveness;
+    options.liveness_threshold = liveness_threshold;
+    options.debug = config.debug;
+    options.detect_scale = config.detect_scale;
+    options.quality_gate = QualityThresholdsFromConfig(config);
+    options.fusion = FusionOptionsFromConfig(config);
+    options.schedule.session_timeout_ms = config.session_timeout_ms;
+    options.schedule.verify_budget_ms = config.verify_budget_ms;
+    options.schedule.idle_interval_ms = config.idle_interval_ms;
+    options.liveness_session.enabled = config.liveness_video_frames > 0;
+    options.liveness_session.video_frames = std::max(1, config.liveness_video_frames);
+    options.liveness_session.frame_budget = config.liveness_frame_budget;
+    options.motion_gate.enabled = config.motion_gate;
+    options.motion_gate.block_threshold = config.motion_threshold;
+    options.motion_gate.force_interval_ms = config.motion_force_interval_ms;
+    options.ranking.max_faces = config.max_faces;
+    return options;
+}
+
+// 读取 SU 写入的识别图库（只读映射，拷贝后立即释放）
+bool LoadSharedGallery(const std::string& map_name, std::vector<GalleryEntry>& gallery, float& match_threshold) {
+    gallery.clear();
+    const smile2unlock::SharedRegion region = smile2unlock::SharedRegion::Open(
+        map_name, sizeof(smile2unlock::SharedGalleryHeader), smile2unlock::SharedRegionAccess::ReadOnly);
+    if (!region) {
+        std::cerr << "[Recognize] 打开图库共享内存失败: " << map_name << ", error=" << region.error() << std::endl;
+        return false;
+    }
+
+    const size_t view_size = region.size();
+    const auto* header = region.as<const smile2unlock::SharedGalleryHeader>();
+    const bool valid = header->magic == smile2unlock::SharedGalleryHeader::MAGIC &&
+        header->version == smile2unlock::SharedGalleryHeader::VERSION &&
+        header->entry_count <= smile2unlock::SharedGalleryHeader::MAX_ENTRIES &&
+        header->dim > 0 && header->dim <= smile2unlock::SharedGalleryHeader::MAX_DIM &&
+        smile2unlock::SharedGalleryBytes(header->entry_count, header->dim) <= view_size;
+    if (valid) {
+        match_threshold = header->match_threshold;
+        const auto* cursor = reinterpret_cast<const unsigned char*>(header + 1);
+        gallery.resize(header->entry_count);
+        for (auto& entry : gallery) {
+            std::memcpy(&entry.label, cursor, sizeof(entry.label));
+            entry.feature.resize(header->dim);
+            std::memcpy(entry.feature.data(), cursor + sizeof(entry.label), header->dim * sizeof(float));
+            cursor += smile2unlock::SharedGalleryEntryBytes(header->dim);
+        }
+    }
+    return valid;
+}
+
 // 人脸识别函数
-int recognizeFace(int camera_index, bool liveness_detection,
-                  float liveness_threshold, bool debug) {
+// 多帧特征融合后发送 SUCCESS；warm_recognizer 非空时复用调用方（守护进程）已加载的模型；stop_flag 用于外部取消
+int recognizeFace(const RecognizeOptions& options,
+                  seetaface* warm_recognizer = nullptr,
+                  const std::atomic<bool>* stop_flag = nullptr,
+                  uint32_t session_id = 0) {
+    const int camera_index = options.camera_index;
+    const bool liveness_detection = options.liveness_detection;
+    const float liveness_threshold = options.liveness_threshold;
+    const bool debug = options.debug;
+    const float detect_scale = options.detect_scale;
+    const QualityThresholds& quality_gate = options.quality_gate;
     
     std::cout << "[Recognize] 启动人脸识别模式" << std::endl;
     std::cout << "[Recognize] 参数: camera=" << camera_index
               << ", liveness=" << (liveness_detection ? 1 : 0)
               << ", liveness_threshold=" << liveness_threshold
               << ", debug=" << (debug ? 1 : 0)
+              << ", detect_scale=" << detect_scale
+              << ", quality_gate=" << (quality_gate.enabled ? 1 : 0)
+              << ", fusion_frames=" << options.fusion.top_k
+              << ", gallery=" << options.gallery.size()
+              << ", session_timeout_ms=" << options.schedule.session_timeout_ms
+              << ", verify_budget_ms=" << options.schedule.verify_budget_ms
+              << ", idle_interval_ms=" << options.schedule.idle_interval_ms
+              << ", liveness_video_frames=" << (options.liveness_session.enabled ? options.liveness_session.video_frames : 0)
+              << ", motion_gate=" << (options.motion_gate.enabled ? 1 : 0)
+              << ", max_faces=" << options.ranking.max_faces
               << std::endl;
 
     // 识别结果标志
     bool recognition_success = false;
     bool stop_requested = false;
+    bool liveness_unavailable = false;
     
     // 初始化UDP发送器
     if (!g_udp_sender) {
@@ -291,115 +418,821 @@ int recognizeFace(int camera_index, bool liveness_detection,
     
     // 发送 RECOGNIZING 状态
     if (g_udp_sender) {
-        g_udp_sender->send_status(RecognitionStatus::RECOGNIZING, "");
+        g_udp_sender->send_status(RecognitionStatus::RECOGNIZING, "", session_id);
     }
     
     std::cout << "[Recognize] [1/3] 初始化摄像头..." << std::endl;
-    CameraCapture cam(camera_index);
+    auto cam = std::make_unique<CameraCapture>(camera_index);
     
     // 检查摄像头是否打开
-    if (!cam.IsInitialized()) {
+    if (!cam->IsInitialized()) {
         throw FaceRecognition::CameraException("无法打开摄像头");
     }
     std::cout << "[Recognize] [1/3] 摄像头初始化完成" << std::endl;
     
-    std::cout << "[Recognize] [2/3] 加载人脸识别模型（耗时较长，请稍候）..." << std::endl;
-    seetaface recognizer;
-    std::cout << "[Recognize] [2/3] 模型加载完成" << std::endl;
-        
-    int used_time = 0;
+    std::unique_ptr<seetaface> owned_recognizer;
+    seetaface* recognizer = warm_recognizer;
+    if (recognizer == nullptr) {
+        std::cout << "[Recognize] [2/3] 加载人脸识别模型（耗时较长，请稍候）..." << std::endl;
+        owned_recognizer = std::make_unique<seetaface>(liveness_detection);
+        recognizer = owned_recognizer.get();
+        std::cout << "[Recognize] [2/3] 模型加载完成" << std::endl;
+    } else {
+        std::cout << "[Recognize] [2/3] 复用已加载的模型" << std::endl;
+    }
         
+    const AnalysisFlags analysis_flags = (liveness_detection
+        ? AnalysisFlags::ALL
+        : AnalysisFlags::FEATURES) | AnalysisFlags::QUALITY_GATE;
+    StageTimings timing_totals;
+    int analyzed_frames = 0;
+
+    recognizer->set_detect_scale(detect_scale);
+    recognizer->set_quality_gate(quality_gate);
+    recognizer->set_face_ranking(options.ranking);
+    std::array<int, static_cast<size_t>(QualityIssue::COUNT)> quality_rejects{};
+
+    // 多帧融合：每帧特征按质量加权累积，结果稳定（或达到帧数上限）后才上报
+    EmbeddingFusion fusion(options.fusion);
+    fusion.SetGallery(options.gallery);
+    auto send_fused_feature = [&]() {
+        const auto& fused = fusion.fused();
+        const FusionState& state = fusion.state();
+        const std::string feature_hex = EncodeBytesToHex(
+            reinterpret_cast<const unsigned char*>(fused.data()), fused.size() * sizeof(float));
+        if (feature_hex.empty()) {
+            std::cerr << "[Recognize] 融合特征为空，放弃本次结果" << std::endl;
+            return false;
+        }
+        std::println("[Recognize] 融合完成: frames={} decision={} best={:.3f} margin={:.3f}",
+                     state.frames,
+                     state.decision == FusionDecision::CONFIDENT ? "confident"
+                         : state.decision == FusionDecision::EXHAUSTED ? "exhausted" : "timeout",
+                     state.best_score, state.margin);
+        // 识别结果交由 Smile2Unlock 编排层处理
+        if (g_udp_sender) {
+            g_udp_sender->send_status(RecognitionStatus::SUCCESS, "", session_id, feature_hex);
+        }
+        return true;
+    };
+
+    // 登录时人脸几乎不动：命中后只在上一帧人脸附近检测，定期整帧刷新
+    TrackingOptions tracking;
+    tracking.enabled = true;
+    recognizer->set_tracking(tracking);
+    // 视频模式活体：同一人脸的连续帧累积判定，结论定下后不再重复推理
+    recognizer->set_liveness_session(options.liveness_session);
+    recognizer->reset_aligned_cache();
+
+    // 视频活体结论未定时提取的特征先暂存，结论为 REAL 才计入融合，SPOOF 或换脸时丢弃
+    struct PendingSample {
+        std::shared_ptr<float> feature;
+        float weight = 0.0f;
+    };
+    std::vector<PendingSample> pending_samples;
+    int multi_face_frames = 0;  // 有多张候选人脸参与图库比对的帧数
+    int face_switches = 0;      // 因候选人脸匹配图库而切换跟踪对象的次数
+
+    // 采集线程持续取帧，推理始终处理最新一帧，摄像头 I/O 与推理重叠
+    FramePipeline pipeline(std::make_unique<CameraFrameSource>(std::move(cam)));
+    pipeline.Start();
+
+    // 运动门控：无人脸时画面与上次检测的帧相比未变化则跳过检测，定期强制检测一次
+    MotionGate motion_gate(options.motion_gate);
+
+    // 会话按墙钟截止时间结束（模型加载之后开始计时），与是否持续取到帧无关
+    RecognitionScheduler scheduler(options.schedule);
+    DeadlineReason deadline = DeadlineReason::NONE;
+    auto report_progress = [&](RecognitionScheduler::Clock::time_point now) {
+        const SchedulerSnapshot snapshot = scheduler.Snapshot(now);
+        if (debug) {
+            std::println("[Recognize] 调度: phase={} elapsed={}/{}ms phase_elapsed={}/{}ms frames={} idle_frames={} inference={}ms",
+                         SessionPhaseName(snapshot.phase), snapshot.elapsed_ms, snapshot.session_budget_ms,
+                         snapshot.phase_elapsed_ms, snapshot.phase_budget_ms,
+                         snapshot.frames, snapshot.idle_frames, snapshot.inference_ms);
+        }
+        if (g_udp_sender) {
+            UdpStatusBudget budget{};
+            budget.elapsed_ms = snapshot.elapsed_ms;
+            budget.session_budget_ms = snapshot.session_budget_ms;
+            budget.phase = static_cast<uint32_t>(snapshot.phase);
+            budget.phase_elapsed_ms = snapshot.phase_elapsed_ms;
+            budget.phase_budget_ms = snapshot.phase_budget_ms;
+            budget.frames = snapshot.frames;
+            budget.inference_ms = snapshot.inference_ms;
+            g_udp_sender->send_progress(session_id, budget);
+        }
+    };
+
     // 主识别循环
-    while (true) {
-        // 从摄像头捕获帧
-        SeetaImageData img_data = {};
-        if (cam.CaptureFrame(img_data)) {
-            // 检查识别成功或超时
-            if (recognition_success) {
-                delete[] img_data.data;
-                break;
+    while (!recognition_success) {
+        if (stop_flag != nullptr && stop_flag->load()) {
+            stop_requested = true;
+            break;
+        }
+        const auto now = RecognitionScheduler::Clock::now();
+        deadline = scheduler.Expired(now);
+        if (deadline != DeadlineReason::NONE) {
+            break;
+        }
+        if (scheduler.TakeProgressReport(now)) {
+            report_progress(now);
+        }
+
+        // 无人脸降频：未到下一次推理时间时短暂等待，期间仍响应取消与截止时间
+        const auto next_inference = scheduler.NextInferenceAt();
+        if (now < next_inference) {
+            std::this_thread::sleep_for(std::min<RecognitionScheduler::Clock::duration>(
+                next_inference - now, std::chrono::milliseconds(10)));
+            continue;
+        }
+
+        FrameLease lease = pipeline.AcquireLatest(std::chrono::milliseconds(10));
+        if (!lease) {
+            continue;
+        }
+        const SeetaImageData img_data = lease.image();
+        if (!motion_gate.ShouldInfer(img_data, RecognitionScheduler::Clock::now())) {
+            scheduler.OnSkipped(RecognitionScheduler::Clock::now());
+            continue;
+        }
+            
+        // 单次检测 + 关键点，结果复用于活体检测与特征提取
+        const FrameAnalysis analysis = recognizer->analyze(img_data, analysis_flags, liveness_threshold);
+        const auto analyzed_at = RecognitionScheduler::Clock::now();
+        scheduler.OnFrame(analysis.face_found, analysis.timings.total_ms, analyzed_at);
+        motion_gate.OnInferred(analysis.face_found, analyzed_at);
+        ++analyzed_frames;
+        timing_totals.detect_ms += analysis.timings.detect_ms;
+        timing_totals.landmark_ms += analysis.timings.landmark_ms;
+        timing_totals.align_ms += analysis.timings.align_ms;
+        timing_totals.quality_ms += analysis.timings.quality_ms;
+        timing_totals.liveness_ms += analysis.timings.liveness_ms;
+        timing_totals.extract_ms += analysis.timings.extract_ms;
+        timing_totals.candidates_ms += analysis.timings.candidates_ms;
+        timing_totals.total_ms += analysis.timings.total_ms;
+        if (debug) {
+            const PipelineStats stats = pipeline.Stats();
+            std::println("[Recognize] 帧耗时(ms): detect{}={:.2f} landmark={:.2f} align={:.2f} liveness={:.2f} extract={:.2f} candidates={:.2f} total={:.2f} | faces={} queue={}/{} dropped={}",
+                         analysis.roi_detection ? "(roi)" : "", analysis.timings.detect_ms, analysis.timings.landmark_ms,
+                         analysis.timings.align_ms, analysis.timings.liveness_ms, analysis.timings.extract_ms,
+                         analysis.timings.candidates_ms, analysis.timings.total_ms, analysis.faces_detected,
+                         stats.depth, stats.capacity, stats.dropped);
+        }
+
+        if (!analysis.face_found) {
+            pending_samples.clear();
+            continue;
+        }
+
+        // 要求活体但活体模型不可用：不能退化为无防伪的比对，整个会话按错误结束
+        if (analysis.liveness_unavailable) {
+            std::cerr << "[Recognize] 活体模型不可用，拒绝识别" << std::endl;
+            liveness_unavailable = true;
+            break;
+        }
+
+        // 多人脸：首位与其余候选人脸的特征一次与图库比对；首位不在图库而某个候选在时，
+        // 改为跟踪该候选（下一帧起它排在首位并做活体），已累积的首位人脸特征作废
+        if (!analysis.candidates.empty() && fusion.has_gallery()) {
+            ++multi_face_frames;
+            std::vector<const float*> probes;
+            probes.reserve(analysis.candidates.size() + 1);
+            probes.push_back(analysis.features.get());
+            for (const auto& candidate : analysis.candidates) {
+                probes.push_back(candidate.features.get());
             }
-            if (used_time >= 10000) {  // 10秒超时
-                delete[] img_data.data;
-                break;
+            const std::vector<GalleryMatch> matches = fusion.MatchGallery(probes, recognizer->feature_size());
+            size_t best = 0;
+            for (size_t i = 1; i < matches.size(); ++i) {
+                if (matches[i].score > matches[best].score) best = i;
             }
-            
-            // 检测人脸
-            SeetaRect face_rect = recognizer.detect(img_data);
-            
-            if (face_rect.width > 0 && face_rect.height > 0) {
-                // 检测到人脸，提取特征
-                auto current_features = recognizer.img2features(img_data);
-                
-                if (current_features) {
-                    // 如果启用了活体检测，验证是否为真实人脸
-                    if (liveness_detection) {
-                        bool is_real = recognizer.anti_face(img_data, liveness_threshold);
-                        if (!is_real) {
-                            if (debug) {
-                                std::cout << "检测到非真实人脸，跳过识别" << std::endl;
-                            }
-                            delete[] img_data.data;
-                            continue;
-                        }
-                    }
-
-                    if (debug) {
-                        std::cout << "[Recognize] 检测到真人脸，识别结果交由 Smile2Unlock 编排层处理" << std::endl;
-                    }
-
-                    const int feature_size = recognizer.feature_size();
-                    const auto* feature_bytes = reinterpret_cast<const unsigned char*>(current_features.get());
-                    const std::string feature_hex = EncodeBytesToHex(
-                        feature_bytes,
-                        static_cast<size_t>(feature_size) * sizeof(float));
-                    if (feature_hex.empty()) {
-                        std::cerr << "[Recognize] 提取到的特征为空，放弃本次识别" << std::endl;
-                        delete[] img_data.data;
-                        continue;
-                    }
-
-                    recognition_success = true;
-
-                    if (g_udp_sender) {
-                        g_udp_sender->send_status(RecognitionStatus::SUCCESS, "", 0, feature_hex);
-                    }
-
-                    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            if (best > 0 && matches[best].label >= 0 &&
+                matches[best].score >= options.fusion.match_threshold &&
+                matches[0].score < options.fusion.match_threshold) {
+                const FaceCandidate& chosen = analysis.candidates[best - 1];
+                recognizer->focus_face(chosen.face);
+                pending_samples.clear();
+                fusion.Reset();
+                ++face_switches;
+                std::println("[Recognize] 切换到候选人脸 #{} ({}x{}): label={} score={:.3f}，首位 score={:.3f}",
+                             best, chosen.face.width, chosen.face.height,
+                             matches[best].label, matches[best].score, matches[0].score);
+                continue;
+            }
+        }
+
+        // 质量不达标的帧不做活体与特征提取，等待下一帧
+        if (analysis.quality_checked && !analysis.quality.passed()) {
+            ++quality_rejects[static_cast<size_t>(analysis.quality.issue)];
+            if (debug) {
+                std::println("[Recognize] 质量不达标({}): size={} brightness={:.1f} contrast={:.1f} sharpness={:.1f} yaw={:.2f}",
+                             QualityIssueName(analysis.quality.issue), analysis.quality.face_size,
+                             analysis.quality.brightness, analysis.quality.contrast,
+                             analysis.quality.sharpness, analysis.quality.yaw);
+            }
+            continue;
+        }
+
+        const float sample_weight = FusionWeight(analysis.face_score,
+                                                 analysis.quality_checked ? &analysis.quality : nullptr);
+
+        // 如果启用了活体检测，验证是否为真实人脸
+        if (liveness_detection && analysis.liveness_checked) {
+            // 换了一张人脸：上一张人脸暂存的特征不可信
+            if (analysis.liveness_inferred && analysis.liveness_frames == 1) {
+                pending_samples.clear();
+            }
+            if (analysis.liveness == LivenessDecision::PENDING) {
+                if (analysis.features) {
+                    pending_samples.push_back(PendingSample{analysis.features, sample_weight});
                 }
+                continue;
+            }
+            if (!analysis.is_real) {
+                pending_samples.clear();
+                if (debug) {
+                    std::cout << "检测到非真实人脸，跳过识别" << std::endl;
+                }
+                continue;
+            }
+            for (const auto& sample : pending_samples) {
+                fusion.Add(sample.feature.get(), recognizer->feature_size(), sample.weight);
+            }
+            pending_samples.clear();
+        }
+
+        if (analysis.features) {
+            const FusionState state = fusion.Add(analysis.features.get(), recognizer->feature_size(), sample_weight);
+            if (debug) {
+                std::println("[Recognize] 融合 frame={} label={} best={:.3f} margin={:.3f} stable={}",
+                             state.frames, state.best_label, state.best_score, state.margin, state.stable_count);
+            }
+            if (state.decision == FusionDecision::CONTINUE) {
+                continue;
+            }
+            if (send_fused_feature()) {
+                recognition_success = true;
+            } else {
+                fusion.Reset();
             }
-            
-            // 释放当前帧的内存
-            delete[] img_data.data;
-            
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            used_time += 10;
         }
     }
+
+    // 截止前已有融合结果时仍交由 SU 判定，避免整轮重试
+    if (!recognition_success && !stop_requested && !liveness_unavailable && fusion.state().frames > 0) {
+        recognition_success = send_fused_feature();
+    }
+
+    const SchedulerSnapshot schedule = scheduler.Snapshot(RecognitionScheduler::Clock::now());
+    std::println("[Recognize] 调度统计: deadline={} phase={} elapsed={}/{}ms phase_elapsed={}/{}ms frames={} idle_frames={} skipped_frames={} inference={}ms",
+                 DeadlineReasonName(deadline), SessionPhaseName(schedule.phase),
+                 schedule.elapsed_ms, schedule.session_budget_ms,
+                 schedule.phase_elapsed_ms, schedule.phase_budget_ms,
+                 schedule.frames, schedule.idle_frames, schedule.skipped_frames, schedule.inference_ms);
+    if (options.motion_gate.enabled) {
+        const MotionGateStats motion_stats = motion_gate.stats();
+        std::println("[Recognize] 运动门控: checked={} skipped={} changed={} forced={} avg={:.3f}ms",
+                     motion_stats.checked, motion_stats.skipped, motion_stats.changed, motion_stats.forced,
+                     motion_stats.checked > 0 ? motion_stats.gate_ms / motion_stats.checked : 0.0);
+    }
+
+    if (liveness_detection && options.liveness_session.enabled) {
+        const LivenessSessionStats liveness_stats = recognizer->liveness_session_stats();
+        std::println("[Recognize] 活体统计: sessions={} inferred={} skipped={} real={} spoof={} by_budget={} avg={:.2f}ms",
+                     liveness_stats.sessions, liveness_stats.inferred_frames, liveness_stats.skipped_frames,
+                     liveness_stats.real, liveness_stats.spoof, liveness_stats.budget_decisions,
+                     liveness_stats.inferred_frames > 0 ? liveness_stats.liveness_ms / liveness_stats.inferred_frames : 0.0);
+    }
+
+    const AlignedFaceCacheStats aligned_stats = recognizer->aligned_cache_stats();
+    std::println("[Recognize] 对齐缓存: crops={} reused={} allocations={}",
+                 aligned_stats.crops, aligned_stats.reused_buffers, aligned_stats.allocations);
+
+    const TrackingStats tracking_stats = recognizer->tracking_stats();
+    std::println("[Recognize] 跟踪统计: full={} roi={} roi_hit_rate={:.1f}% full_avg={:.2f}ms roi_avg={:.2f}ms saved_per_roi_frame={:.2f}ms",
+                 tracking_stats.full_detections, tracking_stats.roi_detections,
+                 tracking_stats.roi_hit_rate() * 100.0,
+                 tracking_stats.avg_full_ms(), tracking_stats.avg_roi_ms(),
+                 tracking_stats.roi_detections > 0 ? tracking_stats.avg_full_ms() - tracking_stats.avg_roi_ms() : 0.0);
+
+    pipeline.Stop();
+    const PipelineStats pipeline_stats = pipeline.Stats();
+    std::println("[Recognize] 流水线统计: captured={} consumed={} dropped={} capture_failures={} max_depth={}/{}",
+                 pipeline_stats.captured, pipeline_stats.consumed, pipeline_stats.dropped,
+                 pipeline_stats.capture_failures, pipeline_stats.max_depth, pipeline_stats.capacity);
+
+    if (analyzed_frames > 0) {
+        const double frames = static_cast<double>(analyzed_frames);
+        std::println("[Recognize] 平均帧耗时(ms, {} 帧): detect={:.2f} landmark={:.2f} align={:.2f} quality={:.2f} liveness={:.2f} extract={:.2f} total={:.2f}",
+                     analyzed_frames,
+                     timing_totals.detect_ms / frames, timing_totals.landmark_ms / frames,
+                     timing_totals.align_ms / frames, timing_totals.quality_ms / frames,
+                     timing_totals.liveness_ms / frames, timing_totals.extract_ms / frames,
+                     timing_totals.total_ms / frames);
+    }
+    if (options.ranking.max_faces > 1) {
+        std::println("[Recognize] 多人脸: max_faces={} multi_face_frames={} switches={} candidates_avg={:.2f}ms",
+                     options.ranking.max_faces, multi_face_frames, face_switches,
+                     analyzed_frames > 0 ? timing_totals.candidates_ms / analyzed_frames : 0.0);
+    }
+    if (quality_gate.enabled) {
+        std::string rejects;
+        for (size_t i = 1; i < quality_rejects.size(); ++i) {
+            if (quality_rejects[i] == 0) continue;
+            rejects += std::format(" {}={}", QualityIssueName(static_cast<QualityIssue>(i)), quality_rejects[i]);
+        }
+        std::println("[Recognize] 质量门限拒绝:{}", rejects.empty() ? " 无" : rejects);
+    }
     
     // 输出识别结果
     if (stop_requested) {
         std::cout << "识别结果：已取消" << std::endl;
+    } else if (liveness_unavailable) {
+        std::cout << "识别结果：错误（活体模型不可用）" << std::endl;
     } else {
         std::cout << "识别结果：" << (recognition_success ? "成功" : "超时/失败") << std::endl;
     }
 
-    if (!recognition_success && !stop_requested && g_udp_sender) {
-        g_udp_sender->send_status(RecognitionStatus::TIMEOUT, "");
+    if (liveness_unavailable && g_udp_sender) {
+        g_udp_sender->send_status(RecognitionStatus::RECOGNITION_ERROR, "", session_id);
+    } else if (!recognition_success && !stop_requested && g_udp_sender) {
+        g_udp_sender->send_status(RecognitionStatus::TIMEOUT, "", session_id);
     }
     
     std::cout << "人脸识别结束。" << (stop_requested ? " (cancelled)" : "") << std::endl;
-    return 0;
+    return liveness_unavailable ? -1 : 0;
+}
+
+/**
+ * @brief 端到端延迟测试（-m test）
+ *
+ * 在同一帧源上重复执行识别路径：取帧、转换、检测、关键点、质量、活体、特征提取、编码与发送。
+ * 为了逐段计时各阶段串行执行，不经过采集流水线；发送段对准本函数在环回临时端口上绑定的
+ * 接收端并随即排空，特征不会发往 Smile2Unlock / CP。前 kWarmupIterations 次迭代不计入统计。
+ */
+int runLatencyTest(const RecognizeOptions& options, int iterations, const std::string& report_path) {
+    constexpr int kWarmupIterations = 5;
+    constexpr int kMaxConsecutiveFailures = 100;
+    if (iterations <= 0) {
+        std::cerr << "[Test] 迭代次数必须为正数" << std::endl;
+        return -1;
+    }
+
+    const CameraReplayOptions& replay = CameraReplayConfig();
+    LatencyRunInfo info;
+    info.source = replay.enabled()
+        ? std::format("replay:{} ({})", replay.path, RawFrameFormatName(replay.format))
+        : std::format("camera:{}", options.camera_index);
+
+    CameraCapture cam(options.camera_index);
+    if (!cam.IsInitialized()) {
+        throw FaceRecognition::CameraException("无法打开摄像头");
+    }
+    seetaface recognizer(options.liveness_detection);
+    recognizer.set_detect_scale(options.detect_scale);
+    recognizer.set_quality_gate(options.quality_gate);
+    recognizer.set_face_ranking(options.ranking);
+    TrackingOptions tracking;
+    tracking.enabled = true;
+    recognizer.set_tracking(tracking);
+    recognizer.set_liveness_session(options.liveness_session);
+    std::println("[Test] 模型加载耗时 {:.1f}ms，预热 {} 次后计时 {} 次", recognizer.load_timings().total_ms,
+                 kWarmupIterations, iterations);
+
+    const AnalysisFlags analysis_flags = (options.liveness_detection
+        ? AnalysisFlags::ALL
+        : AnalysisFlags::FEATURES) | AnalysisFlags::QUALITY_GATE;
+    const int feature_bytes = recognizer.feature_size() * static_cast<int>(sizeof(float));
+    LatencyRecorder recorder(static_cast<size_t>(iterations));
+
+    // 发送计时的目标：自有的环回接收端，端口由系统分配，不复用 --udp-port
+    asio::io_context sink_context;
+    udp::socket sink(sink_context, udp::endpoint(asio::ip::address_v4::loopback(), 0));
+    sink.non_blocking(true);
+    UdpSender sink_sender("127.0.0.1", sink.local_endpoint().port());
+    UdpStatusPacket sink_packet{};
+
+    PooledFrame frame;
+    int failures = 0;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kWarmupIterations + iterations; ++i) {
+        if (i == kWarmupIterations) {
+            wall_start = std::chrono::steady_clock::now();
+        }
+        const bool measured = i >= kWarmupIterations;
+        const auto iteration_start = std::chrono::steady_clock::now();
+
+        if (!cam.CaptureFrame(frame) || !frame.valid()) {
+            if (++failures >= kMaxConsecutiveFailures) {
+                std::cerr << "[Test] 连续取帧失败，提前结束" << std::endl;
+                break;
+            }
+            --i;
+            continue;
+        }
+        failures = 0;
+        const double capture_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - iteration_start).count();
+
+        const FrameAnalysis analysis = recognizer.analyze(frame.view(), analysis_flags, options.liveness_threshold);
+        const bool accepted = analysis.features &&
+            (!analysis.quality_checked || analysis.quality.passed()) &&
+            (!analysis.liveness_checked || analysis.is_real);
+
+        double encode_ms = 0.0;
+        double send_ms = 0.0;
+        if (accepted) {
+            const auto encode_start = std::chrono::steady_clock::now();
+            const std::string feature_hex = EncodeBytesToHex(
+                reinterpret_cast<const unsigned char*>(analysis.features.get()), static_cast<size_t>(feature_bytes));
+            const auto send_start = std::chrono::steady_clock::now();
+            sink_sender.send_status(RecognitionStatus::RECOGNIZING, "", 0, feature_hex);
+            const auto send_end = std::chrono::steady_clock::now();
+            encode_ms = std::chrono::duration<double, std::milli>(send_start - encode_start).count();
+            send_ms = std::chrono::duration<double, std::milli>(send_end - send_start).count();
+
+            boost::system::error_code drain_error;
+            while (sink.available(drain_error) > 0 && !drain_error) {
+                sink.receive(asio::buffer(&sink_packet, sizeof(sink_packet)), 0, drain_error);
+            }
+        }
+        const double total_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - iteration_start).count();
+
+        if (!measured) {
+            continue;
+        }
+        ++info.iterations;
+        const double convert_ms = cam.LastConvertMs();
+        recorder.Record(LatencyStage::CAPTURE, std::max(0.0, capture_ms - convert_ms));
+        recorder.Record(LatencyStage::CONVERT, convert_ms);
+        recorder.Record(LatencyStage::DETECT, analysis.timings.detect_ms);
+        if (analysis.face_found) {
+            ++info.faces;
+            recorder.Record(LatencyStage::LANDMARK, analysis.timings.landmark_ms);
+        }
+        if (analysis.aligned) {
+            recorder.Record(LatencyStage::ALIGN, analysis.timings.align_ms);
+        }
+        if (analysis.quality_checked) {
+            recorder.Record(LatencyStage::QUALITY, analysis.timings.quality_ms);
+        }
+        if (analysis.liveness_inferred) {
+            recorder.Record(LatencyStage::LIVENESS, analysis.timings.liveness_ms);
+        }
+        if (analysis.features) {
+            recorder.Record(LatencyStage::EXTRACT, analysis.timings.extract_ms);
+        }
+        if (accepted) {
+            ++info.features;
+            recorder.Record(LatencyStage::ENCODE, encode_ms);
+            recorder.Record(LatencyStage::SEND, send_ms);
+        }
+        recorder.Record(LatencyStage::TOTAL, total_ms);
+    }
+
+    info.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+    info.peak_rss_bytes = PeakResidentBytes();
+    recognizer.set_tracking(TrackingOptions{});
+
+    recorder.PrintText(info);
+    if (!report_path.empty()) {
+        std::string error;
+        if (!recorder.WriteJson(report_path, info, error)) {
+            std::cerr << "[Test] " << error << std::endl;
+            return 1;
+        }
+        std::println("[Test] JSON 报告已写入 {}", report_path);
+    }
+    return info.iterations > 0 ? 0 : 1;
+}
+
+namespace {
+
+// 命令负载为 key=value 行
+std::unordered_map<std::string, std::string> ParseCommandPayload(const std::string& payload) {
+    std::unordered_map<std::string, std::string> fields;
+    std::istringstream ss(payload);
+    std::string line;
+    while (std::getline(ss, line)) {
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        fields[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    return fields;
+}
+
+int PayloadInt(const std::unordered_map<std::string, std::string>& fields, const std::string& key, int fallback) {
+    const auto it = fields.find(key);
+    if (it == fields.end()) return fallback;
+    try {
+        return std::stoi(it->second);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+float PayloadFloat(const std::unordered_map<std::string, std::string>& fields, const std::string& key, float fallback) {
+    const auto it = fields.find(key);
+    if (it == fields.end()) return fallback;
+    try {
+        return std::stof(it->second);
+    } catch (const std::exception&) {
+        return fallback;
+    }
 }
 
+bool PayloadBool(const std::unordered_map<std::string, std::string>& fields, const std::string& key, bool fallback) {
+    const auto it = fields.find(key);
+    if (it == fields.end()) return fallback;
+    return it->second == "1" || it->second == "true";
+}
+
+} // namespace
+
+/**
+ * @brief 常驻识别守护进程
+ *
+ * 模型只加载一次，之后通过 FRCommandPacket 为 SU 提供识别、抓拍/录入与特征比对，
+ * 除首次请求外都走热路径。识别结果仍经 UDP 状态包发往 SU。
+ */
+class RecognizerDaemon {
+public:
+    RecognizerDaemon(const ConfigManager::CoreConfig& config, float face_threshold, float liveness_threshold,
+                     uint16_t command_port, std::string command_token, DWORD parent_pid)
+        : config_(config), face_threshold_(face_threshold), liveness_threshold_(liveness_threshold),
+          command_port_(command_port),
+          command_token_(std::move(command_token)) {
+        if (parent_pid != 0) {
+            parent_process_ = OpenProcess(SYNCHRONIZE, FALSE, parent_pid);
+            if (parent_process_ == nullptr) {
+                std::cerr << "[Daemon] 无法打开父进程句柄, pid=" << parent_pid
+                          << ", GetLastError=" << GetLastError() << std::endl;
+            }
+        }
+    }
+
+    ~RecognizerDaemon() {
+        StopRecognition();
+        JoinCapture();
+        if (parent_process_ != nullptr) {
+            CloseHandle(parent_process_);
+        }
+    }
+
+    int Run() {
+        std::cout << "[Daemon] 加载人脸识别模型..." << std::endl;
+        EngineOptions engine_options;
+        engine_options.preload_liveness = config_.liveness;
+        engine_options.detect_scale = config_.detect_scale;
+        engine_options.threads = config_.engine_threads;
+        engines_ = std::make_unique<EnginePool>(static_cast<size_t>(config_.engine_pool_size), engine_options);
+        feature_size_ = engines_->feature_size();
+        const ModelLoadTimings timings = engines_->load_timings(0);
+        std::println("[Daemon] 模型加载完成, 引擎 {} 个, 耗时 {:.1f} ms (单引擎: 检测 {:.1f} / 关键点 {:.1f} / 识别 {:.1f})",
+                     engines_->size(), engines_->load_ms(), timings.detector_ms, timings.landmarker_ms, timings.recognizer_ms);
+
+        smile2unlock::udp::FrCommandServer server(command_port_);
+        server.set_auth_token(command_token_);
+        server.set_handler([this](smile2unlock::FRCommandType type, const std::string& payload, std::string& result) {
+            return HandleCommand(type, payload, result);
+        });
+        server.start();
+        std::cout << "[Daemon] 已就绪, 命令端口=" << command_port_ << std::endl;
+
+        while (!shutdown_requested_) {
+            if (parent_process_ != nullptr && WaitForSingleObject(parent_process_, 0) == WAIT_OBJECT_0) {
+                std::cout << "[Daemon] 父进程已退出，守护进程结束" << std::endl;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+
+        StopRecognition();
+        server.stop();
+        JoinCapture();
+        std::cout << "[Daemon] 已退出, 共处理请求 " << requests_served_.load() << " 个" << std::endl;
+        return 0;
+    }
+
+private:
+    static constexpr int32_t kStatusOk = 0;
+    static constexpr int32_t kStatusError = -1;
+    static constexpr int32_t kStatusBusy = -2;
+    static constexpr int32_t kStatusInvalidPayload = -3;
+    static constexpr int32_t kStatusUnknownCommand = -4;
+
+    int32_t HandleCommand(smile2unlock::FRCommandType type, const std::string& payload, std::string& result) {
+        ++requests_served_;
+        const auto fields = ParseCommandPayload(payload);
+        switch (type) {
+            case smile2unlock::FRCommandType::PING:
+                result = "pong";
+                return kStatusOk;
+            case smile2unlock::FRCommandType::START_RECOGNITION:
+                return StartRecognition(fields, result);
+            case smile2unlock::FRCommandType::STOP_RECOGNITION:
+                StopRecognition();
+                result = "stopped";
+                return kStatusOk;
+            case smile2unlock::FRCommandType::GET_STATUS: {
+                std::ostringstream ss;
+                ss << "running=" << (recognition_running_ ? 1 : 0) << "\n";
+                ss << "requests=" << requests_served_.load() << "\n";
+                ss << "engines_idle=" << engines_->available() << "/" << engines_->size() << "\n";
+                result = ss.str();
+                return kStatusOk;
+            }
+            case smile2unlock::FRCommandType::EXTRACT_FEATURE:
+                return CaptureToSharedMemory(fields, result);
+            case smile2unlock::FRCommandType::COMPARE_FEATURES:
+                return CompareSharedFeatures(fields, result);
+            case smile2unlock::FRCommandType::SHUTDOWN:
+                shutdown_requested_ = true;
+                result = "bye";
+                return kStatusOk;
+            default:
+                result = "unknown command";
+                return kStatusUnknownCommand;
+        }
+    }
+
+    int32_t StartRecognition(const std::unordered_map<std::string, std::string>& fields, std::string& result) {
+        if (recognition_running_) {
+            result = "already_running=1";
+            return kStatusOk;
+        }
+        // 抓拍占用摄像头期间不开始识别（引擎池有空闲引擎时两者会同时打开同一摄像头）
+        if (capture_running_) {
+            result = "capture running";
+            return kStatusBusy;
+        }
+        if (recognition_thread_.joinable()) {
+            recognition_thread_.join();
+        }
+
+        RecognizeOptions options = RecognizeOptionsFromConfig(config_, liveness_threshold_);
+        options.fusion.match_threshold = face_threshold_;
+        options.camera_index = PayloadInt(fields, "camera", options.camera_index);
+        options.liveness_detection = PayloadBool(fields, "liveness", options.liveness_detection);
+        options.liveness_threshold = PayloadFloat(fields, "liveness_threshold", options.liveness_threshold);
+        options.debug = PayloadBool(fields, "debug", options.debug);
+        options.detect_scale = PayloadFloat(fields, "detect_scale", options.detect_scale);
+        options.quality_gate.enabled = PayloadBool(fields, "quality_gate", options.quality_gate.enabled);
+        const uint32_t session_id = static_cast<uint32_t>(PayloadInt(fields, "session", 0));
+
+        // SU 只在本命令往返期间保留图库映射，必须在回复前拷贝
+        if (const auto gallery_it = fields.find("gallery"); gallery_it != fields.end() && !gallery_it->second.empty()) {
+            float match_threshold = options.fusion.match_threshold;
+            if (LoadSharedGallery(gallery_it->second, options.gallery, match_threshold)) {
+                if (match_threshold > 0.0f) {
+                    options.fusion.match_threshold = match_threshold;
+                }
+            } else {
+                std::cerr << "[Daemon] 图库无效，按融合特征收敛判断" << std::endl;
+            }
+        }
+
+        recognition_stop_ = false;
+        recognition_running_ = true;
+        recognition_thread_ = std::thread([this, options = std::move(options), session_id]() {
+            try {
+                EngineLease engine = engines_->Acquire();
+                recognizeFace(options, engine.get(), &recognition_stop_, session_id);
+            } catch (const std::exception& e) {
+                std::cerr << "[Daemon] 识别会话异常: " << e.what() << std::endl;
+                if (g_udp_sender) {
+                    g_udp_sender->send_status(RecognitionStatus::RECOGNITION_ERROR, "", session_id);
+                }
+            }
+            recognition_running_ = false;
+        });
+        result = "started";
+        return kStatusOk;
+    }
+
+    void StopRecognition() {
+        recognition_stop_ = true;
+        if (recognition_thread_.joinable()) {
+            recognition_thread_.join();
+        }
+        recognition_running_ = false;
+    }
+
+    int32_t CaptureToSharedMemory(const std::unordered_map<std::string, std::string>& fields, std::string& result) {
+        const auto map_it = fields.find("map");
+        if (map_it == fields.end() || map_it->second.empty()) {
+            result = "missing map";
+            return kStatusInvalidPayload;
+        }
+        if (recognition_running_) {
+            result = "recognition running";
+            return kStatusBusy;
+        }
+        if (capture_running_) {
+            result = "capture running";
+            return kStatusBusy;
+        }
+        EngineLease engine = engines_->TryAcquire();
+        if (!engine) {
+            result = "engine busy";
+            return kStatusBusy;
+        }
+        JoinCapture();
+
+        // 打开摄像头与推理可能耗时数秒，放到工作线程上，命令线程继续响应 PING / STOP / SHUTDOWN。
+        // 结果（含失败）经共享内存的状态字段报告给 SU
+        const int camera = PayloadInt(fields, "camera", config_.camera);
+        const bool extract = PayloadBool(fields, "extract", false);
+        capture_running_ = true;
+        capture_thread_ = std::thread([this, engine = std::move(engine), camera, map_name = map_it->second, extract]() mutable {
+            try {
+                if (captureImageToSharedMemory(camera, map_name, extract, engine.get()) != 0) {
+                    std::cerr << "[Daemon] 抓拍失败, map=" << map_name << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "[Daemon] 抓拍异常: " << e.what() << std::endl;
+            }
+            engine.reset();
+            capture_running_ = false;
+        });
+        result = "started";
+        return kStatusOk;
+    }
+
+    void JoinCapture() {
+        if (capture_thread_.joinable()) {
+            capture_thread_.join();
+        }
+    }
+
+    // 共享内存特征区内容为 "<hexA>\n<hexB>"
+    int32_t CompareSharedFeatures(const std::unordered_map<std::string, std::string>& fields, std::string& result) {
+        const auto map_it = fields.find("map");
+        if (map_it == fields.end() || map_it->second.empty()) {
+            result = "missing map";
+            return kStatusInvalidPayload;
+        }
+
+        const smile2unlock::SharedRegion region = smile2unlock::SharedRegion::Open(
+            map_it->second, smile2unlock::SharedFrameMappingBytes(), smile2unlock::SharedRegionAccess::ReadOnly);
+        if (!region) {
+            result = "open mapping failed";
+            return kStatusError;
+        }
+
+        const auto* header = region.as<const smile2unlock::SharedFrameHeader>();
+        std::vector<unsigned char> payload;
+        smile2unlock::SharedFrameSlot info;
+        std::vector<unsigned char> image;
+        if (smile2unlock::ReadLatestSharedFrame(header, 0, info, image, &payload) != smile2unlock::SharedFrameRead::OK) {
+            payload.clear();
+        }
+
+        // 比对命令的特征区为 "hexA\nhexB" 文本
+        const std::string_view features(reinterpret_cast<const char*>(payload.data()), payload.size());
+        const size_t separator = features.find('\n');
+        if (separator == std::string_view::npos) {
+            result = "invalid feature payload";
+            return kStatusInvalidPayload;
+        }
+
+        // 比对不使用推理引擎，识别会话进行中也无需租用引擎
+        float similarity = 0.0f;
+        if (!CompareFeatureHex(features.substr(0, separator), features.substr(separator + 1), feature_size_, similarity)) {
+            result = "feature size mismatch";
+            return kStatusInvalidPayload;
+        }
+        result = "similarity=" + std::to_string(similarity);
+        return kStatusOk;
+    }
+
+    ConfigManager::CoreConfig config_;
+    float face_threshold_;
+    float liveness_threshold_;
+    uint16_t command_port_;
+    std::string command_token_;
+    HANDLE parent_process_ = nullptr;
+    std::unique_ptr<EnginePool> engines_;
+    int feature_size_ = 0;
+    std::thread recognition_thread_;
+    std::atomic<bool> recognition_running_{false};
+    std::thread capture_thread_;
+    std::atomic<bool> capture_running_{false};
+    std::atomic<bool> recognition_stop_{false};
+    std::atomic<bool> shutdown_requested_{false};
+    std::atomic<uint32_t> requests_served_{0};
+};
+
 int mainOptimized(int argc, char* argv[]) {
     cxxopts::Options options("FaceRecognizer",
         "人脸识别工具");
     
     options.add_options()
         ("h,help", "显示帮助信息")
-        ("m,mode", "操作模式: recognize, capture-image, preview-stream, compare-features, test",
+        ("m,mode", "操作模式: recognize, capture-image, preview-stream, compare-features, compare-batch, batch-extract, daemon, bench, test",
          cxxopts::value<std::string>()->default_value("help"))
         ("c,camera", "摄像头索引",
          cxxopts::value<int>())
@@ -409,6 +1242,8 @@ int mainOptimized(int argc, char* argv[]) {
          cxxopts::value<bool>())
         ("l,liveness-detection", "启用活体检测",
          cxxopts::value<bool>())
+        ("detect-scale", "人脸检测输入缩放比例 (0.25~1.0)，覆盖配置中的 detect_scale",
+         cxxopts::value<float>())
         ("udp-port", "UDP target port for sending recognition results",
          cxxopts::value<int>()->default_value("51234"))
         ("frame-map", "Shared memory mapping name for one-shot frame capture",
@@ -419,6 +1254,52 @@ int mainOptimized(int argc, char* argv[]) {
          cxxopts::value<std::string>()->default_value(""))
         ("extract-feature", "Extract feature and append it into shared memory payload",
          cxxopts::value<bool>()->default_value("false"))
+        ("command-port", "UDP port the daemon listens on for FRCommandPacket requests",
+         cxxopts::value<int>()->default_value("51238"))
+        ("command-token", "Per-launch token the daemon requires on every command (generated by Smile2Unlock)",
+         cxxopts::value<std::string>()->default_value(""))
+        ("parent-pid", "Daemon exits when this process exits (0 = no watch)",
+         cxxopts::value<unsigned int>()->default_value("0"))
+        ("bench", "Benchmark to run in bench mode: pipeline, frame-pool, convert, detect-scale, quality, fusion, camera-replay, feature-math, motion-gate, shm-ring, preview-codec",
+         cxxopts::value<std::string>()->default_value("pipeline"))
+        ("replay", "Directory of PPM/BMP (JPEG/PNG on Windows) frames replayed instead of a camera (or test images for detect-scale)",
+         cxxopts::value<std::string>()->default_value(""))
+        ("replay-fps", "Replay frame rate (<= 0 = unthrottled)",
+         cxxopts::value<double>()->default_value("30"))
+        ("replay-loops", "Number of passes over the replay directory",
+         cxxopts::value<int>()->default_value("1"))
+        ("camera-replay", "Image directory or raw frame dump (.yuy2/.nv12/.bgr24/.bgra32) used as the camera in every mode",
+         cxxopts::value<std::string>()->default_value(""))
+        ("camera-replay-format", "Raw format image directories are encoded to for camera replay: yuy2, nv12, bgr24, bgra32",
+         cxxopts::value<std::string>()->default_value("yuy2"))
+        ("camera-replay-size", "Frame size of a raw camera replay dump, WxH",
+         cxxopts::value<std::string>()->default_value(""))
+        ("camera-replay-fps", "Camera replay frame rate (<= 0 = unthrottled)",
+         cxxopts::value<double>()->default_value("30"))
+        ("camera-replay-loops", "Number of passes over the camera replay source (<= 0 = endless)",
+         cxxopts::value<int>()->default_value("0"))
+        ("frames", "Number of synthetic frames / iterations for frame-pool, convert and camera-replay benchmarks, and measured iterations for test mode",
+         cxxopts::value<int>()->default_value("300"))
+        ("scales", "Comma-separated detection scales for the detect-scale benchmark",
+         cxxopts::value<std::string>()->default_value("1.0,0.75,0.5,0.33"))
+        ("probe", "Probe feature file (feature batch file or label,hex lines) for compare-batch mode",
+         cxxopts::value<std::string>()->default_value(""))
+        ("gallery", "Gallery feature file for compare-batch mode (may be the same file as --probe)",
+         cxxopts::value<std::string>()->default_value(""))
+        ("scores", "Score matrix CSV written by compare-batch mode (empty = summary only)",
+         cxxopts::value<std::string>()->default_value("scores.csv"))
+        ("report", "JSON latency report written by test mode (empty = text only)",
+         cxxopts::value<std::string>()->default_value("latency_report.json"))
+        ("input", "Image directory or manifest (username,path per line) for batch-extract mode",
+         cxxopts::value<std::string>()->default_value(""))
+        ("output", "Feature batch file written by batch-extract mode",
+         cxxopts::value<std::string>()->default_value("features.sfb"))
+        ("workers", "Number of engine instances for batch-extract (0 = all logical cores)",
+         cxxopts::value<int>()->default_value("0"))
+        ("thumbnails", "Directory for aligned face thumbnails written by batch-extract (empty = none)",
+         cxxopts::value<std::string>()->default_value(""))
+        ("engine-threads", "Inference threads per engine for batch-extract and daemon (0 = logical cores / engines)",
+         cxxopts::value<int>()->default_value("0"))
         ;
     
     auto result = options.parse(argc, argv);
@@ -435,6 +1316,24 @@ int mainOptimized(int argc, char* argv[]) {
     std::string feature_b_hex = result["feature-b"].as<std::string>();
     const bool extract_feature = result["extract-feature"].as<bool>();
     g_udp_port = result["udp-port"].as<int>();
+
+    // 回放摄像头：之后创建的 CameraCapture 均从文件取帧（无头性能回归）
+    if (const std::string replay_path = result["camera-replay"].as<std::string>(); !replay_path.empty()) {
+        CameraReplayOptions replay;
+        replay.path = replay_path;
+        replay.fps = result["camera-replay-fps"].as<double>();
+        replay.loops = result["camera-replay-loops"].as<int>();
+        if (!ParseRawFrameFormat(result["camera-replay-format"].as<std::string>(), replay.format)) {
+            std::cerr << "未知的回放帧格式: " << result["camera-replay-format"].as<std::string>() << std::endl;
+            return 1;
+        }
+        const std::string size = result["camera-replay-size"].as<std::string>();
+        if (!size.empty() && std::sscanf(size.c_str(), "%dx%d", &replay.width, &replay.height) != 2) {
+            std::cerr << "回放帧尺寸格式应为 WxH: " << size << std::endl;
+            return 1;
+        }
+        ConfigureCameraReplay(replay);
+    }
     
     // 加载配置
     ConfigManager config_manager(smile2unlock::paths::GetConfigIniPath().string());
@@ -470,6 +1369,12 @@ int mainOptimized(int argc, char* argv[]) {
     if (result.count("debug")) {
         config.debug = result["debug"].as<bool>();
     }
+    if (result.count("detect-scale")) {
+        config.detect_scale = std::clamp(result["detect-scale"].as<float>(), 0.25f, 1.0f);
+    }
+    if (result.count("engine-threads")) {
+        config.engine_threads = std::max(0, result["engine-threads"].as<int>());
+    }
     
     // 解析阈值参数
     float face_threshold = config.face_threshold;
@@ -487,7 +1392,8 @@ int mainOptimized(int argc, char* argv[]) {
     }
     
     
-    if (!g_udp_sender) {
+    // test 模式只向自有的环回接收端发送，不连接 SU/CP 的状态端口
+    if (!g_udp_sender && mode != "test") {
         g_udp_sender = std::make_unique<UdpSender>("127.0.0.1", g_udp_port);
     }
 
@@ -495,9 +1401,9 @@ int mainOptimized(int argc, char* argv[]) {
     if (mode == "recognize") {
         std::cout << "=== 人脸识别模式 ===" << std::endl;
                 
-        return recognizeFace(config.camera,
-                                     config.liveness, liveness_threshold,
-                                     config.debug);
+        RecognizeOptions recognize_options = RecognizeOptionsFromConfig(config, liveness_threshold);
+        recognize_options.fusion.match_threshold = face_threshold;
+        return recognizeFace(recognize_options);
     }
     else if (mode == "capture-image") {
         std::cout << "=== 单帧抓拍模式 ===" << std::endl;
@@ -510,9 +1416,96 @@ int mainOptimized(int argc, char* argv[]) {
     else if (mode == "compare-features") {
         return compareFeatures(feature_a_hex, feature_b_hex);
     }
+    else if (mode == "compare-batch") {
+        CompareBatchOptions compare;
+        compare.probe = result["probe"].as<std::string>();
+        compare.gallery = result["gallery"].as<std::string>();
+        compare.output = result["scores"].as<std::string>();
+        compare.threshold = face_threshold;
+        return RunCompareBatch(compare);
+    }
+    else if (mode == "batch-extract") {
+        std::cout << "=== 批量录入模式 ===" << std::endl;
+        BatchExtractOptions batch;
+        batch.input = result["input"].as<std::string>();
+        batch.output = result["output"].as<std::string>();
+        batch.workers = result["workers"].as<int>();
+        batch.engine_threads = config.engine_threads;
+        batch.thumbnails = result["thumbnails"].as<std::string>();
+        batch.detect_scale = config.detect_scale;
+        return RunBatchExtract(batch);
+    }
+    else if (mode == "daemon") {
+        std::cout << "=== 常驻守护模式 ===" << std::endl;
+        const std::string command_token = result["command-token"].as<std::string>();
+        if (command_token.size() != smile2unlock::FRCommandPacket::AUTH_TOKEN_CHARS) {
+            std::cerr << "[Daemon] 缺少有效的 --command-token，拒绝启动" << std::endl;
+            return 1;
+        }
+        RecognizerDaemon daemon(config, face_threshold, liveness_threshold,
+                                static_cast<uint16_t>(result["command-port"].as<int>()),
+                                command_token,
+                                static_cast<DWORD>(result["parent-pid"].as<unsigned int>()));
+        return daemon.Run();
+    }
+    else if (mode == "bench") {
+        const std::string bench = result["bench"].as<std::string>();
+        const std::string replay_dir = result["replay"].as<std::string>();
+        if (bench == "pipeline") {
+            return RunPipelineBenchmark(replay_dir,
+                                        result["replay-fps"].as<double>(),
+                                        result["replay-loops"].as<int>());
+        }
+        if (bench == "frame-pool") {
+            return RunFramePoolBenchmark(result["frames"].as<int>(), 1280, 720);
+        }
+        if (bench == "convert") {
+            return RunPixelConvertBenchmark(result["frames"].as<int>(), 1280, 720);
+        }
+        if (bench == "detect-scale") {
+            return RunDetectScaleBenchmark(replay_dir, result["scales"].as<std::string>());
+        }
+        if (bench == "quality") {
+            return RunQualityBenchmark(replay_dir, QualityThresholdsFromConfig(config));
+        }
+        if (bench == "fusion") {
+            FusionOptions fusion = FusionOptionsFromConfig(config);
+            fusion.match_threshold = face_threshold;
+            return RunFusionBenchmark(replay_dir, fusion);
+        }
+        if (bench == "camera-replay") {
+            return RunCameraReplayBenchmark(replay_dir, result["frames"].as<int>());
+        }
+        if (bench == "feature-math") {
+            return RunFeatureMathBenchmark(2000, 1024);
+        }
+        if (bench == "shm-ring") {
+            return RunSharedFrameRingBenchmark(result["frames"].as<int>(), 2);
+        }
+        if (bench == "preview-codec") {
+            return RunPreviewCodecBenchmark(result["frames"].as<int>(), 1280, 720);
+        }
+        if (bench == "motion-gate") {
+            return RunMotionGateBenchmark(result["frames"].as<int>(), RecognizeOptionsFromConfig(config, liveness_threshold).motion_gate);
+        }
+        std::cout << "未知基准: " << bench << std::endl;
+        return 1;
+    }
     else if (mode == "test") {
-        std::cout << "测试模式暂未实现" << std::endl;
-        return 0;
+        std::cout << "=== 端到端延迟测试模式 ===" << std::endl;
+        // 未显式指定回放摄像头时，--replay 目录以不限速回放作为帧源，结果可复现
+        const std::string replay_dir = result["replay"].as<std::string>();
+        if (!CameraReplayConfig().enabled() && !replay_dir.empty()) {
+            CameraReplayOptions replay;
+            replay.path = replay_dir;
+            replay.fps = 0.0;
+            replay.loops = 0;
+            ConfigureCameraReplay(replay);
+        }
+        RecognizeOptions recognize_options = RecognizeOptionsFromConfig(config, liveness_threshold);
+        return runLatencyTest(recognize_options,
+                              result["frames"].as<int>(),
+                              result["report"].as<std::string>());
     }
     else {
         std::cout << "未知模式: " << mode << std::endl;
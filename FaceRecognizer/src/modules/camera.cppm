@@ -1,6 +1,5 @@
 module;
 
-#include <libyuv.h>
 #include <seeta/Common/CStruct.h>
 
 
@@ -15,6 +14,310 @@ module;
 export module camera;
 
 import std;
+import frame_pool;
+import image_io;
+import pixel_convert;
+
+// 摄像头原始帧格式（与 Media Foundation 子类型一一对应）
+export enum class RawFrameFormat : std::uint8_t {
+  YUY2 = 0,
+  NV12,
+  BGR24,
+  BGRA32,
+};
+
+export const char* RawFrameFormatName(RawFrameFormat format) {
+  switch (format) {
+    case RawFrameFormat::YUY2: return "yuy2";
+    case RawFrameFormat::NV12: return "nv12";
+    case RawFrameFormat::BGR24: return "bgr24";
+    case RawFrameFormat::BGRA32: return "bgra32";
+  }
+  return "unknown";
+}
+
+// 接受格式名或原始帧文件扩展名（yuy2/yuyv、nv12、bgr24/bgr、bgra32/bgra）
+export bool ParseRawFrameFormat(std::string_view text, RawFrameFormat& format) {
+  std::string name(text);
+  if (!name.empty() && name.front() == '.') name.erase(name.begin());
+  std::transform(name.begin(), name.end(), name.begin(),
+                 [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+  if (name == "yuy2" || name == "yuyv") {
+    format = RawFrameFormat::YUY2;
+  } else if (name == "nv12") {
+    format = RawFrameFormat::NV12;
+  } else if (name == "bgr24" || name == "bgr") {
+    format = RawFrameFormat::BGR24;
+  } else if (name == "bgra32" || name == "bgra") {
+    format = RawFrameFormat::BGRA32;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// 紧凑排列时每行字节数；NV12 为 Y 平面行宽，UV 平面紧随其后
+export int RawFrameStride(RawFrameFormat format, int width) {
+  switch (format) {
+    case RawFrameFormat::YUY2: return width * 2;
+    case RawFrameFormat::NV12: return (width + 1) & ~1;
+    case RawFrameFormat::BGR24: return width * 3;
+    case RawFrameFormat::BGRA32: return width * 4;
+  }
+  return 0;
+}
+
+export std::size_t RawFrameBytes(RawFrameFormat format, int width, int height) {
+  const std::size_t stride = static_cast<std::size_t>(RawFrameStride(format, width));
+  if (format == RawFrameFormat::NV12) {
+    return stride * height + stride * ((height + 1) / 2);
+  }
+  return stride * height;
+}
+
+// 原始帧 -> RGB24：Media Foundation 与回放后端共用同一转换路径（SIMD 内核运行时选择）
+export bool ConvertRawFrame(RawFrameFormat format, const std::uint8_t* data, int stride,
+                            int width, int height, bool bottom_up,
+                            std::uint8_t* dst, int dst_stride) {
+  switch (format) {
+    case RawFrameFormat::YUY2:
+      return ConvertYuy2ToRgb24(data, stride, dst, dst_stride, width, height);
+    case RawFrameFormat::NV12: {
+      // NV12 布局：Y 平面 + UV 交错平面（半高），UV 平面紧随 Y 平面之后
+      const std::uint8_t* uv_plane = data + static_cast<std::size_t>(stride) * height;
+      return ConvertNv12ToRgb24(data, stride, uv_plane, stride, dst, dst_stride, width, height);
+    }
+    case RawFrameFormat::BGR24:
+      return ConvertBgr24ToRgb24(data, stride, dst, dst_stride, width, height, bottom_up);
+    case RawFrameFormat::BGRA32:
+      return ConvertBgra32ToRgb24(data, stride, dst, dst_stride, width, height, bottom_up);
+  }
+  return false;
+}
+
+/**
+ * 回放摄像头配置：path 为图像目录或原始帧文件（扩展名 .yuy2/.nv12/.bgr24/.bgra32）。
+ * 图像目录中的帧在加载时预编码为 format，采集时与真实摄像头一样逐帧转换为 RGB24。
+ */
+export struct CameraReplayOptions {
+  std::string path;
+  RawFrameFormat format = RawFrameFormat::YUY2;  // 图像目录的预编码格式
+  int width = 0;                                 // 原始帧文件的帧尺寸
+  int height = 0;
+  double fps = 30.0;                             // <= 0 表示不限速
+  int loops = 0;                                 // <= 0 表示无限循环
+
+  bool enabled() const { return !path.empty(); }
+};
+
+namespace detail {
+
+inline CameraReplayOptions& ReplayConfig() {
+  static CameraReplayOptions options;
+  return options;
+}
+
+inline std::uint8_t ClampByte(int value) {
+  return static_cast<std::uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// RGB -> BT.601 有限范围 YUV，与 pixel_convert 的解码系数对应
+inline std::uint8_t RgbToY(int r, int g, int b) { return ClampByte(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16); }
+inline std::uint8_t RgbToU(int r, int g, int b) { return ClampByte(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128); }
+inline std::uint8_t RgbToV(int r, int g, int b) { return ClampByte(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128); }
+
+// 把 RGB24 图像编码为摄像头原始格式（仅在加载时执行一次）；YUY2 / NV12 的宽（NV12 还有高）裁为偶数
+inline bool EncodeRawFrame(const RgbImage& image, RawFrameFormat format,
+                           std::vector<std::uint8_t>& out, int& width, int& height) {
+  width = image.width;
+  height = image.height;
+  if (format == RawFrameFormat::YUY2 || format == RawFrameFormat::NV12) width &= ~1;
+  if (format == RawFrameFormat::NV12) height &= ~1;
+  if (width <= 0 || height <= 0) return false;
+
+  const int stride = RawFrameStride(format, width);
+  out.assign(RawFrameBytes(format, width, height), 0);
+  auto pixel = [&image](int x, int y) { return image.pixels.data() + (static_cast<std::size_t>(y) * image.width + x) * 3; };
+
+  for (int y = 0; y < height; ++y) {
+    std::uint8_t* row = out.data() + static_cast<std::size_t>(y) * stride;
+    for (int x = 0; x < width; ++x) {
+      const std::uint8_t* p = pixel(x, y);
+      switch (format) {
+        case RawFrameFormat::YUY2:
+          row[x * 2] = RgbToY(p[0], p[1], p[2]);
+          if ((x & 1) == 0) {
+            const std::uint8_t* q = pixel(x + 1, y);
+            const int r = (p[0] + q[0] + 1) >> 1;
+            const int g = (p[1] + q[1] + 1) >> 1;
+            const int b = (p[2] + q[2] + 1) >> 1;
+            row[x * 2 + 1] = RgbToU(r, g, b);
+            row[x * 2 + 3] = RgbToV(r, g, b);
+          }
+          break;
+        case RawFrameFormat::NV12:
+          row[x] = RgbToY(p[0], p[1], p[2]);
+          break;
+        case RawFrameFormat::BGR24:
+          row[x * 3] = p[2];
+          row[x * 3 + 1] = p[1];
+          row[x * 3 + 2] = p[0];
+          break;
+        case RawFrameFormat::BGRA32:
+          row[x * 4] = p[2];
+          row[x * 4 + 1] = p[1];
+          row[x * 4 + 2] = p[0];
+          row[x * 4 + 3] = 255;
+          break;
+      }
+    }
+  }
+
+  if (format == RawFrameFormat::NV12) {
+    std::uint8_t* uv = out.data() + static_cast<std::size_t>(stride) * height;
+    for (int y = 0; y < height; y += 2) {
+      std::uint8_t* row = uv + static_cast<std::size_t>(y / 2) * stride;
+      for (int x = 0; x < width; x += 2) {
+        int r = 0, g = 0, b = 0;
+        for (int dy = 0; dy < 2; ++dy) {
+          for (int dx = 0; dx < 2; ++dx) {
+            const std::uint8_t* p = pixel(x + dx, y + dy);
+            r += p[0];
+            g += p[1];
+            b += p[2];
+          }
+        }
+        row[x] = RgbToU((r + 2) >> 2, (g + 2) >> 2, (b + 2) >> 2);
+        row[x + 1] = RgbToV((r + 2) >> 2, (g + 2) >> 2, (b + 2) >> 2);
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+// 设置 / 读取进程内回放配置；设置后新建的 CameraCapture 使用回放后端
+export void ConfigureCameraReplay(const CameraReplayOptions& options) {
+  detail::ReplayConfig() = options;
+}
+
+export const CameraReplayOptions& CameraReplayConfig() {
+  return detail::ReplayConfig();
+}
+
+// 回放摄像头后端：帧以原始格式保存在内存，按帧率节流后经 ConvertRawFrame 输出 RGB24
+export class ReplayCameraBackend {
+ public:
+  explicit ReplayCameraBackend(const CameraReplayOptions& options) : loops_(options.loops) {
+    const std::filesystem::path path(options.path);
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+      format_ = options.format;
+      for (const auto& file : ListImageFiles(path)) {
+        RgbImage image;
+        RawFrame frame;
+        if (LoadImageFile(file, image) &&
+            detail::EncodeRawFrame(image, format_, frame.data, frame.width, frame.height)) {
+          frames_.push_back(std::move(frame));
+        }
+      }
+    } else if (!ParseRawFrameFormat(path.extension().string(), format_)) {
+      std::cerr << "[Camera] 无法识别的原始帧文件格式: " << options.path << std::endl;
+    } else {
+      LoadRawDump(path, options.width, options.height);
+    }
+
+    if (options.fps > 0.0) {
+      interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / options.fps));
+    }
+    if (!frames_.empty()) {
+      std::cout << "[Camera] 回放后端已加载 " << frames_.size() << " 帧 (" << RawFrameFormatName(format_)
+                << ", " << frames_.front().width << "x" << frames_.front().height << "): " << options.path << std::endl;
+    } else {
+      std::cerr << "[Camera] 回放源中没有可用帧: " << options.path << std::endl;
+    }
+  }
+
+  bool IsInitialized() const { return !frames_.empty(); }
+  bool Exhausted() const { return frames_.empty() || (loops_ > 0 && completed_loops_ >= loops_); }
+  std::size_t frame_count() const { return frames_.size(); }
+  RawFrameFormat format() const { return format_; }
+  double last_convert_ms() const { return last_convert_ms_; }
+
+  bool CaptureFrame(PooledFrame& frame) {
+    if (Exhausted()) {
+      return false;
+    }
+
+    // 按摄像头帧间隔节流，模拟真实采集速度
+    if (interval_.count() > 0) {
+      const auto now = std::chrono::steady_clock::now();
+      if (next_due_ > now) {
+        std::this_thread::sleep_until(next_due_);
+      }
+      next_due_ = std::max(next_due_, now) + interval_;
+    }
+
+    const RawFrame& raw = frames_[index_];
+    if (++index_ >= frames_.size()) {
+      index_ = 0;
+      ++completed_loops_;
+    }
+    unsigned char* dst = frame.Prepare(pool_, raw.width, raw.height, 3);
+    const auto convert_start = std::chrono::steady_clock::now();
+    const bool converted = ConvertRawFrame(format_, raw.data.data(), RawFrameStride(format_, raw.width),
+                                           raw.width, raw.height, false, dst, raw.width * 3);
+    last_convert_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - convert_start).count();
+    if (!converted) {
+      frame.width = 0;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  struct RawFrame {
+    std::vector<std::uint8_t> data;
+    int width = 0;
+    int height = 0;
+  };
+
+  void LoadRawDump(const std::filesystem::path& path, int width, int height) {
+    if (width <= 0 || height <= 0) {
+      std::cerr << "[Camera] 原始帧文件需要指定帧尺寸: " << path.string() << std::endl;
+      return;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      std::cerr << "[Camera] 无法打开原始帧文件: " << path.string() << std::endl;
+      return;
+    }
+    const std::size_t frame_bytes = RawFrameBytes(format_, width, height);
+    while (true) {
+      RawFrame frame;
+      frame.width = width;
+      frame.height = height;
+      frame.data.resize(frame_bytes);
+      in.read(reinterpret_cast<char*>(frame.data.data()), static_cast<std::streamsize>(frame_bytes));
+      if (static_cast<std::size_t>(in.gcount()) != frame_bytes) {
+        break;  // 末尾不完整的帧丢弃
+      }
+      frames_.push_back(std::move(frame));
+    }
+  }
+
+  std::vector<RawFrame> frames_;
+  RawFrameFormat format_ = RawFrameFormat::YUY2;
+  FramePool pool_{4};
+  std::size_t index_ = 0;
+  int loops_ = 0;
+  int completed_loops_ = 0;
+  double last_convert_ms_ = 0.0;
+  std::chrono::steady_clock::duration interval_{0};
+  std::chrono::steady_clock::time_point next_due_{};
+};
 
 #ifdef _WIN32
 inline bool EnsureMFInitialized();
@@ -43,6 +346,15 @@ export class CameraCapture {
   int m_cameraIndex = 0;
   bool m_initialized = false;
 
+  // 输出帧缓冲池，跨帧复用，稳态下不再逐帧分配
+  FramePool m_framePool{4};
+
+  // 配置了回放源时替代 Media Foundation
+  std::unique_ptr<ReplayCameraBackend> m_replay;
+
+  // 最近一帧原始格式 -> RGB24 的转换耗时
+  double m_lastConvertMs = 0.0;
+
   // 枚举所有摄像头激活器
   HRESULT EnumerateCameras(std::vector<IMFActivate*>& activates) {
     if (!EnsureMFInitialized()) {
@@ -187,6 +499,12 @@ export class CameraCapture {
   explicit CameraCapture(int cameraIndex = 0) : m_cameraIndex(cameraIndex) {
     std::cout << "[Camera] 初始化摄像头 (索引: " << cameraIndex << ")" << std::endl;
 
+    if (CameraReplayConfig().enabled()) {
+      m_replay = std::make_unique<ReplayCameraBackend>(CameraReplayConfig());
+      m_initialized = m_replay->IsInitialized();
+      return;
+    }
+
     if (!EnsureMFInitialized()) {
       std::cerr << "[Camera] Media Foundation 初始化失败" << std::endl;
       m_initialized = false;
@@ -264,8 +582,17 @@ export class CameraCapture {
 
   bool IsInitialized() const { return m_initialized; }
 
-  // 捕获单帧并填充到SeetaImageData（调用者负责释放data）
-  bool CaptureFrame(SeetaImageData& image) {
+  // 回放源已按 loops 播放完毕；真实摄像头永不耗尽
+  bool Exhausted() const { return m_replay && m_replay->Exhausted(); }
+
+  // 最近一次 CaptureFrame 中像素格式转换的耗时（毫秒），其余为取帧等待
+  double LastConvertMs() const { return m_replay ? m_replay->last_convert_ms() : m_lastConvertMs; }
+
+  // 捕获单帧写入 frame；frame 已持有足够大的缓冲区时直接复用，否则从帧池借出
+  bool CaptureFrame(PooledFrame& frame) {
+    if (m_replay) {
+      return m_initialized && m_replay->CaptureFrame(frame);
+    }
     if (!m_initialized || !m_reader) {
       std::cerr << "[Camera] 摄像头未初始化或读取器为空" << std::endl;
       return false;
@@ -383,168 +710,48 @@ export class CameraCapture {
         continue;
       }
 
-      // 分配输出缓冲区 (RGB24: 3字节/像素)
-      image.width = static_cast<int>(width);
-      image.height = static_cast<int>(height);
-      image.channels = 3;
-      image.data = new unsigned char[width * height * 3];
+      // 输出缓冲区 (RGB24: 3字节/像素)
+      unsigned char* dst = frame.Prepare(m_framePool, static_cast<int>(width), static_cast<int>(height), 3);
 
-      // 根据格式处理数据
-      if (subtype == MFVideoFormat_YUY2) {
-          // YUY2 格式: 先转 ARGB，再转 RGB24
-          std::cout << "[Camera] 转换YUY2格式为RGB24..." << std::endl;
-
-          // 分配临时 ARGB 缓冲区（4字节/像素）
-          std::vector<uint8_t> argb_buffer(width * height * 4);
-
-          // YUY2 stride: 4字节表示2像素，所以 stride = width * 2
-          int yuy2_stride = hasStride ? abs(stride) : (width * 2);
-          int argb_stride = width * 4;
-
-          // 第一步：YUY2 -> ARGB
-          int ret = libyuv::YUY2ToARGB(
-              pData,              // 源 YUY2 数据
-              yuy2_stride,        // 源 stride
-              argb_buffer.data(), // 目标 ARGB 缓冲区
-              argb_stride,        // 目标 stride
-              width,              // 宽度
-              height              // 高度
-          );
-
-          if (ret != 0) {
-              std::cerr << "[Camera] YUY2ToARGB 转换失败，错误码: " << ret << std::endl;
-              delete[] image.data;
-              image.data = nullptr;
-              pBuffer->Unlock();
-              pBuffer->Release();
-              pSample->Release();
-              continue;
-          }
-
-          // 第二步：ARGB -> RAW(RGB24)
-          // libyuv::ARGBToRGB24 输出的 24-bit 排列更接近 BGR，
-          // 这里使用 ARGBToRAW 明确得到 RGB 顺序，和 SU/OpenGL 保持一致。
-          ret = libyuv::ARGBToRAW(
-              argb_buffer.data(), // 源 ARGB
-              argb_stride,        // 源 stride
-              image.data,         // 目标 RGB24
-              width * 3,          // 目标 stride
-              width,              // 宽度
-              height              // 高度
-          );
-
-          if (ret != 0) {
-              std::cerr << "[Camera] ARGBToRAW 转换失败，错误码: " << ret << std::endl;
-              delete[] image.data;
-              image.data = nullptr;
-              pBuffer->Unlock();
-              pBuffer->Release();
-              pSample->Release();
-              continue;
-          }
+      // 根据格式处理数据：单遍转换直接写入输出缓冲区（SIMD 内核运行时选择）
+      const int frameWidth = static_cast<int>(width);
+      const int frameHeight = static_cast<int>(height);
+      const int dstStride = frameWidth * 3;
+      bool converted = false;
 
+      // stride 为负表示 RGB 帧底向上存储；未提供 stride 时按紧凑排列
+      RawFrameFormat format = RawFrameFormat::YUY2;
+      bool supported = true;
+      if (subtype == MFVideoFormat_YUY2) {
+          format = RawFrameFormat::YUY2;
       } else if (subtype == MFVideoFormat_NV12) {
-          // NV12 格式: YUV 4:2:0 planar
-          std::cout << "[Camera] 转换NV12格式为RGB24..." << std::endl;
-
-          // 注意：NV12ToRGB24 也不存在！需要先转 ARGB，再转 RGB24
-          std::vector<uint8_t> argb_buffer(width * height * 4);
-
-          // NV12 布局：Y 平面 + UV 交错平面
-          const uint8_t* y_plane = pData;
-          const uint8_t* uv_plane = pData + (width * height);
-
-          // 计算 strides（考虑对齐）
-          int y_stride = hasStride ? abs(stride) : ((width + 1) & ~1);
-          int uv_stride = y_stride;
-          int argb_stride = width * 4;
-
-          // 第一步：NV12 -> ARGB
-          int ret = libyuv::NV12ToARGB(
-              y_plane,            // Y 平面
-              y_stride,           // Y stride
-              uv_plane,           // UV 平面
-              uv_stride,          // UV stride
-              argb_buffer.data(), // 目标 ARGB
-              argb_stride,        // 目标 stride
-              width,              // 宽度
-              height              // 高度
-          );
-
-          if (ret != 0) {
-              std::cerr << "[Camera] NV12ToARGB 转换失败，错误码: " << ret << std::endl;
-              delete[] image.data;
-              image.data = nullptr;
-              pBuffer->Unlock();
-              pBuffer->Release();
-              pSample->Release();
-              continue;
-          }
-
-          // 第二步：ARGB -> RAW(RGB24)
-          ret = libyuv::ARGBToRAW(
-              argb_buffer.data(),
-              argb_stride,
-              image.data,
-              width * 3,
-              width,
-              height
-          );
-
-          if (ret != 0) {
-              std::cerr << "[Camera] ARGBToRAW 转换失败，错误码: " << ret << std::endl;
-              delete[] image.data;
-              image.data = nullptr;
-              pBuffer->Unlock();
-              pBuffer->Release();
-              pSample->Release();
-              continue;
-          }
-
+          format = RawFrameFormat::NV12;
       } else if (subtype == MFVideoFormat_RGB24) {
-          // RGB24 格式: Media Foundation 的 RGB24 通常是 BGR 顺序的 bottom-up 格式
-          std::cout << "[Camera] 处理RGB24格式..." << std::endl;
-          if (stride != 0) {
-              bool isBottomUp = (stride < 0);
-              int absStride = (stride < 0) ? -stride : stride;
-
-              for (UINT32 y = 0; y < height; ++y) {
-                  const BYTE* srcRow =
-                      pData + (isBottomUp ? (height - 1 - y) : y) * absStride;
-                  BYTE* dstRow = image.data + y * width * 3;
-
-                  // 复制并交换 BGR→RGB（因为 Media Foundation RGB24 是 BGR 顺序）
-                  for (UINT32 x = 0; x < width; ++x) {
-                      dstRow[x * 3] = srcRow[x * 3 + 2];      // R (from B position)
-                      dstRow[x * 3 + 1] = srcRow[x * 3 + 1];  // G
-                      dstRow[x * 3 + 2] = srcRow[x * 3];      // B (from R position)
-                  }
-              }
-          } else {
-              // stride 为 0 时，假设是连续存储
-              for (UINT32 i = 0; i < width * height; ++i) {
-                  image.data[i * 3] = pData[i * 3 + 2];      // BGR→RGB
-                  image.data[i * 3 + 1] = pData[i * 3 + 1];
-                  image.data[i * 3 + 2] = pData[i * 3];
-              }
-          }
-
+          // Media Foundation 的 RGB24 为 BGR 顺序
+          format = RawFrameFormat::BGR24;
       } else if (subtype == MFVideoFormat_RGB32) {
-        // RGB32 (BGRA) 转 RGB24 - 手动转换
-        std::cout << "[Camera] 转换RGB32格式为RGB24..." << std::endl;
-
-        for (UINT32 i = 0; i < width * height; ++i) {
-          image.data[i * 3] = pData[i * 4 + 2];      // R (from B)
-          image.data[i * 3 + 1] = pData[i * 4 + 1];  // G
-          image.data[i * 3 + 2] = pData[i * 4];      // B (from R)
-        }
+          // RGB32 为 BGRA 顺序
+          format = RawFrameFormat::BGRA32;
       } else {
+        supported = false;
         // 不支持的格式 - 打印GUID以便调试
         wchar_t guidStr[40];
         StringFromGUID2(subtype, guidStr, 40);
         std::wcerr << L"[Camera] 不支持的格式 GUID: " << guidStr << std::endl;
-        delete[] image.data;
-        image.data = nullptr;
+      }
+
+      if (supported) {
+          const auto convertStart = std::chrono::steady_clock::now();
+          const bool isRgb = format == RawFrameFormat::BGR24 || format == RawFrameFormat::BGRA32;
+          const bool isBottomUp = isRgb && hasStride && stride < 0;
+          const int srcStride = (hasStride && stride != 0) ? abs(stride) : RawFrameStride(format, frameWidth);
+          converted = ConvertRawFrame(format, pData, srcStride, frameWidth, frameHeight, isBottomUp, dst, dstStride);
+          m_lastConvertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - convertStart).count();
+      }
+
+      if (!converted) {
+        std::cerr << "[Camera] 帧格式转换失败" << std::endl;
+        frame.width = 0;
         pBuffer->Unlock();
         pBuffer->Release();
         pSample->Release();
@@ -558,22 +765,21 @@ export class CameraCapture {
       pBuffer->Release();
       pSample->Release();
 
-      if (image.width > 0 && image.height > 0) {
-        std::cout << "[Camera] 成功捕获并转换帧为RGB24 (" << std::dec << image.width << "x" << image.height << ")" << std::endl;
+      if (frame.valid()) {
+        std::cout << "[Camera] 成功捕获并转换帧为RGB24 (" << std::dec << frame.width << "x" << frame.height << ")" << std::endl;
 
         // 首次捕获时，执行色彩验证
         static bool firstCapture = true;
         if (firstCapture) {
           std::cout << "[Camera] 执行首帧色彩验证..." << std::endl;
-          ValidateColorStatistics(image);
+          ValidateColorStatistics(frame.view());
           firstCapture = false;
         }
 
         return true;
       } else {
         std::cerr << "[Camera] 帧数据验证失败" << std::endl;
-        delete[] image.data;
-        image.data = nullptr;
+        frame.width = 0;
         continue;
       }
     }
@@ -631,6 +837,8 @@ export class CameraCapture {
 
   // 静态工具：获取系统可用摄像头数量
   static int GetCameraCount() {
+    if (CameraReplayConfig().enabled())
+      return 1;
     if (!EnsureMFInitialized())
       return 0;
 
@@ -658,4 +866,36 @@ export class CameraCapture {
 
 #elif defined(__linux__) || defined(__unix__)
 
+// 非 Windows 平台没有 Media Foundation，摄像头由回放后端提供（ConfigureCameraReplay），
+// 用于无头环境下的确定性性能回归
+export class CameraCapture {
+ public:
+  explicit CameraCapture(int cameraIndex = 0) : m_cameraIndex(cameraIndex) {
+    std::cout << "[Camera] 初始化摄像头 (索引: " << cameraIndex << ")" << std::endl;
+    if (!CameraReplayConfig().enabled()) {
+      std::cerr << "[Camera] 当前平台仅支持回放摄像头，请先配置回放源" << std::endl;
+      return;
+    }
+    m_replay = std::make_unique<ReplayCameraBackend>(CameraReplayConfig());
+  }
+
+  bool IsInitialized() const { return m_replay && m_replay->IsInitialized(); }
+
+  bool Exhausted() const { return !m_replay || m_replay->Exhausted(); }
+
+  double LastConvertMs() const { return m_replay ? m_replay->last_convert_ms() : 0.0; }
+
+  bool CaptureFrame(PooledFrame& frame) {
+    return IsInitialized() && m_replay->CaptureFrame(frame);
+  }
+
+  static int GetCameraCount() {
+    return CameraReplayConfig().enabled() ? 1 : 0;
+  }
+
+ private:
+  int m_cameraIndex = 0;
+  std::unique_ptr<ReplayCameraBackend> m_replay;
+};
+
 #endif
@@ -0,0 +1,272 @@
+module;
+
+#include <seeta/Common/CStruct.h>
+
+export module frame_pipeline;
+
+import std;
+import frame_pool;
+import camera;
+
+// 采集 / 推理流水线
+//
+// 采集线程把帧写入固定数量的槽位（每个槽位持有一块池化缓冲区并跨帧复用），推理线程每次只取最新一帧；
+// 推理慢于采集时旧帧被直接丢弃（drop-oldest），避免识别落后于摄像头画面。
+
+export struct PipelineFrame {
+    PooledFrame image;
+    std::uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point captured_at{};
+
+    SeetaImageData view() const {
+        return image.view();
+    }
+
+    // 复制像素到本帧缓冲区，容量足够时不会重新分配
+    void assign(const SeetaImageData& source, FramePool& pool) {
+        unsigned char* dst = image.Prepare(pool, source.width, source.height, source.channels);
+        std::memcpy(dst, source.data, image.bytes());
+    }
+};
+
+// 帧来源：摄像头或离线回放
+export class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // 读取一帧写入 frame（应复用其缓冲区）；暂时无帧时返回 false
+    virtual bool Read(PipelineFrame& frame) = 0;
+
+    // 来源已耗尽（回放结束），采集线程将退出
+    virtual bool Exhausted() const { return false; }
+};
+
+// 摄像头帧源：在采集线程上调用 CaptureFrame，帧数据直接写入流水线槽位；
+// 离线回放同样经由 CameraCapture（ConfigureCameraReplay），与真实采集走相同的格式转换路径
+export class CameraFrameSource : public FrameSource {
+public:
+    explicit CameraFrameSource(std::unique_ptr<CameraCapture> camera) : camera_(std::move(camera)) {}
+
+    bool Read(PipelineFrame& frame) override {
+        // 直接写入槽位自带的缓冲区，无需额外拷贝
+        return camera_->CaptureFrame(frame.image);
+    }
+
+    bool Exhausted() const override { return camera_->Exhausted(); }
+
+private:
+    std::unique_ptr<CameraCapture> camera_;
+};
+
+export struct PipelineStats {
+    std::uint64_t captured = 0;          // 成功写入环形缓冲的帧数
+    std::uint64_t consumed = 0;          // 交给推理线程的帧数
+    std::uint64_t dropped = 0;           // 未被推理即被覆盖或跳过的帧数
+    std::uint64_t capture_failures = 0;  // 帧源读取失败次数
+    std::size_t depth = 0;               // 当前待处理帧数
+    std::size_t max_depth = 0;           // 运行期间的最大待处理帧数
+    std::size_t capacity = 0;
+};
+
+export class FramePipeline;
+
+// 推理线程持有的帧租约，析构时归还槽位
+export class FrameLease {
+public:
+    FrameLease() = default;
+    FrameLease(const FrameLease&) = delete;
+    FrameLease& operator=(const FrameLease&) = delete;
+    FrameLease(FrameLease&& other) noexcept
+        : owner_(std::exchange(other.owner_, nullptr)), slot_(other.slot_) {}
+    FrameLease& operator=(FrameLease&& other) noexcept {
+        if (this != &other) {
+            release();
+            owner_ = std::exchange(other.owner_, nullptr);
+            slot_ = other.slot_;
+        }
+        return *this;
+    }
+    ~FrameLease() { release(); }
+
+    explicit operator bool() const { return owner_ != nullptr; }
+    const PipelineFrame& frame() const;
+    SeetaImageData image() const { return frame().view(); }
+    void release();
+
+private:
+    friend class FramePipeline;
+    FrameLease(FramePipeline* owner, std::size_t slot) : owner_(owner), slot_(slot) {}
+
+    FramePipeline* owner_ = nullptr;
+    std::size_t slot_ = 0;
+};
+
+export class FramePipeline {
+public:
+    // 至少 3 个槽位：采集写入、推理读取、待处理各占一个，采集线程永不阻塞
+    explicit FramePipeline(std::unique_ptr<FrameSource> source, std::size_t capacity = 3)
+        : source_(std::move(source)), slots_(std::max<std::size_t>(capacity, 3)) {}
+
+    ~FramePipeline() { Stop(); }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    void Start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        finished_ = false;
+        capture_thread_ = std::thread(&FramePipeline::CaptureLoop, this);
+    }
+
+    void Stop() {
+        running_ = false;
+        cv_.notify_all();
+        if (capture_thread_.joinable()) {
+            capture_thread_.join();
+        }
+    }
+
+    // 取最新一帧，更早的待处理帧计为丢弃；超时或帧源耗尽时返回空租约
+    FrameLease AcquireLatest(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [this]() { return ReadyCountLocked() > 0 || finished_; });
+
+        std::size_t newest = slots_.size();
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].state != SlotState::Ready) continue;
+            if (newest == slots_.size() || slots_[i].frame.sequence > slots_[newest].frame.sequence) {
+                newest = i;
+            }
+        }
+        if (newest == slots_.size()) {
+            return {};
+        }
+
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            if (i != newest && slots_[i].state == SlotState::Ready) {
+                slots_[i].state = SlotState::Free;
+                ++stats_.dropped;
+            }
+        }
+        slots_[newest].state = SlotState::Reading;
+        ++stats_.consumed;
+        return FrameLease(this, newest);
+    }
+
+    // 帧源已耗尽且没有待处理帧
+    bool Finished() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return finished_ && ReadyCountLocked() == 0;
+    }
+
+    PipelineStats Stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PipelineStats stats = stats_;
+        stats.depth = ReadyCountLocked();
+        stats.capacity = slots_.size();
+        return stats;
+    }
+
+private:
+    friend class FrameLease;
+
+    enum class SlotState { Free, Writing, Ready, Reading };
+
+    struct Slot {
+        PipelineFrame frame;
+        SlotState state = SlotState::Free;
+    };
+
+    std::size_t ReadyCountLocked() const {
+        return static_cast<std::size_t>(std::count_if(slots_.begin(), slots_.end(),
+            [](const Slot& slot) { return slot.state == SlotState::Ready; }));
+    }
+
+    // 优先使用空闲槽位；没有空闲槽位时覆盖最旧的待处理帧
+    std::size_t ClaimWriteSlotLocked() {
+        std::size_t oldest = slots_.size();
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].state == SlotState::Free) {
+                return i;
+            }
+            if (slots_[i].state == SlotState::Ready &&
+                (oldest == slots_.size() || slots_[i].frame.sequence < slots_[oldest].frame.sequence)) {
+                oldest = i;
+            }
+        }
+        ++stats_.dropped;
+        return oldest;
+    }
+
+    void CaptureLoop() {
+        while (running_) {
+            if (source_->Exhausted()) {
+                break;
+            }
+
+            std::size_t slot = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                slot = ClaimWriteSlotLocked();
+                slots_[slot].state = SlotState::Writing;
+            }
+
+            // 读取在锁外进行，推理线程可同时处理其他槽位
+            const bool ok = source_->Read(slots_[slot].frame);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (ok) {
+                    slots_[slot].frame.sequence = ++sequence_;
+                    slots_[slot].frame.captured_at = std::chrono::steady_clock::now();
+                    slots_[slot].state = SlotState::Ready;
+                    ++stats_.captured;
+                    stats_.max_depth = std::max(stats_.max_depth, ReadyCountLocked());
+                } else {
+                    slots_[slot].state = SlotState::Free;
+                    ++stats_.capture_failures;
+                }
+            }
+
+            if (ok) {
+                cv_.notify_one();
+            } else if (!source_->Exhausted()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void Release(std::size_t slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_[slot].state = SlotState::Free;
+    }
+
+    std::unique_ptr<FrameSource> source_;
+    std::vector<Slot> slots_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread capture_thread_;
+    std::atomic<bool> running_{false};
+    bool finished_ = false;
+    std::uint64_t sequence_ = 0;
+    PipelineStats stats_;
+};
+
+const PipelineFrame& FrameLease::frame() const {
+    return owner_->slots_[slot_].frame;
+}
+
+void FrameLease::release() {
+    if (owner_ != nullptr) {
+        owner_->Release(slot_);
+        owner_ = nullptr;
+    }
+}
@@ -0,0 +1,201 @@
+module;
+
+#include <seeta/Common/CStruct.h>
+
+export module frame_pool;
+
+import std;
+
+// 帧缓冲池
+//
+// 摄像头每帧约 1~6 MB，逐帧 new[]/delete[] 会带来持续的分配与缺页开销。
+// 池中缓冲区按 64 字节对齐（便于 SIMD 读写），归还后按容量复用。
+
+export inline constexpr std::size_t kFrameBufferAlignment = 64;
+
+export struct FramePoolStats {
+    std::uint64_t allocations = 0;  // 新分配的缓冲区数
+    std::uint64_t reuses = 0;       // 复用缓存缓冲区的次数
+    std::uint64_t discarded = 0;    // 缓存已满被释放的缓冲区数
+    std::size_t cached = 0;         // 当前缓存中的空闲缓冲区
+    std::size_t outstanding = 0;    // 当前借出的缓冲区
+};
+
+// 以下类型出现在导出类的私有成员中，不能放在匿名命名空间
+namespace frame_pool_detail {
+
+struct AlignedDeleter {
+    void operator()(unsigned char* p) const {
+        ::operator delete[](p, std::align_val_t{kFrameBufferAlignment});
+    }
+};
+
+using AlignedBytes = std::unique_ptr<unsigned char[], AlignedDeleter>;
+
+struct CachedBuffer {
+    AlignedBytes data;
+    std::size_t capacity = 0;
+};
+
+// 池状态由租约共享持有，池对象先于租约析构时缓冲区仍能安全释放
+struct FramePoolState {
+    std::mutex mutex;
+    std::vector<CachedBuffer> free_buffers;
+    std::size_t max_cached = 0;
+    FramePoolStats stats;
+};
+
+} // namespace frame_pool_detail
+
+using frame_pool_detail::AlignedBytes;
+using frame_pool_detail::CachedBuffer;
+using frame_pool_detail::FramePoolState;
+
+// 从池中借出的缓冲区，析构时自动归还
+export class PooledBuffer {
+public:
+    PooledBuffer() = default;
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : state_(std::move(other.state_)), data_(std::move(other.data_)),
+          capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0)) {}
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::move(other.state_);
+            data_ = std::move(other.data_);
+            capacity_ = std::exchange(other.capacity_, 0);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+    ~PooledBuffer() { reset(); }
+
+    unsigned char* data() { return data_.get(); }
+    const unsigned char* data() const { return data_.get(); }
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+    // 归还缓冲区到池中
+    void reset() {
+        if (!data_) {
+            return;
+        }
+        if (auto state = state_.lock()) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            --state->stats.outstanding;
+            if (state->free_buffers.size() < state->max_cached) {
+                state->free_buffers.push_back(CachedBuffer{std::move(data_), capacity_});
+            } else {
+                ++state->stats.discarded;
+            }
+        }
+        data_.reset();
+        capacity_ = 0;
+        size_ = 0;
+    }
+
+private:
+    friend class FramePool;
+    PooledBuffer(std::weak_ptr<FramePoolState> state, AlignedBytes data, std::size_t capacity, std::size_t size)
+        : state_(std::move(state)), data_(std::move(data)), capacity_(capacity), size_(size) {}
+
+    std::weak_ptr<FramePoolState> state_;
+    AlignedBytes data_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+};
+
+export class FramePool {
+public:
+    // max_cached：归还后最多保留的空闲缓冲区数量，应不小于同时在用的帧数
+    explicit FramePool(std::size_t max_cached = 4)
+        : state_(std::make_shared<FramePoolState>()) {
+        state_->max_cached = max_cached;
+    }
+
+    // 借出至少 bytes 字节的缓冲区；优先复用容量足够且最小的空闲缓冲区
+    PooledBuffer Acquire(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto& free_buffers = state_->free_buffers;
+        auto best = free_buffers.end();
+        for (auto it = free_buffers.begin(); it != free_buffers.end(); ++it) {
+            if (it->capacity >= bytes && (best == free_buffers.end() || it->capacity < best->capacity)) {
+                best = it;
+            }
+        }
+
+        ++state_->stats.outstanding;
+        if (best != free_buffers.end()) {
+            CachedBuffer cached = std::move(*best);
+            free_buffers.erase(best);
+            ++state_->stats.reuses;
+            return PooledBuffer(state_, std::move(cached.data), cached.capacity, bytes);
+        }
+
+        // 分辨率变化后旧尺寸的缓冲区不再适用，直接释放
+        if (!free_buffers.empty() && free_buffers.size() >= state_->max_cached) {
+            free_buffers.erase(free_buffers.begin());
+            ++state_->stats.discarded;
+        }
+        ++state_->stats.allocations;
+        AlignedBytes data(static_cast<unsigned char*>(
+            ::operator new[](bytes, std::align_val_t{kFrameBufferAlignment})));
+        return PooledBuffer(state_, std::move(data), bytes, bytes);
+    }
+
+    FramePoolStats Stats() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        FramePoolStats stats = state_->stats;
+        stats.cached = state_->free_buffers.size();
+        return stats;
+    }
+
+private:
+    std::shared_ptr<FramePoolState> state_;
+};
+
+// 池化的 RGB 帧：缓冲区 + 尺寸，view() 得到 SeetaFace 可直接使用的图像
+export struct PooledFrame {
+    PooledBuffer buffer;
+    int width = 0;
+    int height = 0;
+    int channels = 3;
+
+    // 按尺寸从池中借出缓冲区；当前缓冲区容量足够时直接复用，不经过池
+    unsigned char* Prepare(FramePool& pool, int frame_width, int frame_height, int frame_channels) {
+        const std::size_t bytes = static_cast<std::size_t>(frame_width) * frame_height * frame_channels;
+        if (!buffer || buffer.capacity() < bytes) {
+            buffer = pool.Acquire(bytes);
+        }
+        width = frame_width;
+        height = frame_height;
+        channels = frame_channels;
+        return buffer.data();
+    }
+
+    std::size_t bytes() const {
+        return static_cast<std::size_t>(width) * height * channels;
+    }
+
+    bool valid() const {
+        return buffer && width > 0 && height > 0;
+    }
+
+    SeetaImageData view() const {
+        SeetaImageData image{};
+        image.width = width;
+        image.height = height;
+        image.channels = channels;
+        image.data = const_cast<unsigned char*>(buffer.data());
+        return image;
+    }
+
+    void reset() {
+        buffer.reset();
+        width = 0;
+        height = 0;
+    }
+};
@@ -0,0 +1,275 @@
+module;
+
+#include <seeta/Common/CStruct.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <objbase.h>
+#include <wincodec.h>
+#endif
+
+export module image_io;
+
+import std;
+
+// 离线图像读取：用于回放帧源与基准测试，无需摄像头
+// 输出统一为与 CameraCapture 相同的 RGB24 紧凑排列
+
+namespace {
+
+// 跳过 PPM 头部中的空白与 # 注释
+void SkipPpmSeparators(std::istream& in) {
+    while (in) {
+        const int ch = in.peek();
+        if (ch == '#') {
+            std::string comment;
+            std::getline(in, comment);
+        } else if (std::isspace(ch)) {
+            in.get();
+        } else {
+            break;
+        }
+    }
+}
+
+bool ReadPpmInt(std::istream& in, int& value) {
+    SkipPpmSeparators(in);
+    in >> value;
+    return static_cast<bool>(in);
+}
+
+// 小端读取 BMP 头部字段
+std::uint32_t ReadLe(const unsigned char* p, int bytes) {
+    std::uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+std::string LowerExtension(const std::filesystem::path& path) {
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return ext;
+}
+
+} // namespace
+
+export struct RgbImage {
+    std::vector<unsigned char> pixels;
+    int width = 0;
+    int height = 0;
+    int channels = 3;
+
+    SeetaImageData view() const {
+        SeetaImageData image{};
+        image.width = width;
+        image.height = height;
+        image.channels = channels;
+        image.data = const_cast<unsigned char*>(pixels.data());
+        return image;
+    }
+};
+
+// 读取二进制 PPM (P6, maxval 255)
+export bool LoadPpm(const std::filesystem::path& path, RgbImage& image) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[ImageIO] 无法打开文件: " << path.string() << std::endl;
+        return false;
+    }
+
+    char magic[2] = {};
+    in.read(magic, 2);
+    if (magic[0] != 'P' || magic[1] != '6') {
+        std::cerr << "[ImageIO] 仅支持 P6 格式 PPM: " << path.string() << std::endl;
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    int max_value = 0;
+    if (!ReadPpmInt(in, width) || !ReadPpmInt(in, height) || !ReadPpmInt(in, max_value) ||
+        width <= 0 || height <= 0 || max_value != 255) {
+        std::cerr << "[ImageIO] PPM 头部无效: " << path.string() << std::endl;
+        return false;
+    }
+    in.get();  // 头部后紧跟单个空白字符
+
+    const std::size_t bytes = static_cast<std::size_t>(width) * height * 3;
+    image.pixels.resize(bytes);
+    in.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(bytes));
+    if (static_cast<std::size_t>(in.gcount()) != bytes) {
+        std::cerr << "[ImageIO] PPM 像素数据不完整: " << path.string() << std::endl;
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = 3;
+    return true;
+}
+
+export bool SavePpm(const std::filesystem::path& path, const SeetaImageData& image) {
+    if (image.data == nullptr || image.channels != 3 || image.width <= 0 || image.height <= 0) {
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    out << "P6\n" << image.width << " " << image.height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(image.data),
+              static_cast<std::streamsize>(static_cast<std::size_t>(image.width) * image.height * 3));
+    return static_cast<bool>(out);
+}
+
+// 读取未压缩 BMP（24 位 BGR / 32 位 BGRA），支持底向上与顶向下两种行序
+export bool LoadBmp(const std::filesystem::path& path, RgbImage& image) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[ImageIO] 无法打开文件: " << path.string() << std::endl;
+        return false;
+    }
+
+    unsigned char header[54] = {};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (in.gcount() != sizeof(header) || header[0] != 'B' || header[1] != 'M') {
+        std::cerr << "[ImageIO] BMP 头部无效: " << path.string() << std::endl;
+        return false;
+    }
+
+    const std::uint32_t data_offset = ReadLe(header + 10, 4);
+    const int width = static_cast<std::int32_t>(ReadLe(header + 18, 4));
+    const int signed_height = static_cast<std::int32_t>(ReadLe(header + 22, 4));
+    const int bits = static_cast<int>(ReadLe(header + 28, 2));
+    const std::uint32_t compression = ReadLe(header + 30, 4);
+    // BI_RGB = 0；32 位常见 BI_BITFIELDS = 3，按 BGRA 处理
+    if (width <= 0 || signed_height == 0 || (bits != 24 && bits != 32) ||
+        !(compression == 0 || (compression == 3 && bits == 32))) {
+        std::cerr << "[ImageIO] 仅支持未压缩 24/32 位 BMP: " << path.string() << std::endl;
+        return false;
+    }
+
+    const bool bottom_up = signed_height > 0;
+    const int height = bottom_up ? signed_height : -signed_height;
+    const int bytes_per_pixel = bits / 8;
+    const std::size_t row_stride = (static_cast<std::size_t>(width) * bytes_per_pixel + 3) & ~static_cast<std::size_t>(3);
+    std::vector<unsigned char> raw(row_stride * height);
+    in.seekg(data_offset);
+    in.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()));
+    if (static_cast<std::size_t>(in.gcount()) != raw.size()) {
+        std::cerr << "[ImageIO] BMP 像素数据不完整: " << path.string() << std::endl;
+        return false;
+    }
+
+    image.pixels.resize(static_cast<std::size_t>(width) * height * 3);
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* src = raw.data() + row_stride * (bottom_up ? height - 1 - y : y);
+        unsigned char* dst = image.pixels.data() + static_cast<std::size_t>(y) * width * 3;
+        for (int x = 0; x < width; ++x) {
+            dst[x * 3] = src[x * bytes_per_pixel + 2];
+            dst[x * 3 + 1] = src[x * bytes_per_pixel + 1];
+            dst[x * 3 + 2] = src[x * bytes_per_pixel];
+        }
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = 3;
+    return true;
+}
+
+#if defined(_WIN32)
+// 通过 WIC 解码 JPEG / PNG（批量录入的证件照通常为 JPEG），可在任意线程调用
+export bool LoadWicImage(const std::filesystem::path& path, RgbImage& image) {
+    const HRESULT init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(init) && init != RPC_E_CHANGED_MODE) {
+        std::cerr << "[ImageIO] COM 初始化失败: " << path.string() << std::endl;
+        return false;
+    }
+
+    IWICImagingFactory* factory = nullptr;
+    IWICBitmapDecoder* decoder = nullptr;
+    IWICBitmapFrameDecode* frame = nullptr;
+    IWICFormatConverter* converter = nullptr;
+    UINT width = 0;
+    UINT height = 0;
+    HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+    if (SUCCEEDED(hr)) {
+        hr = factory->CreateDecoderFromFilename(path.wstring().c_str(), nullptr, GENERIC_READ,
+                                                WICDecodeMetadataCacheOnDemand, &decoder);
+    }
+    if (SUCCEEDED(hr)) hr = decoder->GetFrame(0, &frame);
+    if (SUCCEEDED(hr)) hr = factory->CreateFormatConverter(&converter);
+    if (SUCCEEDED(hr)) {
+        hr = converter->Initialize(frame, GUID_WICPixelFormat24bppRGB, WICBitmapDitherTypeNone,
+                                   nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    }
+    if (SUCCEEDED(hr)) hr = converter->GetSize(&width, &height);
+    if (SUCCEEDED(hr) && (width == 0 || height == 0)) hr = E_FAIL;
+    if (SUCCEEDED(hr)) {
+        const UINT stride = width * 3;
+        image.pixels.resize(static_cast<std::size_t>(stride) * height);
+        hr = converter->CopyPixels(nullptr, stride, static_cast<UINT>(image.pixels.size()), image.pixels.data());
+    }
+
+    if (converter) converter->Release();
+    if (frame) frame->Release();
+    if (decoder) decoder->Release();
+    if (factory) factory->Release();
+    if (SUCCEEDED(init)) CoUninitialize();
+
+    if (FAILED(hr)) {
+        std::cerr << "[ImageIO] WIC 解码失败 (hr=0x" << std::hex << static_cast<unsigned long>(hr) << std::dec
+                  << "): " << path.string() << std::endl;
+        return false;
+    }
+    image.width = static_cast<int>(width);
+    image.height = static_cast<int>(height);
+    image.channels = 3;
+    return true;
+}
+#endif
+
+// 按扩展名读取图像
+export bool LoadImageFile(const std::filesystem::path& path, RgbImage& image) {
+    const auto ext = LowerExtension(path);
+    if (ext == ".ppm") {
+        return LoadPpm(path, image);
+    }
+    if (ext == ".bmp") {
+        return LoadBmp(path, image);
+    }
+#if defined(_WIN32)
+    if (ext == ".jpg" || ext == ".jpeg" || ext == ".png") {
+        return LoadWicImage(path, image);
+    }
+#endif
+    std::cerr << "[ImageIO] 不支持的图像格式: " << path.string() << std::endl;
+    return false;
+}
+
+export bool IsSupportedImageFile(const std::filesystem::path& path) {
+    const auto ext = LowerExtension(path);
+#if defined(_WIN32)
+    if (ext == ".jpg" || ext == ".jpeg" || ext == ".png") {
+        return true;
+    }
+#endif
+    return ext == ".ppm" || ext == ".bmp";
+}
+
+// 列出目录下所有支持的图像文件（按文件名排序，保证回放顺序稳定）
+export std::vector<std::filesystem::path> ListImageFiles(const std::filesystem::path& directory) {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && IsSupportedImageFile(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
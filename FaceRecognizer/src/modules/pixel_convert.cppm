@@ -0,0 +1,813 @@
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PIXEL_CONVERT_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PIXEL_CONVERT_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集；MSVC 允许直接使用内建函数
+#if defined(PIXEL_CONVERT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PIXEL_CONVERT_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define PIXEL_CONVERT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PIXEL_CONVERT_TARGET_SSSE3
+#define PIXEL_CONVERT_TARGET_AVX2
+#endif
+
+export module pixel_convert;
+
+import std;
+import cpu_features;
+
+// 摄像头像素格式 -> RGB24 单遍转换内核
+//
+// YUV 输入直接写出 RGB24，不再经过 ARGB 中间缓冲；BGR24/BGRA32 只做通道重排（可选上下翻转）。
+// YUV 系数为 BT.601 有限范围（与 libyuv YUY2ToARGB/NV12ToARGB 一致），8 位定点：
+//   R = 1.164(Y-16) + 1.596(V-128)                  = (298(Y-16) + 409(V-128) + 128) >> 8
+//   G = 1.164(Y-16) - 0.391(U-128) - 0.813(V-128)   = (298(Y-16) - 100(U-128) - 208(V-128) + 128) >> 8
+//   B = 1.164(Y-16) + 2.018(U-128)                  = (298(Y-16) + 516(U-128) + 128) >> 8
+// Y=235 / Y=16 的灰色精确映射到 255 / 0。所有 SIMD 实现与标量实现逐位一致。
+//
+// 另提供 RGB24 缩小（供缩放检测使用）：2:1 为 2x2 均值，其余比例为 6 位权重的双线性插值；
+// 以及 RGB24 -> 亮度（BT.601 全范围，Y = (77R + 150G + 29B + 128) >> 8），供质量评估等灰度分析使用。
+
+export enum class ConvertIsa {
+    Auto,
+    Scalar,
+    SSSE3,
+    AVX2,
+    NEON,
+};
+
+namespace {
+
+using RowFnYuy2 = void (*)(const std::uint8_t* src, std::uint8_t* dst, int width);
+using RowFnNv12 = void (*)(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int width);
+using RowFnPacked = void (*)(const std::uint8_t* src, std::uint8_t* dst, int width);
+// 两行源像素 -> 一行输出：2:1 缩小时 width 为输出像素数；垂直插值时 width 为字节数
+using RowFnHalve = void (*)(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int width);
+using RowFnBlend = void (*)(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int bytes, int weight);
+using RowFnLuma = void (*)(const std::uint8_t* src, std::uint8_t* dst, int width);
+
+struct ConvertKernels {
+    ConvertIsa isa;
+    const char* name;
+    RowFnYuy2 yuy2;
+    RowFnNv12 nv12;
+    RowFnPacked bgr24;
+    RowFnPacked bgra32;
+    RowFnHalve halve_rgb24;
+    RowFnBlend blend_rows;
+    RowFnLuma luma;
+};
+
+constexpr int kYuvBits = 8;
+constexpr int kYScale = 298;  // 1.164 * 256
+constexpr int kVToR = 409;    // 1.596 * 256
+constexpr int kUToG = 100;    // 0.391 * 256
+constexpr int kVToG = 208;    // 0.813 * 256
+constexpr int kUToB = 516;    // 2.018 * 256
+constexpr int kRound = 1 << (kYuvBits - 1);
+// SIMD 在 int16 中计算：各系数拆成 256 的整数倍与余数，整数倍部分不经移位直接相加，
+// 只有余数部分的和（不超出 int16）右移 8 位，结果与标量的 32 位计算逐位一致：
+//   R = (Y' + V') + ((42Y' + 153V' + 128) >> 8)
+//   G = (Y' - V') + ((42Y' - 100U' + 48V' + 128) >> 8)
+//   B = (Y' + 2U') + ((42Y' + 4U' + 128) >> 8)
+// 其中 Y' = Y-16, U' = U-128, V' = V-128
+constexpr int kYScaleRem = kYScale - 256;   // 42
+constexpr int kVToRRem = kVToR - 256;       // 153
+constexpr int kVToGRem = 256 - kVToG;       // 48
+constexpr int kUToBRem = kUToB - 512;       // 4
+constexpr int kBlendBits = 6;                  // 缩放插值权重精度
+constexpr int kBlendOne = 1 << kBlendBits;
+constexpr int kLumaR = 77;    // 0.299 * 256
+constexpr int kLumaG = 150;   // 0.587 * 256
+constexpr int kLumaB = 29;    // 0.114 * 256
+
+// ---------------------------------------------------------------- 标量实现
+
+inline std::uint8_t Clamp8(int value) {
+    return static_cast<std::uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+inline void YuvPixel(int y, int u, int v, std::uint8_t* rgb) {
+    const int yy = (y - 16) * kYScale + kRound;
+    const int uu = u - 128;
+    const int vv = v - 128;
+    rgb[0] = Clamp8((yy + kVToR * vv) >> kYuvBits);
+    rgb[1] = Clamp8((yy - kUToG * uu - kVToG * vv) >> kYuvBits);
+    rgb[2] = Clamp8((yy + kUToB * uu) >> kYuvBits);
+}
+
+// 以下标量行函数从 begin 开始处理，兼作 SIMD 实现的尾部
+void Yuy2RowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const std::uint8_t* pair = src + (x / 2) * 4;
+        YuvPixel(src[x * 2], pair[1], pair[3], dst + x * 3);
+    }
+}
+
+void Nv12RowScalarFrom(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const std::uint8_t* pair = uv + (x / 2) * 2;
+        YuvPixel(y[x], pair[0], pair[1], dst + x * 3);
+    }
+}
+
+void Bgr24RowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        dst[x * 3] = src[x * 3 + 2];
+        dst[x * 3 + 1] = src[x * 3 + 1];
+        dst[x * 3 + 2] = src[x * 3];
+    }
+}
+
+void Bgra32RowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        dst[x * 3] = src[x * 4 + 2];
+        dst[x * 3 + 1] = src[x * 4 + 1];
+        dst[x * 3 + 2] = src[x * 4];
+    }
+}
+
+inline std::uint8_t Avg2(int a, int b) {
+    return static_cast<std::uint8_t>((a + b + 1) >> 1);
+}
+
+// 2x2 均值：先垂直再水平两次四舍五入平均（与 SIMD 的 avg 指令一致）
+void HalveRgb24RowScalarFrom(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst,
+                             int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const std::uint8_t* a = row0 + x * 6;
+        const std::uint8_t* b = row1 + x * 6;
+        for (int c = 0; c < 3; ++c) {
+            dst[x * 3 + c] = Avg2(Avg2(a[c], b[c]), Avg2(a[c + 3], b[c + 3]));
+        }
+    }
+}
+
+void BlendRowsScalarFrom(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst,
+                         int begin, int bytes, int weight) {
+    const int inverse = kBlendOne - weight;
+    for (int i = begin; i < bytes; ++i) {
+        dst[i] = static_cast<std::uint8_t>((row0[i] * inverse + row1[i] * weight + kBlendOne / 2) >> kBlendBits);
+    }
+}
+
+void LumaRowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const std::uint8_t* p = src + x * 3;
+        dst[x] = static_cast<std::uint8_t>((p[0] * kLumaR + p[1] * kLumaG + p[2] * kLumaB + 128) >> 8);
+    }
+}
+
+void Yuy2RowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    Yuy2RowScalarFrom(src, dst, 0, width);
+}
+
+void Nv12RowScalar(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int width) {
+    Nv12RowScalarFrom(y, uv, dst, 0, width);
+}
+
+void Bgr24RowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    Bgr24RowScalarFrom(src, dst, 0, width);
+}
+
+void Bgra32RowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    Bgra32RowScalarFrom(src, dst, 0, width);
+}
+
+void HalveRgb24RowScalar(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int width) {
+    HalveRgb24RowScalarFrom(row0, row1, dst, 0, width);
+}
+
+void BlendRowsScalar(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int bytes, int weight) {
+    BlendRowsScalarFrom(row0, row1, dst, 0, bytes, weight);
+}
+
+void LumaRowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    LumaRowScalarFrom(src, dst, 0, width);
+}
+
+constexpr ConvertKernels kScalarKernels{
+    ConvertIsa::Scalar, "scalar", Yuy2RowScalar, Nv12RowScalar, Bgr24RowScalar, Bgra32RowScalar,
+    HalveRgb24RowScalar, BlendRowsScalar, LumaRowScalar};
+
+// ---------------------------------------------------------------- SSSE3 / AVX2
+
+#if defined(PIXEL_CONVERT_X86)
+
+// 8 个像素的 Y/U/V（int16）-> R/G/B（int16，未钳位）
+PIXEL_CONVERT_TARGET_SSSE3
+inline void YuvToRgb16Ssse3(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b) {
+    y = _mm_sub_epi16(y, _mm_set1_epi16(16));
+    u = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    v = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i yy = _mm_add_epi16(_mm_mullo_epi16(y, _mm_set1_epi16(kYScaleRem)), _mm_set1_epi16(kRound));
+    r = _mm_add_epi16(_mm_add_epi16(y, v),
+                      _mm_srai_epi16(_mm_add_epi16(yy, _mm_mullo_epi16(v, _mm_set1_epi16(kVToRRem))), kYuvBits));
+    g = _mm_add_epi16(_mm_sub_epi16(y, v),
+                      _mm_srai_epi16(_mm_add_epi16(_mm_sub_epi16(yy, _mm_mullo_epi16(u, _mm_set1_epi16(kUToG))),
+                                                   _mm_mullo_epi16(v, _mm_set1_epi16(kVToGRem))), kYuvBits));
+    b = _mm_add_epi16(_mm_add_epi16(y, _mm_add_epi16(u, u)),
+                      _mm_srai_epi16(_mm_add_epi16(yy, _mm_mullo_epi16(u, _mm_set1_epi16(kUToBRem))), kYuvBits));
+}
+
+// 交错的 U/V（int16，每对对应两个像素）展开为逐像素 U、V
+PIXEL_CONVERT_TARGET_SSSE3
+inline void SplitUvSsse3(__m128i uv, __m128i& u, __m128i& v) {
+    u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+// 4 个寄存器各含 12 个有效字节（末 4 字节为 0），拼接为连续 48 字节写出
+PIXEL_CONVERT_TARGET_SSSE3
+inline void Store48Ssse3(__m128i c0, __m128i c1, __m128i c2, __m128i c3, std::uint8_t* dst) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_or_si128(c0, _mm_slli_si128(c1, 12)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     _mm_or_si128(_mm_srli_si128(c1, 4), _mm_slli_si128(c2, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32),
+                     _mm_or_si128(_mm_srli_si128(c2, 8), _mm_slli_si128(c3, 4)));
+}
+
+// 16 个像素的平面 R/G/B（uint8）交错写出为 RGB24
+PIXEL_CONVERT_TARGET_SSSE3
+inline void StoreRgb48Ssse3(__m128i r, __m128i g, __m128i b, std::uint8_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i compact = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+    const __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+    const __m128i bz_lo = _mm_unpacklo_epi8(b, zero);
+    const __m128i bz_hi = _mm_unpackhi_epi8(b, zero);
+    Store48Ssse3(_mm_shuffle_epi8(_mm_unpacklo_epi16(rg_lo, bz_lo), compact),
+                 _mm_shuffle_epi8(_mm_unpackhi_epi16(rg_lo, bz_lo), compact),
+                 _mm_shuffle_epi8(_mm_unpacklo_epi16(rg_hi, bz_hi), compact),
+                 _mm_shuffle_epi8(_mm_unpackhi_epi16(rg_hi, bz_hi), compact),
+                 dst);
+}
+
+PIXEL_CONVERT_TARGET_SSSE3
+void Yuy2RowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m128i low_byte = _mm_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+        const __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2 + 16));
+        __m128i u0, v0, u1, v1;
+        SplitUvSsse3(_mm_srli_epi16(s0, 8), u0, v0);
+        SplitUvSsse3(_mm_srli_epi16(s1, 8), u1, v1);
+        __m128i r0, g0, b0, r1, g1, b1;
+        YuvToRgb16Ssse3(_mm_and_si128(s0, low_byte), u0, v0, r0, g0, b0);
+        YuvToRgb16Ssse3(_mm_and_si128(s1, low_byte), u1, v1, r1, g1, b1);
+        StoreRgb48Ssse3(_mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1),
+                        _mm_packus_epi16(b0, b1), dst + x * 3);
+    }
+    Yuy2RowScalarFrom(src, dst, x, width);
+}
+
+PIXEL_CONVERT_TARGET_SSSE3
+void Nv12RowSsse3(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i yv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        const __m128i uvv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x));
+        __m128i u0, v0, u1, v1;
+        SplitUvSsse3(_mm_unpacklo_epi8(uvv, zero), u0, v0);
+        SplitUvSsse3(_mm_unpackhi_epi8(uvv, zero), u1, v1);
+        __m128i r0, g0, b0, r1, g1, b1;
+        YuvToRgb16Ssse3(_mm_unpacklo_epi8(yv, zero), u0, v0, r0, g0, b0);
+        YuvToRgb16Ssse3(_mm_unpackhi_epi8(yv, zero), u1, v1, r1, g1, b1);
+        StoreRgb48Ssse3(_mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1),
+                        _mm_packus_epi16(b0, b1), dst + x * 3);
+    }
+    Nv12RowScalarFrom(y, uv, dst, x, width);
+}
+
+PIXEL_CONVERT_TARGET_SSSE3
+void Bgr24RowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m128i swap = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1);
+    int x = 0;
+    // 每次以 12 字节步长读取 16 字节，最后一次读取越过 48 字节 4 字节，需留出两个像素余量
+    for (; x + 18 <= width; x += 16) {
+        const std::uint8_t* s = src + x * 3;
+        Store48Ssse3(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 12)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 24)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 36)), swap),
+                     dst + x * 3);
+    }
+    Bgr24RowScalarFrom(src, dst, x, width);
+}
+
+PIXEL_CONVERT_TARGET_SSSE3
+void Bgra32RowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m128i swap = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const std::uint8_t* s = src + x * 4;
+        Store48Ssse3(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32)), swap),
+                     _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48)), swap),
+                     dst + x * 3);
+    }
+    Bgra32RowScalarFrom(src, dst, x, width);
+}
+
+// 每次输出 4 个像素：lo/hi 分别覆盖源像素 0~5 与 2.67~7.33，共读取 24 字节，不越界
+PIXEL_CONVERT_TARGET_SSSE3
+void HalveRgb24RowSsse3(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int width) {
+    const __m128i even_lo = _mm_setr_epi8(0, 1, 2, 6, 7, 8, 12, 13, 14, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i even_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, 10, 11, 12, -1, -1, -1, -1);
+    const __m128i odd_lo = _mm_setr_epi8(3, 4, 5, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i odd_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 7, 8, 9, 13, 14, 15, -1, -1, -1, -1);
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const std::uint8_t* a = row0 + x * 6;
+        const std::uint8_t* b = row1 + x * 6;
+        const __m128i lo = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        const __m128i hi = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 8)),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 8)));
+        const __m128i even = _mm_or_si128(_mm_shuffle_epi8(lo, even_lo), _mm_shuffle_epi8(hi, even_hi));
+        const __m128i odd = _mm_or_si128(_mm_shuffle_epi8(lo, odd_lo), _mm_shuffle_epi8(hi, odd_hi));
+        const __m128i out = _mm_avg_epu8(even, odd);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 3), out);
+        const std::uint32_t tail = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(out, 8)));
+        std::memcpy(dst + x * 3 + 8, &tail, sizeof(tail));
+    }
+    HalveRgb24RowScalarFrom(row0, row1, dst, x, width);
+}
+
+// (a * (64 - w) + b * w + 32) >> 6：交错 a/b 字节后用 maddubs 一次完成两项乘加
+PIXEL_CONVERT_TARGET_SSSE3
+void BlendRowsSsse3(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int bytes, int weight) {
+    const __m128i weights = _mm_set1_epi16(static_cast<short>((weight << 8) | (kBlendOne - weight)));
+    const __m128i round = _mm_set1_epi16(kBlendOne / 2);
+    int i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+        const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_maddubs_epi16(_mm_unpacklo_epi8(a, b), weights), round), kBlendBits);
+        const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_maddubs_epi16(_mm_unpackhi_epi8(a, b), weights), round), kBlendBits);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    BlendRowsScalarFrom(row0, row1, dst, i, bytes, weight);
+}
+
+// 每次 16 个像素：三次读取各经 pshufb 收集 R/G/B 字节，再按 16 位定点加权
+// （加权和最大 65280，按无符号 16 位处理不会溢出）
+PIXEL_CONVERT_TARGET_SSSE3
+void LumaRowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m128i r0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i b0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+    const __m128i wr = _mm_set1_epi16(kLumaR);
+    const __m128i wg = _mm_set1_epi16(kLumaG);
+    const __m128i wb = _mm_set1_epi16(kLumaB);
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i zero = _mm_setzero_si128();
+
+    auto weigh = [&](__m128i r, __m128i g, __m128i b) {
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, wr), _mm_mullo_epi16(g, wg));
+        sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, wb));
+        return _mm_srli_epi16(_mm_add_epi16(sum, round), 8);
+    };
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const std::uint8_t* s = src + x * 3;
+        const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+        const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+        const __m128i r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, r0), _mm_shuffle_epi8(c1, r1)), _mm_shuffle_epi8(c2, r2));
+        const __m128i g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, g0), _mm_shuffle_epi8(c1, g1)), _mm_shuffle_epi8(c2, g2));
+        const __m128i b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(c0, b0), _mm_shuffle_epi8(c1, b1)), _mm_shuffle_epi8(c2, b2));
+        const __m128i lo = weigh(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(b, zero));
+        const __m128i hi = weigh(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(b, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+    LumaRowScalarFrom(src, dst, x, width);
+}
+
+// 16 个像素的 Y/U/V（int16）-> R/G/B（int16）
+PIXEL_CONVERT_TARGET_AVX2
+inline void YuvToRgb16Avx2(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b) {
+    y = _mm256_sub_epi16(y, _mm256_set1_epi16(16));
+    u = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+    v = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+    const __m256i yy = _mm256_add_epi16(_mm256_mullo_epi16(y, _mm256_set1_epi16(kYScaleRem)), _mm256_set1_epi16(kRound));
+    r = _mm256_add_epi16(_mm256_add_epi16(y, v),
+                         _mm256_srai_epi16(_mm256_add_epi16(yy, _mm256_mullo_epi16(v, _mm256_set1_epi16(kVToRRem))),
+                                           kYuvBits));
+    g = _mm256_add_epi16(_mm256_sub_epi16(y, v),
+                         _mm256_srai_epi16(_mm256_add_epi16(_mm256_sub_epi16(yy, _mm256_mullo_epi16(u, _mm256_set1_epi16(kUToG))),
+                                                            _mm256_mullo_epi16(v, _mm256_set1_epi16(kVToGRem))),
+                                           kYuvBits));
+    b = _mm256_add_epi16(_mm256_add_epi16(y, _mm256_add_epi16(u, u)),
+                         _mm256_srai_epi16(_mm256_add_epi16(yy, _mm256_mullo_epi16(u, _mm256_set1_epi16(kUToBRem))),
+                                           kYuvBits));
+}
+
+PIXEL_CONVERT_TARGET_AVX2
+inline void SplitUvAvx2(__m256i uv, __m256i& u, __m256i& v) {
+    u = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+    v = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+// 两组 16 像素 int16 结果压缩为 32 个 uint8（packus 按 128 位通道交错，需重排）
+PIXEL_CONVERT_TARGET_AVX2
+inline __m256i Pack32Avx2(__m256i lo, __m256i hi) {
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+PIXEL_CONVERT_TARGET_AVX2
+inline void StoreRgb96Avx2(__m256i r, __m256i g, __m256i b, std::uint8_t* dst) {
+    StoreRgb48Ssse3(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), dst);
+    StoreRgb48Ssse3(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+                    _mm256_extracti128_si256(b, 1), dst + 48);
+}
+
+PIXEL_CONVERT_TARGET_AVX2
+void Yuy2RowAvx2(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m256i low_byte = _mm256_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2));
+        const __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 2 + 32));
+        __m256i u0, v0, u1, v1;
+        SplitUvAvx2(_mm256_srli_epi16(s0, 8), u0, v0);
+        SplitUvAvx2(_mm256_srli_epi16(s1, 8), u1, v1);
+        __m256i r0, g0, b0, r1, g1, b1;
+        YuvToRgb16Avx2(_mm256_and_si256(s0, low_byte), u0, v0, r0, g0, b0);
+        YuvToRgb16Avx2(_mm256_and_si256(s1, low_byte), u1, v1, r1, g1, b1);
+        StoreRgb96Avx2(Pack32Avx2(r0, r1), Pack32Avx2(g0, g1), Pack32Avx2(b0, b1), dst + x * 3);
+    }
+    Yuy2RowSsse3(src + x * 2, dst + x * 3, width - x);
+}
+
+PIXEL_CONVERT_TARGET_AVX2
+void Nv12RowAvx2(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const __m256i yv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + x));
+        const __m256i uvv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + x));
+        __m256i u0, v0, u1, v1;
+        SplitUvAvx2(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(uvv)), u0, v0);
+        SplitUvAvx2(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(uvv, 1)), u1, v1);
+        __m256i r0, g0, b0, r1, g1, b1;
+        YuvToRgb16Avx2(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(yv)), u0, v0, r0, g0, b0);
+        YuvToRgb16Avx2(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(yv, 1)), u1, v1, r1, g1, b1);
+        StoreRgb96Avx2(Pack32Avx2(r0, r1), Pack32Avx2(g0, g1), Pack32Avx2(b0, b1), dst + x * 3);
+    }
+    Nv12RowSsse3(y + x, uv + x, dst + x * 3, width - x);
+}
+
+PIXEL_CONVERT_TARGET_AVX2
+void Bgra32RowAvx2(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m256i swap = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(s, swap), compact);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 3), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 3 + 16), _mm256_extracti128_si256(packed, 1));
+    }
+    Bgra32RowScalarFrom(src, dst, x, width);
+}
+
+// BGR24 重排与缩放受内存带宽限制，AVX2 下沿用 SSSE3 实现
+constexpr ConvertKernels kSsse3Kernels{
+    ConvertIsa::SSSE3, "ssse3", Yuy2RowSsse3, Nv12RowSsse3, Bgr24RowSsse3, Bgra32RowSsse3,
+    HalveRgb24RowSsse3, BlendRowsSsse3, LumaRowSsse3};
+constexpr ConvertKernels kAvx2Kernels{
+    ConvertIsa::AVX2, "avx2", Yuy2RowAvx2, Nv12RowAvx2, Bgr24RowSsse3, Bgra32RowAvx2,
+    HalveRgb24RowSsse3, BlendRowsSsse3, LumaRowSsse3};
+
+#endif // PIXEL_CONVERT_X86
+
+// ---------------------------------------------------------------- NEON
+
+#if defined(PIXEL_CONVERT_NEON)
+
+// 偶数 / 奇数像素的 Y 与共享的 U/V（各 8 个）-> 16 个像素 RGB24
+inline void YuvToRgb48Neon(uint8x8_t y_even, uint8x8_t y_odd, uint8x8_t u8, uint8x8_t v8, std::uint8_t* dst) {
+    const int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), vdupq_n_s16(128));
+    const int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), vdupq_n_s16(128));
+    // 色度项由偶数 / 奇数像素共用：256 整数倍部分与余数部分分别预先算好
+    const int16x8_t r_whole = v;
+    const int16x8_t g_whole = vnegq_s16(v);
+    const int16x8_t b_whole = vaddq_s16(u, u);
+    const int16x8_t r_rem = vmulq_n_s16(v, kVToRRem);
+    const int16x8_t g_rem = vsubq_s16(vmulq_n_s16(v, kVToGRem), vmulq_n_s16(u, kUToG));
+    const int16x8_t b_rem = vmulq_n_s16(u, kUToBRem);
+
+    auto convert = [&](uint8x8_t y8, uint8x8_t& r, uint8x8_t& g, uint8x8_t& b) {
+        const int16x8_t y = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), vdupq_n_s16(16));
+        const int16x8_t yy = vaddq_s16(vmulq_n_s16(y, kYScaleRem), vdupq_n_s16(kRound));
+        r = vqmovun_s16(vaddq_s16(vaddq_s16(y, r_whole), vshrq_n_s16(vaddq_s16(yy, r_rem), kYuvBits)));
+        g = vqmovun_s16(vaddq_s16(vaddq_s16(y, g_whole), vshrq_n_s16(vaddq_s16(yy, g_rem), kYuvBits)));
+        b = vqmovun_s16(vaddq_s16(vaddq_s16(y, b_whole), vshrq_n_s16(vaddq_s16(yy, b_rem), kYuvBits)));
+    };
+
+    uint8x8_t r_even, g_even, b_even, r_odd, g_odd, b_odd;
+    convert(y_even, r_even, g_even, b_even);
+    convert(y_odd, r_odd, g_odd, b_odd);
+
+    const uint8x8x2_t r = vzip_u8(r_even, r_odd);
+    const uint8x8x2_t g = vzip_u8(g_even, g_odd);
+    const uint8x8x2_t b = vzip_u8(b_even, b_odd);
+    uint8x16x3_t rgb;
+    rgb.val[0] = vcombine_u8(r.val[0], r.val[1]);
+    rgb.val[1] = vcombine_u8(g.val[0], g.val[1]);
+    rgb.val[2] = vcombine_u8(b.val[0], b.val[1]);
+    vst3q_u8(dst, rgb);
+}
+
+void Yuy2RowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x8x4_t p = vld4_u8(src + x * 2);  // Y0 U Y1 V
+        YuvToRgb48Neon(p.val[0], p.val[2], p.val[1], p.val[3], dst + x * 3);
+    }
+    Yuy2RowScalarFrom(src, dst, x, width);
+}
+
+void Nv12RowNeon(const std::uint8_t* y, const std::uint8_t* uv, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x8x2_t yp = vld2_u8(y + x);
+        const uint8x8x2_t uvp = vld2_u8(uv + x);
+        YuvToRgb48Neon(yp.val[0], yp.val[1], uvp.val[0], uvp.val[1], dst + x * 3);
+    }
+    Nv12RowScalarFrom(y, uv, dst, x, width);
+}
+
+void Bgr24RowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x3_t p = vld3q_u8(src + x * 3);
+        const uint8x16_t blue = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = blue;
+        vst3q_u8(dst + x * 3, p);
+    }
+    Bgr24RowScalarFrom(src, dst, x, width);
+}
+
+void Bgra32RowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16x4_t p = vld4q_u8(src + x * 4);
+        uint8x16x3_t rgb;
+        rgb.val[0] = p.val[2];
+        rgb.val[1] = p.val[1];
+        rgb.val[2] = p.val[0];
+        vst3q_u8(dst + x * 3, rgb);
+    }
+    Bgra32RowScalarFrom(src, dst, x, width);
+}
+
+// 每次输出 16 个像素：按通道解交错后先垂直平均，再用 uzp 拆出偶 / 奇像素水平平均
+void HalveRgb24RowNeon(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const std::uint8_t* a = row0 + x * 6;
+        const std::uint8_t* b = row1 + x * 6;
+        const uint8x16x3_t a0 = vld3q_u8(a);
+        const uint8x16x3_t a1 = vld3q_u8(a + 48);
+        const uint8x16x3_t b0 = vld3q_u8(b);
+        const uint8x16x3_t b1 = vld3q_u8(b + 48);
+        uint8x16x3_t out;
+        for (int c = 0; c < 3; ++c) {
+            const uint8x16_t v0 = vrhaddq_u8(a0.val[c], b0.val[c]);
+            const uint8x16_t v1 = vrhaddq_u8(a1.val[c], b1.val[c]);
+            out.val[c] = vrhaddq_u8(vuzp1q_u8(v0, v1), vuzp2q_u8(v0, v1));
+        }
+        vst3q_u8(dst + x * 3, out);
+    }
+    HalveRgb24RowScalarFrom(row0, row1, dst, x, width);
+}
+
+void BlendRowsNeon(const std::uint8_t* row0, const std::uint8_t* row1, std::uint8_t* dst, int bytes, int weight) {
+    const uint8x8_t w0 = vdup_n_u8(static_cast<std::uint8_t>(kBlendOne - weight));
+    const uint8x8_t w1 = vdup_n_u8(static_cast<std::uint8_t>(weight));
+    int i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16_t a = vld1q_u8(row0 + i);
+        const uint8x16_t b = vld1q_u8(row1 + i);
+        const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), w0), vget_low_u8(b), w1);
+        const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), w0), vget_high_u8(b), w1);
+        vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, kBlendBits), vrshrn_n_u16(hi, kBlendBits)));
+    }
+    BlendRowsScalarFrom(row0, row1, dst, i, bytes, weight);
+}
+
+void LumaRowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const uint8x8_t wr = vdup_n_u8(kLumaR);
+    const uint8x8_t wg = vdup_n_u8(kLumaG);
+    const uint8x8_t wb = vdup_n_u8(kLumaB);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16x3_t p = vld3q_u8(src + x * 3);
+        uint16x8_t lo = vmull_u8(vget_low_u8(p.val[0]), wr);
+        lo = vmlal_u8(lo, vget_low_u8(p.val[1]), wg);
+        lo = vmlal_u8(lo, vget_low_u8(p.val[2]), wb);
+        uint16x8_t hi = vmull_u8(vget_high_u8(p.val[0]), wr);
+        hi = vmlal_u8(hi, vget_high_u8(p.val[1]), wg);
+        hi = vmlal_u8(hi, vget_high_u8(p.val[2]), wb);
+        vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+    }
+    LumaRowScalarFrom(src, dst, x, width);
+}
+
+constexpr ConvertKernels kNeonKernels{
+    ConvertIsa::NEON, "neon", Yuy2RowNeon, Nv12RowNeon, Bgr24RowNeon, Bgra32RowNeon,
+    HalveRgb24RowNeon, BlendRowsNeon, LumaRowNeon};
+
+#endif // PIXEL_CONVERT_NEON
+
+const ConvertKernels* ResolveKernels(ConvertIsa isa) {
+    const auto& cpu = smile2unlock::cpu::GetCpuFeatures();
+#if defined(PIXEL_CONVERT_X86)
+    if ((isa == ConvertIsa::Auto || isa == ConvertIsa::AVX2) && cpu.avx2) return &kAvx2Kernels;
+    if ((isa == ConvertIsa::Auto || isa == ConvertIsa::SSSE3 || isa == ConvertIsa::AVX2) && cpu.ssse3) {
+        return &kSsse3Kernels;
+    }
+#elif defined(PIXEL_CONVERT_NEON)
+    if ((isa == ConvertIsa::Auto || isa == ConvertIsa::NEON) && cpu.neon) return &kNeonKernels;
+#endif
+    (void)cpu;
+    return &kScalarKernels;
+}
+
+std::atomic<const ConvertKernels*>& ActiveKernelsSlot() {
+    static std::atomic<const ConvertKernels*> active{ResolveKernels(ConvertIsa::Auto)};
+    return active;
+}
+
+const ConvertKernels& ActiveKernels() {
+    return *ActiveKernelsSlot().load(std::memory_order_relaxed);
+}
+
+bool ValidArgs(const void* src, const void* dst, int width, int height) {
+    return src != nullptr && dst != nullptr && width > 0 && height > 0;
+}
+
+} // namespace
+
+// 选择转换实现；请求的指令集不可用时回退到可用的最佳实现。返回实际生效的指令集
+export ConvertIsa SetConvertIsa(ConvertIsa isa) {
+    const ConvertKernels* kernels = ResolveKernels(isa);
+    ActiveKernelsSlot().store(kernels, std::memory_order_relaxed);
+    return kernels->isa;
+}
+
+export ConvertIsa ActiveConvertIsa() {
+    return ActiveKernels().isa;
+}
+
+export const char* ActiveConvertIsaName() {
+    return ActiveKernels().name;
+}
+
+// YUY2 (Y0 U Y1 V) -> RGB24
+export bool ConvertYuy2ToRgb24(const std::uint8_t* src, int src_stride,
+                               std::uint8_t* dst, int dst_stride, int width, int height) {
+    if (!ValidArgs(src, dst, width, height)) return false;
+    const auto row = ActiveKernels().yuy2;
+    for (int y = 0; y < height; ++y) {
+        row(src + static_cast<std::ptrdiff_t>(y) * src_stride, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+// NV12 (Y 平面 + 交错 UV 平面，4:2:0) -> RGB24
+export bool ConvertNv12ToRgb24(const std::uint8_t* src_y, int y_stride,
+                               const std::uint8_t* src_uv, int uv_stride,
+                               std::uint8_t* dst, int dst_stride, int width, int height) {
+    if (!ValidArgs(src_y, dst, width, height) || src_uv == nullptr) return false;
+    const auto row = ActiveKernels().nv12;
+    for (int y = 0; y < height; ++y) {
+        row(src_y + static_cast<std::ptrdiff_t>(y) * y_stride,
+            src_uv + static_cast<std::ptrdiff_t>(y / 2) * uv_stride,
+            dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+// BGR24 -> RGB24，flip_vertical 用于底向上存储的 DIB 类缓冲区
+export bool ConvertBgr24ToRgb24(const std::uint8_t* src, int src_stride,
+                                std::uint8_t* dst, int dst_stride, int width, int height,
+                                bool flip_vertical = false) {
+    if (!ValidArgs(src, dst, width, height)) return false;
+    const auto row = ActiveKernels().bgr24;
+    for (int y = 0; y < height; ++y) {
+        const int src_row = flip_vertical ? (height - 1 - y) : y;
+        row(src + static_cast<std::ptrdiff_t>(src_row) * src_stride, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+// BGRA32 -> RGB24（丢弃 alpha）
+export bool ConvertBgra32ToRgb24(const std::uint8_t* src, int src_stride,
+                                 std::uint8_t* dst, int dst_stride, int width, int height,
+                                 bool flip_vertical = false) {
+    if (!ValidArgs(src, dst, width, height)) return false;
+    const auto row = ActiveKernels().bgra32;
+    for (int y = 0; y < height; ++y) {
+        const int src_row = flip_vertical ? (height - 1 - y) : y;
+        row(src + static_cast<std::ptrdiff_t>(src_row) * src_stride, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+// RGB24 -> 8 位亮度平面
+export bool ConvertRgb24ToLuma(const std::uint8_t* src, int src_stride,
+                               std::uint8_t* dst, int dst_stride, int width, int height) {
+    if (!ValidArgs(src, dst, width, height)) return false;
+    const auto row = ActiveKernels().luma;
+    for (int y = 0; y < height; ++y) {
+        row(src + static_cast<std::ptrdiff_t>(y) * src_stride, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+// RGB24 缩小到 dst_width x dst_height（不放大）。源可以是整帧中的子区域（src_stride 为整帧行跨度）。
+// 输出恰为源一半时走 2x2 均值内核；其余比例为双线性插值：垂直方向两行加权（SIMD），
+// 水平方向按预计算的列索引与权重逐像素插值。
+export bool DownscaleRgb24(const std::uint8_t* src, int src_stride, int src_width, int src_height,
+                           std::uint8_t* dst, int dst_stride, int dst_width, int dst_height) {
+    if (!ValidArgs(src, dst, src_width, src_height) || dst_width <= 0 || dst_height <= 0 ||
+        dst_width > src_width || dst_height > src_height) {
+        return false;
+    }
+    const ConvertKernels& kernels = ActiveKernels();
+
+    if (dst_width == src_width / 2 && dst_height == src_height / 2) {
+        for (int y = 0; y < dst_height; ++y) {
+            const std::uint8_t* row0 = src + static_cast<std::ptrdiff_t>(y * 2) * src_stride;
+            kernels.halve_rgb24(row0, row0 + src_stride, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, dst_width);
+        }
+        return true;
+    }
+
+    // 采样点取像素中心对齐：src = (dst + 0.5) * ratio - 0.5，16.16 定点
+    auto source_position = [](int index, int src_size, int dst_size, int& base, int& weight) {
+        const std::int64_t ratio = (static_cast<std::int64_t>(src_size) << 16) / dst_size;
+        std::int64_t pos = ((2 * index + 1) * ratio - (1 << 16)) / 2;
+        pos = std::clamp<std::int64_t>(pos, 0, static_cast<std::int64_t>(src_size - 1) << 16);
+        base = static_cast<int>(pos >> 16);
+        weight = static_cast<int>((pos & 0xFFFF) >> (16 - kBlendBits));
+        if (base >= src_size - 1) {
+            base = src_size - 1;
+            weight = 0;
+        }
+    };
+
+    thread_local std::vector<int> column_base;
+    thread_local std::vector<int> column_weight;
+    thread_local std::vector<std::uint8_t> blended_row;
+    column_base.resize(dst_width);
+    column_weight.resize(dst_width);
+    blended_row.resize(static_cast<std::size_t>(src_width) * 3 + 3);
+    for (int x = 0; x < dst_width; ++x) {
+        source_position(x, src_width, dst_width, column_base[x], column_weight[x]);
+        column_base[x] *= 3;  // 转为字节偏移
+    }
+
+    for (int y = 0; y < dst_height; ++y) {
+        int row = 0;
+        int row_weight = 0;
+        source_position(y, src_height, dst_height, row, row_weight);
+        const std::uint8_t* row0 = src + static_cast<std::ptrdiff_t>(row) * src_stride;
+        const std::uint8_t* row1 = row_weight > 0 ? row0 + src_stride : row0;
+        kernels.blend_rows(row0, row1, blended_row.data(), src_width * 3, row_weight);
+
+        std::uint8_t* out = dst + static_cast<std::ptrdiff_t>(y) * dst_stride;
+        const std::uint8_t* blended = blended_row.data();
+        for (int x = 0; x < dst_width; ++x) {
+            const std::uint8_t* p = blended + column_base[x];
+            const int w1 = column_weight[x];
+            const int w0 = kBlendOne - w1;
+            out[0] = static_cast<std::uint8_t>((p[0] * w0 + p[3] * w1 + kBlendOne / 2) >> kBlendBits);
+            out[1] = static_cast<std::uint8_t>((p[1] * w0 + p[4] * w1 + kBlendOne / 2) >> kBlendBits);
+            out[2] = static_cast<std::uint8_t>((p[2] * w0 + p[5] * w1 + kBlendOne / 2) >> kBlendBits);
+            out += 3;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,152 @@
+// motion_gate.cpp
+// 运动门控：缩小亮度平面上的分块帧差，画面静止时跳过检测
+
+#include "motion_gate.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MOTION_GATE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MOTION_GATE_NEON 1
+#include <arm_neon.h>
+#endif
+
+import pixel_convert;
+import std;
+
+namespace {
+
+constexpr int kBlock = MotionGate::kBlockSide;
+constexpr int kBlockPixels = kBlock * kBlock;
+
+std::uint32_t BlockSadScalar(const std::uint8_t* a, const std::uint8_t* b, int stride) {
+    std::uint32_t sad = 0;
+    for (int y = 0; y < kBlock; ++y) {
+        for (int x = 0; x < kBlock; ++x) {
+            sad += static_cast<std::uint32_t>(std::abs(a[y * stride + x] - b[y * stride + x]));
+        }
+    }
+    return sad;
+}
+
+#if defined(MOTION_GATE_SSE2)
+
+// 一次处理水平相邻的两个块：psadbw 的两个 64 位通道分别是左右块的行绝对差和
+void BlockPairSad(const std::uint8_t* a, const std::uint8_t* b, int stride, std::uint32_t& left, std::uint32_t& right) {
+    __m128i acc = _mm_setzero_si128();
+    for (int y = 0; y < kBlock; ++y) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + y * stride));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + y * stride));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+    }
+    left = static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc));
+    right = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc)));
+}
+
+#elif defined(MOTION_GATE_NEON)
+
+void BlockPairSad(const std::uint8_t* a, const std::uint8_t* b, int stride, std::uint32_t& left, std::uint32_t& right) {
+    // 8 行 x 每通道 2 个差值，最大 4080，16 位通道不会溢出
+    uint16x8_t acc = vdupq_n_u16(0);
+    for (int y = 0; y < kBlock; ++y) {
+        acc = vpadalq_u8(acc, vabdq_u8(vld1q_u8(a + y * stride), vld1q_u8(b + y * stride)));
+    }
+    const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+    left = static_cast<std::uint32_t>(vgetq_lane_u64(sums, 0));
+    right = static_cast<std::uint32_t>(vgetq_lane_u64(sums, 1));
+}
+
+#else
+
+void BlockPairSad(const std::uint8_t* a, const std::uint8_t* b, int stride, std::uint32_t& left, std::uint32_t& right) {
+    left = BlockSadScalar(a, b, stride);
+    right = BlockSadScalar(a + kBlock, b + kBlock, stride);
+}
+
+#endif
+
+} // namespace
+
+MotionGate::MotionGate(const MotionGateOptions& options, bool use_simd)
+    : options_(options), use_simd_(use_simd) {
+    rgb_.resize(static_cast<std::size_t>(kPlaneWidth) * kPlaneHeight * 3);
+    current_.resize(static_cast<std::size_t>(kPlaneWidth) * kPlaneHeight);
+    reference_.resize(current_.size());
+}
+
+float MotionGate::MaxBlockDifference(const std::uint8_t* a, const std::uint8_t* b,
+                                     int width, int height, bool use_simd) {
+    std::uint32_t max_sad = 0;
+    for (int by = 0; by + kBlock <= height; by += kBlock) {
+        const std::uint8_t* row_a = a + static_cast<std::ptrdiff_t>(by) * width;
+        const std::uint8_t* row_b = b + static_cast<std::ptrdiff_t>(by) * width;
+        int bx = 0;
+        if (use_simd) {
+            for (; bx + 2 * kBlock <= width; bx += 2 * kBlock) {
+                std::uint32_t left = 0;
+                std::uint32_t right = 0;
+                BlockPairSad(row_a + bx, row_b + bx, width, left, right);
+                max_sad = std::max({max_sad, left, right});
+            }
+        }
+        for (; bx + kBlock <= width; bx += kBlock) {
+            max_sad = std::max(max_sad, BlockSadScalar(row_a + bx, row_b + bx, width));
+        }
+    }
+    return static_cast<float>(max_sad) / kBlockPixels;
+}
+
+// 整帧 -> 缩小 RGB -> 亮度平面；帧比采样平面还小时不做门控
+bool MotionGate::Sample(const SeetaImageData& frame) {
+    if (frame.data == nullptr || frame.channels != 3 ||
+        frame.width < kPlaneWidth || frame.height < kPlaneHeight) {
+        return false;
+    }
+    if (!DownscaleRgb24(frame.data, frame.width * 3, frame.width, frame.height,
+                        rgb_.data(), kPlaneWidth * 3, kPlaneWidth, kPlaneHeight)) {
+        return false;
+    }
+    return ConvertRgb24ToLuma(rgb_.data(), kPlaneWidth * 3, current_.data(), kPlaneWidth, kPlaneWidth, kPlaneHeight);
+}
+
+bool MotionGate::ShouldInfer(const SeetaImageData& frame, Clock::time_point now) {
+    if (!options_.enabled) {
+        return true;
+    }
+    const auto start = Clock::now();
+    has_current_ = Sample(frame);
+    bool infer = true;
+    if (has_current_ && has_reference_) {
+        ++stats_.checked;
+        last_difference_ = MaxBlockDifference(current_.data(), reference_.data(), kPlaneWidth, kPlaneHeight, use_simd_);
+        if (now - last_inference_ >= std::chrono::milliseconds(options_.force_interval_ms)) {
+            ++stats_.forced;
+        } else if (last_difference_ >= options_.block_threshold) {
+            ++stats_.changed;
+        } else {
+            ++stats_.skipped;
+            infer = false;
+        }
+    }
+    stats_.gate_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return infer;
+}
+
+void MotionGate::OnInferred(bool face_found, Clock::time_point now) {
+    last_inference_ = now;
+    if (face_found) {
+        has_reference_ = false;
+    } else if (has_current_) {
+        reference_.swap(current_);
+        has_reference_ = true;
+    }
+    has_current_ = false;
+}
+
+void MotionGate::Reset() {
+    has_current_ = false;
+    has_reference_ = false;
+    last_inference_ = Clock::time_point{};
+    last_difference_ = 0.0f;
+    stats_ = MotionGateStats{};
+}
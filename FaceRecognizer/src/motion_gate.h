@@ -0,0 +1,73 @@
+#pragma once
+
+#include <seeta/Common/CStruct.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 运动门控参数（来自 [core] motion_gate / motion_threshold / motion_force_interval_ms）
+ */
+struct MotionGateOptions {
+    bool enabled = true;
+    float block_threshold = 6.0f;   // 任一 8x8 块的平均绝对亮度差达到该值即视为画面变化
+    int force_interval_ms = 1000;   // 画面静止时也至少每隔多久做一次完整检测
+};
+
+/**
+ * @brief 运动门控统计
+ */
+struct MotionGateStats {
+    int checked = 0;     // 参与比较的帧数
+    int skipped = 0;     // 画面未变化而跳过检测的帧数
+    int changed = 0;     // 画面变化而放行的帧数
+    int forced = 0;      // 因 force_interval_ms 到期而放行的帧数
+    double gate_ms = 0.0;
+};
+
+/**
+ * @brief 帧差运动门控：画面与上一次无人脸帧相比没有变化时跳过检测
+ *
+ * 整帧缩小到 kPlaneWidth x kPlaneHeight 的亮度平面（pixel_convert 运行时分派的内核），
+ * 与参考平面逐 8x8 块求绝对差和（x86 SSE2 psadbw / ARM NEON vabd），取最大块均值判定。
+ * 参考平面只在推理结果为无人脸时更新，缓慢的变化会累积到阈值；检出人脸后清除参考，
+ * 有人脸期间不做门控。缓冲区随实例复用，非线程安全。
+ */
+class MotionGate {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kPlaneWidth = 64;
+    static constexpr int kPlaneHeight = 48;
+    static constexpr int kBlockSide = 8;
+
+    explicit MotionGate(const MotionGateOptions& options = MotionGateOptions{}, bool use_simd = true);
+
+    // 返回 false 表示画面与参考帧相比未变化，本帧可以跳过检测
+    bool ShouldInfer(const SeetaImageData& frame, Clock::time_point now);
+
+    // 本帧推理完成后调用：无人脸时以本帧作为参考，有人脸时清除参考
+    void OnInferred(bool face_found, Clock::time_point now);
+
+    void Reset();
+    float last_difference() const { return last_difference_; }
+    MotionGateStats stats() const { return stats_; }
+
+    // 两个 width x height 亮度平面（宽高为 kBlockSide 的倍数）之间最大的 8x8 块平均绝对差
+    static float MaxBlockDifference(const std::uint8_t* a, const std::uint8_t* b,
+                                    int width, int height, bool use_simd);
+
+private:
+    bool Sample(const SeetaImageData& frame);
+
+    MotionGateOptions options_;
+    bool use_simd_ = true;
+    std::vector<std::uint8_t> rgb_;
+    std::vector<std::uint8_t> current_;
+    std::vector<std::uint8_t> reference_;
+    bool has_current_ = false;
+    bool has_reference_ = false;
+    Clock::time_point last_inference_{};
+    float last_difference_ = 0.0f;
+    MotionGateStats stats_;
+};
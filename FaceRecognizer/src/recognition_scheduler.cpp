@@ -0,0 +1,115 @@
+// recognition_scheduler.cpp
+// 识别会话调度：墙钟截止时间、阶段预算与无人脸降频
+
+#include "recognition_scheduler.h"
+
+import std;
+
+namespace {
+
+uint32_t ToMs(RecognitionScheduler::Clock::duration duration) {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    return static_cast<uint32_t>(std::max<std::int64_t>(ms, 0));
+}
+
+} // namespace
+
+const char* SessionPhaseName(SessionPhase phase) {
+    switch (phase) {
+        case SessionPhase::SEARCHING: return "searching";
+        case SessionPhase::VERIFYING: return "verifying";
+    }
+    return "unknown";
+}
+
+const char* DeadlineReasonName(DeadlineReason reason) {
+    switch (reason) {
+        case DeadlineReason::NONE: return "none";
+        case DeadlineReason::SESSION: return "session";
+        case DeadlineReason::VERIFY: return "verify";
+    }
+    return "unknown";
+}
+
+RecognitionScheduler::RecognitionScheduler(const SchedulerOptions& options, Clock::time_point start)
+    : options_(options), start_(start) {
+    options_.session_timeout_ms = std::max(options_.session_timeout_ms, 1);
+    options_.verify_budget_ms = std::max(options_.verify_budget_ms, 1);
+    options_.idle_interval_ms = std::max(options_.idle_interval_ms, 0);
+    options_.idle_after_misses = std::max(options_.idle_after_misses, 1);
+    session_deadline_ = start_ + std::chrono::milliseconds(options_.session_timeout_ms);
+    phase_start_ = start_;
+    verify_deadline_ = session_deadline_;
+    next_inference_ = start_;
+    last_report_ = start_;
+}
+
+RecognitionScheduler::Clock::time_point RecognitionScheduler::Deadline() const {
+    return phase_ == SessionPhase::VERIFYING ? verify_deadline_ : session_deadline_;
+}
+
+DeadlineReason RecognitionScheduler::Expired(Clock::time_point now) const {
+    if (now >= session_deadline_) return DeadlineReason::SESSION;
+    if (phase_ == SessionPhase::VERIFYING && now >= verify_deadline_) return DeadlineReason::VERIFY;
+    return DeadlineReason::NONE;
+}
+
+RecognitionScheduler::Clock::time_point RecognitionScheduler::NextInferenceAt() const {
+    return std::min(next_inference_, Deadline());
+}
+
+void RecognitionScheduler::OnFrame(bool face_found, double inference_ms, Clock::time_point now) {
+    ++frames_;
+    inference_ms_ += inference_ms;
+    const bool idle = consecutive_misses_ >= options_.idle_after_misses;
+    if (idle) ++idle_frames_;
+
+    if (face_found) {
+        consecutive_misses_ = 0;
+        next_inference_ = now;
+        if (phase_ == SessionPhase::SEARCHING) {
+            phase_ = SessionPhase::VERIFYING;
+            phase_start_ = now;
+            verify_deadline_ = std::min(now + std::chrono::milliseconds(options_.verify_budget_ms), session_deadline_);
+            phase_changed_ = true;
+        }
+        return;
+    }
+
+    // 人脸消失不回退阶段：验证预算从首次检出开始计算，保证最坏情况下的结束时间
+    ++consecutive_misses_;
+    next_inference_ = consecutive_misses_ >= options_.idle_after_misses
+        ? now + std::chrono::milliseconds(options_.idle_interval_ms)
+        : now;
+}
+
+void RecognitionScheduler::OnSkipped(Clock::time_point now) {
+    ++skipped_frames_;
+    ++consecutive_misses_;
+    next_inference_ = consecutive_misses_ >= options_.idle_after_misses
+        ? now + std::chrono::milliseconds(options_.idle_interval_ms)
+        : now;
+}
+
+bool RecognitionScheduler::TakeProgressReport(Clock::time_point now) {
+    if (!phase_changed_ && now - last_report_ < std::chrono::milliseconds(options_.progress_interval_ms)) {
+        return false;
+    }
+    phase_changed_ = false;
+    last_report_ = now;
+    return true;
+}
+
+SchedulerSnapshot RecognitionScheduler::Snapshot(Clock::time_point now) const {
+    SchedulerSnapshot snapshot;
+    snapshot.phase = phase_;
+    snapshot.elapsed_ms = ToMs(now - start_);
+    snapshot.session_budget_ms = static_cast<uint32_t>(options_.session_timeout_ms);
+    snapshot.phase_elapsed_ms = ToMs(now - phase_start_);
+    snapshot.phase_budget_ms = ToMs(Deadline() - phase_start_);
+    snapshot.frames = frames_;
+    snapshot.idle_frames = idle_frames_;
+    snapshot.skipped_frames = skipped_frames_;
+    snapshot.inference_ms = static_cast<uint32_t>(inference_ms_);
+    return snapshot;
+}
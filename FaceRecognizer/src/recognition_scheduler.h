@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 识别会话的时间预算（来自 [core] session_timeout_ms / verify_budget_ms / idle_interval_ms）
+ */
+struct SchedulerOptions {
+    int session_timeout_ms = 10000;  // 整个会话的墙钟截止时间
+    int verify_budget_ms = 3000;     // 首次检出人脸后，完成活体与多帧融合的预算
+    int idle_interval_ms = 200;      // 无人脸时两次推理的最小间隔，0 表示不降频
+    int idle_after_misses = 3;       // 连续多少帧无人脸后开始降频
+    int progress_interval_ms = 500;  // 进度上报的最小间隔
+};
+
+enum class SessionPhase : uint8_t {
+    SEARCHING = 0,  // 等待人脸出现
+    VERIFYING,      // 已检出人脸：活体、质量与融合
+};
+
+enum class DeadlineReason : uint8_t {
+    NONE = 0,
+    SESSION,        // 会话总时间用尽
+    VERIFY,         // 验证阶段预算用尽
+};
+
+/**
+ * @brief 调度器状态快照，用于日志与状态上报
+ */
+struct SchedulerSnapshot {
+    SessionPhase phase = SessionPhase::SEARCHING;
+    uint32_t elapsed_ms = 0;
+    uint32_t session_budget_ms = 0;
+    uint32_t phase_elapsed_ms = 0;
+    uint32_t phase_budget_ms = 0;
+    uint32_t frames = 0;
+    uint32_t idle_frames = 0;        // 降频状态下推理的帧数
+    uint32_t skipped_frames = 0;     // 运动门控跳过的帧数
+    uint32_t inference_ms = 0;
+};
+
+/**
+ * @brief 以墙钟截止时间驱动的识别调度器
+ *
+ * 会话从构造时开始计时，无论是否持续取到帧都会按时结束；首次检出人脸后进入验证阶段，
+ * 其截止时间为 min(检出时刻 + verify_budget_ms, 会话截止时间)。画面中连续无人脸时
+ * 按 idle_interval_ms 降低推理频率，检出人脸后立即恢复全速。
+ */
+class RecognitionScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RecognitionScheduler(const SchedulerOptions& options, Clock::time_point start = Clock::now());
+
+    // 当前阶段的截止时间
+    Clock::time_point Deadline() const;
+    DeadlineReason Expired(Clock::time_point now) const;
+
+    // 下一次推理的最早时间（不晚于截止时间）
+    Clock::time_point NextInferenceAt() const;
+
+    // 每帧推理完成后调用
+    void OnFrame(bool face_found, double inference_ms, Clock::time_point now);
+
+    // 运动门控判定画面未变化、跳过推理的帧：按无人脸处理降频，但不计入推理帧数
+    void OnSkipped(Clock::time_point now);
+
+    // 距上次上报超过 progress_interval_ms 或阶段刚切换时返回 true，并记为已上报
+    bool TakeProgressReport(Clock::time_point now);
+
+    SchedulerSnapshot Snapshot(Clock::time_point now) const;
+    SessionPhase phase() const { return phase_; }
+
+private:
+    SchedulerOptions options_;
+    Clock::time_point start_;
+    Clock::time_point session_deadline_;
+    Clock::time_point phase_start_;
+    Clock::time_point verify_deadline_;
+    Clock::time_point next_inference_;
+    Clock::time_point last_report_;
+    SessionPhase phase_ = SessionPhase::SEARCHING;
+    bool phase_changed_ = true;
+    int consecutive_misses_ = 0;
+    uint32_t frames_ = 0;
+    uint32_t idle_frames_ = 0;
+    uint32_t skipped_frames_ = 0;
+    double inference_ms_ = 0.0;
+};
+
+const char* SessionPhaseName(SessionPhase phase);
+const char* DeadlineReasonName(DeadlineReason reason);
@@ -2,6 +2,7 @@
 
 import app_paths;
 import utils;
+import pixel_convert;
 import std;
 
 // 通用模型创建函数
@@ -22,8 +23,46 @@ seeta::FaceAntiSpoofing *new_fas_v2() {
     return new seeta::FaceAntiSpoofing(setting);
 }
 
-seetaface::seetaface() : pFD(nullptr), pFL(nullptr), pFR(nullptr), pFAS(nullptr) {
+namespace {
+
+using LoadClock = std::chrono::steady_clock;
+
+double ElapsedMs(LoadClock::time_point since) {
+    return std::chrono::duration<double, std::milli>(LoadClock::now() - since).count();
+}
+
+// 在独立线程上加载模型并记录耗时
+template <typename T, typename Factory>
+std::future<T*> LoadModelAsync(Factory factory, double& elapsed_ms) {
+    return std::async(std::launch::async, [factory, &elapsed_ms]() {
+        const auto start = LoadClock::now();
+        T* model = factory();
+        elapsed_ms = ElapsedMs(start);
+        return model;
+    });
+}
+
+seeta::FaceAntiSpoofing* LoadAntiSpoofing(const std::string& path1, const std::string& path2) {
+    seeta::ModelSetting setting_fas;
+    setting_fas.append(path1);
+    setting_fas.append(path2);
+    return new seeta::FaceAntiSpoofing(setting_fas);
+}
+
+} // namespace
+
+const char* LivenessDecisionName(LivenessDecision decision) {
+    switch (decision) {
+        case LivenessDecision::PENDING: return "pending";
+        case LivenessDecision::REAL: return "real";
+        case LivenessDecision::SPOOF: return "spoof";
+    }
+    return "unknown";
+}
+
+seetaface::seetaface(bool preload_liveness) : pFD(nullptr), pFL(nullptr), pFR(nullptr), pFAS(nullptr) {
     std::cout << "[Recognizer] 初始化中..." << std::endl;
+    const auto init_start = LoadClock::now();
 
     // 初始化模型路径字符串 (避免悬空指针)
     const auto model_dir = smile2unlock::paths::GetRecognizerModelsDirectory();
@@ -33,90 +72,142 @@ seetaface::seetaface() : pFD(nullptr), pFL(nullptr), pFR(nullptr), pFAS(nullptr)
     model_path_fas1 = (model_dir / "fas_first.csta").string();
     model_path_fas2 = (model_dir / "fas_second.csta").string();
 
-    try {
-        // 检查模型文件是否存在
-        if (!std::filesystem::exists(model_path_fd)) {
-            throw FaceRecognition::ModelLoadException("face_detector", "File not found: " + model_path_fd);
-        }
-        if (!std::filesystem::exists(model_path_fl)) {
-            throw FaceRecognition::ModelLoadException("face_landmarker", "File not found: " + model_path_fl);
-        }
-        if (!std::filesystem::exists(model_path_fr)) {
-            throw FaceRecognition::ModelLoadException("face_recognizer", "File not found: " + model_path_fr);
-        }
-        if (!std::filesystem::exists(model_path_fas1) || !std::filesystem::exists(model_path_fas2)) {
-            std::cout << "[Recognizer] 警告: 活体检测模型文件不存在，将禁用活体检测功能" << std::endl;
-        }
+    // 检查模型文件是否存在
+    if (!std::filesystem::exists(model_path_fd)) {
+        throw FaceRecognition::ModelLoadException("face_detector", "File not found: " + model_path_fd);
+    }
+    if (!std::filesystem::exists(model_path_fl)) {
+        throw FaceRecognition::ModelLoadException("face_landmarker", "File not found: " + model_path_fl);
+    }
+    if (!std::filesystem::exists(model_path_fr)) {
+        throw FaceRecognition::ModelLoadException("face_recognizer", "File not found: " + model_path_fr);
+    }
+    fas_available_ = std::filesystem::exists(model_path_fas1) && std::filesystem::exists(model_path_fas2);
+    if (!fas_available_) {
+        std::cout << "[Recognizer] 警告: 活体检测模型文件不存在，要求活体检测的识别将被拒绝" << std::endl;
+    }
 
-        // 加载人脸检测器
+    // 三个模型互不依赖，各自在独立线程上加载；总耗时约等于最慢的识别模型
+    auto fd_future = LoadModelAsync<seeta::FaceDetector>([this]() {
         seeta::ModelSetting setting_fd;
         setting_fd.append(model_path_fd.c_str());
-        pFD = new seeta::FaceDetector(setting_fd);
+        return new seeta::FaceDetector(setting_fd);
+    }, load_timings_.detector_ms);
 
-        // 加载特征点定位器
+    auto fl_future = LoadModelAsync<seeta::FaceLandmarker>([this]() {
         seeta::ModelSetting setting_fl;
         setting_fl.append(model_path_fl.c_str());
-        pFL = new seeta::FaceLandmarker(setting_fl);
+        return new seeta::FaceLandmarker(setting_fl);
+    }, load_timings_.landmarker_ms);
 
-        // 加载人脸识别器
+    auto fr_future = LoadModelAsync<seeta::FaceRecognizer>([this]() {
         seeta::ModelSetting setting_fr;
         const char* models[] = { model_path_fr.c_str(), NULL };
         setting_fr.model = models;
-        pFR = new seeta::FaceRecognizer(setting_fr);
-
-        // 加载活体检测器（如果文件存在）
-        if (std::filesystem::exists(model_path_fas1) && std::filesystem::exists(model_path_fas2)) {
-            seeta::ModelSetting setting_fas;
-            setting_fas.append(model_path_fas1);
-            setting_fas.append(model_path_fas2);
-            pFAS = new seeta::FaceAntiSpoofing(setting_fas);
-        } else {
-            pFAS = nullptr;
-        }
+        return new seeta::FaceRecognizer(setting_fr);
+    }, load_timings_.recognizer_ms);
 
-        std::cout << "[Recognizer] 初始化完成" << std::endl;
+    // 活体模型不阻塞构造：开启活体时后台预加载，首次 predict 前再等待
+    if (fas_available_ && preload_liveness) {
+        fas_future_ = LoadModelAsync<seeta::FaceAntiSpoofing>([this]() {
+            return LoadAntiSpoofing(model_path_fas1, model_path_fas2);
+        }, fas_background_ms_);
     }
-    catch (const std::exception& e) {
-        std::cerr << "[Recognizer] 初始化失败: " << e.what() << std::endl;
+
+    // 必须等待所有任务结束后再处理异常，否则已成功加载的模型会泄漏
+    std::exception_ptr load_error;
+    auto collect = [&load_error](auto& future, auto*& target) {
+        try {
+            target = future.get();
+        } catch (...) {
+            if (!load_error) load_error = std::current_exception();
+        }
+    };
+    collect(fd_future, pFD);
+    collect(fl_future, pFL);
+    collect(fr_future, pFR);
+
+    if (load_error) {
+        if (fas_future_.valid()) {
+            try { delete fas_future_.get(); } catch (...) {}
+        }
         // 使用安全的删除宏
         if (pFD) { delete pFD; pFD = nullptr; }
         if (pFL) { delete pFL; pFL = nullptr; }
         if (pFR) { delete pFR; pFR = nullptr; }
-        if (pFAS) { delete pFAS; pFAS = nullptr; }
-        throw;
+        try {
+            std::rethrow_exception(load_error);
+        } catch (const std::exception& e) {
+            std::cerr << "[Recognizer] 初始化失败: " << e.what() << std::endl;
+            throw;
+        }
     }
+
+    load_timings_.total_ms = ElapsedMs(init_start);
+    std::println("[Recognizer] 初始化完成, 耗时 {:.1f} ms (检测 {:.1f} / 关键点 {:.1f} / 识别 {:.1f}){}",
+                 load_timings_.total_ms, load_timings_.detector_ms,
+                 load_timings_.landmarker_ms, load_timings_.recognizer_ms,
+                 fas_future_.valid() ? "，活体模型后台加载中" : "");
 }
 
 seetaface::~seetaface() {
+    if (fas_future_.valid()) {
+        try { pFAS = fas_future_.get(); } catch (...) {}
+    }
     delete pFD;
     delete pFL;
     delete pFR;
     delete pFAS;
 }
 
+ModelLoadTimings seetaface::load_timings() const {
+    std::lock_guard<std::mutex> lock(fas_mutex_);
+    return load_timings_;
+}
+
+/**
+ * @brief 确保活体模型可用
+ *
+ * 后台预加载时等待其完成；未预加载时在此同步加载。加载失败后不再重试。
+ *
+ * @return bool 活体模型是否可用
+ */
+bool seetaface::ensure_anti_spoofing() {
+    std::lock_guard<std::mutex> lock(fas_mutex_);
+    if (pFAS != nullptr) return true;
+    if (!fas_available_) return false;
+
+    try {
+        if (fas_future_.valid()) {
+            pFAS = fas_future_.get();
+            load_timings_.anti_spoofing_ms = fas_background_ms_;
+        } else {
+            const auto start = LoadClock::now();
+            pFAS = LoadAntiSpoofing(model_path_fas1, model_path_fas2);
+            load_timings_.anti_spoofing_ms = ElapsedMs(start);
+        }
+        if (num_threads_ > 0) {
+            pFAS->set(seeta::FaceAntiSpoofing::PROPERTY_NUMBER_THREADS, num_threads_);
+        }
+        std::println("[Recognizer] 活体模型就绪, 加载耗时 {:.1f} ms", load_timings_.anti_spoofing_ms);
+    } catch (const std::exception& e) {
+        std::cerr << "[Recognizer] 活体模型加载失败，要求活体检测的识别将被拒绝: " << e.what() << std::endl;
+        fas_available_ = false;
+        pFAS = nullptr;
+    }
+    return pFAS != nullptr;
+}
+
 /**
  * @brief 将图像转换为人脸特征向量
  * 
- * 该函数执行完整的人脸识别流程：
- * 1. 检测图像中的人脸位置
- * 2. 标记人脸关键点
- * 3. 提取人脸特征
+ * 等价于 analyze(cap_img, AnalysisFlags::FEATURES)，检测与关键点只执行一次。
  * 
  * @param cap_img 输入的图像数据
  * @return std::shared_ptr<float> 人脸特征向量，如果检测失败返回nullptr
  */
 std::shared_ptr<float> seetaface::img2features(SeetaImageData cap_img) {
-    // 检测人脸位置
-    SeetaRect pos = detect(cap_img);
-    
-    // 检查人脸检测是否成功，如果返回的矩形宽高为0表示检测失败
-    if (pos.width == 0 || pos.height == 0) return nullptr;
-    
-    // 标记人脸关键点
-    auto points = mark(cap_img, pos);
-    
-    // 提取人脸特征向量
-    return extract(cap_img, points);
+    return analyze(cap_img, AnalysisFlags::FEATURES).features;
 }
 
 int seetaface::feature_size() const {
@@ -162,21 +253,45 @@ float seetaface::feat_compare(std::shared_ptr<float> feat1, std::shared_ptr<floa
 }
 
 /**
- * @brief 从图像和关键点提取人脸特征
- * 
+ * @brief 按关键点裁剪并对齐人脸，缓冲区取自会话内的对齐缓存
+ *
  * @param image 输入图像
+ * @param face 原图人脸框
  * @param points 人脸关键点
- * @return std::shared_ptr<float> 提取的人脸特征向量
+ * @return std::shared_ptr<const AlignedFace> 对齐结果，失败时返回nullptr
+ */
+std::shared_ptr<const AlignedFace> seetaface::align(const SeetaImageData& image, const SeetaRect& face,
+                                                    const std::vector<SeetaPointF>& points) {
+    if (points.empty()) return nullptr;
+    std::shared_ptr<AlignedFace> aligned = aligned_cache_.Acquire(
+        pFR->GetCropFaceWidthV2(), pFR->GetCropFaceHeightV2(), pFR->GetCropFaceChannelsV2());
+    aligned->source = face;
+    aligned->face_size = std::min(face.width, face.height);
+
+    SeetaImageData crop{aligned->width, aligned->height, aligned->channels, aligned->pixels.data()};
+    if (!pFR->CropFaceV2(image, points.data(), crop)) {
+        return nullptr;
+    }
+    return aligned;
+}
+
+/**
+ * @brief 从对齐人脸提取特征，不再访问整帧
+ * 
+ * @param aligned 对齐人脸
+ * @return std::shared_ptr<float> 提取的人脸特征向量，失败时返回nullptr
  */
-std::shared_ptr<float> seetaface::extract(const SeetaImageData& image, const std::vector<SeetaPointF>& points) {
+std::shared_ptr<float> seetaface::extract(const AlignedFace& aligned) {
     // 创建特征向量的智能指针，使用自定义删除器确保数组正确释放
     std::shared_ptr<float> features(
         new float[pFR->GetExtractFeatureSize()], 
         [](float* p) { delete[] p; }  // 自定义删除器，使用delete[]释放数组
     );
     
-    // 调用SeetaFace识别器提取特征
-    pFR->Extract(image, points.data(), features.get());
+    // 调用SeetaFace识别器在已裁剪的人脸上提取特征
+    if (!pFR->ExtractCroppedFace(aligned.view(), features.get())) {
+        return nullptr;
+    }
     
     return features;
 }
@@ -197,18 +312,18 @@ std::vector<SeetaPointF> seetaface::mark(const SeetaImageData& image, const Seet
  * @brief 检测图像中的人脸
  * 
  * @param cap_img 输入图像
- * @return SeetaRect 检测到的人脸位置，如果没有检测到人脸返回{0,0,0,0}
+ * @return SeetaRect 排序首位的人脸位置，如果没有检测到人脸返回{0,0,0,0}
  */
 SeetaRect seetaface::detect(SeetaImageData cap_img) {
     try {
-        // 使用SeetaFace检测器检测图像中的人脸
-        SeetaFaceInfoArray faces = pFD->detect(cap_img);
+        // 使用SeetaFace检测器检测图像中的人脸，按大小 / 得分 / 居中程度排序
+        const std::vector<RankedFace> faces = detect_all(cap_img);
         
         // 检查是否检测到人脸
-        if (faces.size == 0) throw std::runtime_error("No face detected");
+        if (faces.empty()) throw std::runtime_error("No face detected");
         
-        // 返回第一个检测到的人脸位置
-        return faces.data[0].pos;
+        // 返回排序首位的人脸位置
+        return faces.front().info.pos;
     } catch (const std::exception& e) {
         // 捕获并打印异常信息
         printf("Error: %s\n", e.what());
@@ -217,6 +332,17 @@ SeetaRect seetaface::detect(SeetaImageData cap_img) {
     }
 }
 
+/**
+ * @brief 整帧检测并排序，不读写跟踪与 focus 状态
+ *
+ * @param image 输入图像
+ * @return std::vector<RankedFace> 按排序分降序的全部人脸
+ */
+std::vector<RankedFace> seetaface::detect_all(const SeetaImageData& image) {
+    const std::vector<SeetaFaceInfo> faces = detect_region(image, SeetaRect{0, 0, image.width, image.height});
+    return RankFaces(faces, image.width, image.height, ranking_);
+}
+
 /**
  * @brief 预测人脸是否为真实人脸（活体检测）
  * 
@@ -265,6 +391,66 @@ bool seetaface::predict(const SeetaImageData& image,
   }
 }
 
+/**
+ * @brief 视频模式活体检测：把当前帧送入同一人脸的多帧累积
+ *
+ * 会话首帧重置模型的视频状态；模型返回 REAL / SPOOF 时结论固定。DETECTING / FUZZY 时继续累积，
+ * 送入帧数达到 frame_budget 后以最后一帧的清晰度 / 真实度分数与阈值比较给出结论。
+ *
+ * @return LivenessDecision 累积后的结论，未定时为 PENDING
+ */
+LivenessDecision seetaface::predict_video(const SeetaImageData& image,
+                                          const SeetaRect& face,
+                                          const SeetaPointF* points,
+                                          float liveness_threshold) {
+    pFAS->SetThreshold(0.3f, liveness_threshold);
+    if (!liveness_started_) {
+        pFAS->ResetVideo();
+        pFAS->SetVideoFrameCount(std::max(1, liveness_session_.video_frames));
+        liveness_started_ = true;
+        ++liveness_stats_.sessions;
+    }
+
+    const auto status = pFAS->PredictVideo(image, face, points);
+    ++liveness_frames_;
+    ++liveness_stats_.inferred_frames;
+
+    switch (status) {
+        case seeta::FaceAntiSpoofing::REAL:
+            liveness_decision_ = LivenessDecision::REAL;
+            break;
+        case seeta::FaceAntiSpoofing::SPOOF:
+            liveness_decision_ = LivenessDecision::SPOOF;
+            break;
+        default:
+            break;
+    }
+
+    float clarity = 0.0f;
+    float reality = 0.0f;
+    pFAS->GetPreFrameScore(&clarity, &reality);
+    float clarity_threshold = 0.0f;
+    float reality_threshold = 0.0f;
+    pFAS->GetThreshold(&clarity_threshold, &reality_threshold);
+
+    bool by_budget = false;
+    if (liveness_decision_ == LivenessDecision::PENDING && liveness_frames_ >= liveness_session_.frame_budget) {
+        liveness_decision_ = (clarity >= clarity_threshold && reality >= reality_threshold)
+            ? LivenessDecision::REAL : LivenessDecision::SPOOF;
+        by_budget = true;
+        ++liveness_stats_.budget_decisions;
+    }
+
+    if (liveness_decision_ != LivenessDecision::PENDING) {
+        ++(liveness_decision_ == LivenessDecision::REAL ? liveness_stats_.real : liveness_stats_.spoof);
+        std::println("[活体检测] {} 视频模式 {} 帧判定{}: 清晰度 {:.3f} (阈值: {:.2f}), 真实度 {:.3f} (阈值: {:.2f})",
+                     liveness_decision_ == LivenessDecision::REAL ? "✓ 真实人脸" : "✗ 攻击检测",
+                     liveness_frames_, by_budget ? "（帧预算用尽，按末帧分数）" : "",
+                     clarity, clarity_threshold, reality, reality_threshold);
+    }
+    return liveness_decision_;
+}
+
 /**
  * @brief 完整的活体检测流程
  * 
@@ -277,15 +463,425 @@ bool seetaface::predict(const SeetaImageData& image,
  * @return bool true表示是真实人脸，false表示是攻击或无法判断
  */
 bool seetaface::anti_face(const SeetaImageData& image, float liveness_threshold) {
-    // 检测人脸位置
-    SeetaRect pos = detect(image);
-    
-    // 检查人脸检测是否成功
-    if (pos.width == 0 || pos.height == 0) return false;
-    
-    // 标记人脸关键点
-    auto points = mark(image, pos);
-    
-    // 进行活体检测
-    return predict(image, pos, points.data(), liveness_threshold);
+    const FrameAnalysis analysis = analyze(image, AnalysisFlags::LIVENESS, liveness_threshold);
+    return analysis.liveness_checked && analysis.is_real;
+}
+
+/**
+ * @brief 单帧分析：检测与关键点只运行一次，结果复用于活体检测和特征提取
+ *
+ * 阶段顺序为 检测 -> 关键点 -> 对齐 -> 质量 -> 活体 -> 特征；质量或活体判定失败时跳过后续阶段，
+ * 避免对将被丢弃的帧做最昂贵的活体与识别推理。对齐结果随 FrameAnalysis 返回，特征提取只读取对齐图，
+ * 活体之后整帧即不再被访问。
+ *
+ * @param image 输入图像
+ * @param flags 需要执行的阶段
+ * @param liveness_threshold 活体真实度阈值（仅 LIVENESS 时使用）
+ * @return FrameAnalysis 分析结果及各阶段耗时
+ */
+FrameAnalysis seetaface::analyze(const SeetaImageData& image, AnalysisFlags flags, float liveness_threshold) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed_ms = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    FrameAnalysis result;
+    const auto frame_start = Clock::now();
+
+    auto stage_start = Clock::now();
+    bool roi_used = false;
+    const std::vector<SeetaFaceInfo> faces = detect_tracked(image, roi_used);
+    result.timings.detect_ms = elapsed_ms(stage_start);
+    result.roi_detection = roi_used;
+    result.faces_detected = static_cast<int>(faces.size());
+    if (!roi_used) last_face_count_ = faces.size();
+    if (faces.empty()) {
+        has_track_ = false;
+        has_focus_ = false;
+        restart_liveness();
+        result.timings.total_ms = elapsed_ms(frame_start);
+        return result;
+    }
+
+    // 多人脸时按排序取首位，而不是检测器返回的第一个；跟踪开启时上一帧的首位人脸保持首位
+    const bool use_focus = tracking_.enabled && has_focus_;
+    const std::vector<RankedFace> ranked =
+        RankFaces(faces, image.width, image.height, ranking_, use_focus ? &focus_ : nullptr);
+    result.face_found = true;
+    result.face = ranked.front().info.pos;
+    result.face_score = ranked.front().info.score;
+    result.rank_score = ranked.front().rank_score;
+    has_track_ = tracking_.enabled;
+    last_face_ = result.face;
+    has_focus_ = true;
+    focus_ = result.face;
+    if (liveness_started_ && RectIoU(liveness_face_, result.face) < kSameFaceIoU) {
+        restart_liveness();
+    }
+    liveness_face_ = result.face;
+
+    const bool want_quality = HasFlag(flags, AnalysisFlags::QUALITY_GATE) && quality_gate_.enabled;
+    // 活体不可用时不能跳过活体继续提取特征，否则识别会在没有防伪的情况下通过
+    const bool want_liveness = HasFlag(flags, AnalysisFlags::LIVENESS);
+    if (want_liveness && !ensure_anti_spoofing()) {
+        result.liveness_unavailable = true;
+        result.timings.total_ms = elapsed_ms(frame_start);
+        return result;
+    }
+    const bool want_features = HasFlag(flags, AnalysisFlags::FEATURES);
+    const bool want_landmarks = HasFlag(flags, AnalysisFlags::LANDMARKS) || want_quality || want_liveness || want_features;
+
+    // 其余候选人脸与首位人脸的判定无关，首位提前结束时也照常处理
+    auto finish = [&]() {
+        if (want_features && ranking_.max_faces > 1 && ranked.size() > 1) {
+            stage_start = Clock::now();
+            analyze_candidates(image, ranked, want_quality, result);
+            result.timings.candidates_ms = elapsed_ms(stage_start);
+        }
+        result.timings.total_ms = elapsed_ms(frame_start);
+    };
+
+    // 过小的人脸无需定位关键点即可丢弃
+    if (want_quality && !FaceQualityScorer::SizeAcceptable(result.face, quality_gate_)) {
+        result.quality_checked = true;
+        result.quality.face_size = std::min(result.face.width, result.face.height);
+        result.quality.issue = QualityIssue::TOO_SMALL;
+        finish();
+        return result;
+    }
+
+    if (want_landmarks) {
+        stage_start = Clock::now();
+        result.points = mark(image, result.face);
+        result.timings.landmark_ms = elapsed_ms(stage_start);
+    }
+
+    // 对齐只做一次：质量评估与特征提取共用，之后不再从整帧重新裁剪
+    if (want_quality || want_features) {
+        stage_start = Clock::now();
+        result.aligned = align(image, result.face, result.points);
+        result.timings.align_ms = elapsed_ms(stage_start);
+    }
+
+    if (want_quality) {
+        stage_start = Clock::now();
+        const int point_count = static_cast<int>(result.points.size());
+        result.quality = result.aligned
+            ? quality_scorer_.ScoreAligned(*result.aligned, result.points.data(), point_count, quality_gate_)
+            : quality_scorer_.Score(image, result.face, result.points.data(), point_count, quality_gate_);
+        result.quality_checked = true;
+        result.timings.quality_ms = elapsed_ms(stage_start);
+        if (!result.quality.passed()) {
+            finish();
+            return result;
+        }
+    }
+
+    if (want_liveness && liveness_session_.enabled) {
+        // 同一人脸的结论已定时直接沿用，不再运行活体推理
+        if (liveness_decision_ == LivenessDecision::PENDING) {
+            stage_start = Clock::now();
+            result.liveness = predict_video(image, result.face, result.points.data(), liveness_threshold);
+            result.liveness_inferred = true;
+            result.timings.liveness_ms = elapsed_ms(stage_start);
+            liveness_stats_.liveness_ms += result.timings.liveness_ms;
+        } else {
+            result.liveness = liveness_decision_;
+            ++liveness_stats_.skipped_frames;
+        }
+        result.is_real = result.liveness == LivenessDecision::REAL;
+        result.liveness_frames = liveness_frames_;
+        result.liveness_checked = true;
+    } else if (want_liveness) {
+        stage_start = Clock::now();
+        result.is_real = predict(image, result.face, result.points.data(), liveness_threshold);
+        result.liveness = result.is_real ? LivenessDecision::REAL : LivenessDecision::SPOOF;
+        result.liveness_inferred = true;
+        result.liveness_checked = true;
+        result.timings.liveness_ms = elapsed_ms(stage_start);
+    }
+
+    // 视频模式结论未定时仍提取特征，由调用方暂存，结论为 REAL 后再计入
+    if (want_features && (!result.liveness_checked || result.liveness != LivenessDecision::SPOOF)) {
+        stage_start = Clock::now();
+        result.features = result.aligned ? extract(*result.aligned) : nullptr;
+        result.timings.extract_ms = elapsed_ms(stage_start);
+    }
+
+    finish();
+    return result;
+}
+
+/**
+ * @brief 排序第 2..max_faces 的人脸：按阶段成批处理（先全部关键点，再全部对齐与质量，最后全部特征提取）
+ *
+ * 过小或质量不达标的候选不提取特征；候选人脸不做活体检测，被调用方选中后经 focus_face 提到首位再做。
+ */
+void seetaface::analyze_candidates(const SeetaImageData& image, const std::vector<RankedFace>& ranked,
+                                   bool want_quality, FrameAnalysis& result) {
+    const size_t count = std::min(ranked.size(), static_cast<size_t>(std::max(1, ranking_.max_faces)));
+    result.candidates.clear();
+    for (size_t i = 1; i < count; ++i) {
+        FaceCandidate candidate;
+        candidate.face = ranked[i].info.pos;
+        candidate.face_score = ranked[i].info.score;
+        candidate.rank_score = ranked[i].rank_score;
+        if (want_quality && !FaceQualityScorer::SizeAcceptable(candidate.face, quality_gate_)) {
+            candidate.quality_checked = true;
+            candidate.quality.face_size = std::min(candidate.face.width, candidate.face.height);
+            candidate.quality.issue = QualityIssue::TOO_SMALL;
+        }
+        result.candidates.push_back(std::move(candidate));
+    }
+
+    for (auto& candidate : result.candidates) {
+        if (candidate.quality_checked) continue;
+        candidate.points = mark(image, candidate.face);
+    }
+
+    for (auto& candidate : result.candidates) {
+        if (candidate.quality_checked) continue;
+        candidate.aligned = align(image, candidate.face, candidate.points);
+        if (want_quality) {
+            const int point_count = static_cast<int>(candidate.points.size());
+            candidate.quality = candidate.aligned
+                ? quality_scorer_.ScoreAligned(*candidate.aligned, candidate.points.data(), point_count, quality_gate_)
+                : quality_scorer_.Score(image, candidate.face, candidate.points.data(), point_count, quality_gate_);
+            candidate.quality_checked = true;
+        }
+    }
+
+    for (auto& candidate : result.candidates) {
+        if (!candidate.aligned || (candidate.quality_checked && !candidate.quality.passed())) continue;
+        candidate.features = extract(*candidate.aligned);
+    }
+}
+
+void seetaface::set_tracking(const TrackingOptions& options) {
+    tracking_ = options;
+    if (tracking_.refresh_interval < 1) tracking_.refresh_interval = 1;
+    if (tracking_.roi_expand < 0.0f) tracking_.roi_expand = 0.0f;
+    reset_tracking();
+}
+
+void seetaface::reset_tracking() {
+    has_track_ = false;
+    clear_focus();
+    frames_since_full_ = 0;
+    tracking_stats_ = TrackingStats{};
+}
+
+TrackingStats seetaface::tracking_stats() const {
+    return tracking_stats_;
+}
+
+void seetaface::reset_aligned_cache() {
+    aligned_cache_.Clear();
+}
+
+AlignedFaceCacheStats seetaface::aligned_cache_stats() const {
+    return aligned_cache_.stats();
+}
+
+void seetaface::set_face_ranking(const FaceRankOptions& options) {
+    ranking_ = options;
+    ranking_.max_faces = std::clamp(ranking_.max_faces, 1, 8);
+    // 每帧最多持有 max_faces 份对齐结果，缓存至少再多留一个位置才能稳定复用
+    aligned_cache_ = AlignedFaceCache(std::max<size_t>(4, static_cast<size_t>(ranking_.max_faces) + 1));
+    clear_focus();
+}
+
+FaceRankOptions seetaface::face_ranking() const {
+    return ranking_;
+}
+
+void seetaface::focus_face(const SeetaRect& face) {
+    focus_ = face;
+    has_focus_ = true;
+}
+
+void seetaface::clear_focus() {
+    has_focus_ = false;
+    last_face_count_ = 0;
+}
+
+void seetaface::set_liveness_session(const LivenessSessionOptions& options) {
+    liveness_session_ = options;
+    liveness_session_.video_frames = std::max(1, liveness_session_.video_frames);
+    liveness_session_.frame_budget = std::max(liveness_session_.video_frames, liveness_session_.frame_budget);
+    reset_liveness_session();
+}
+
+void seetaface::reset_liveness_session() {
+    restart_liveness();
+    liveness_stats_ = LivenessSessionStats{};
+}
+
+LivenessSessionStats seetaface::liveness_session_stats() const {
+    return liveness_stats_;
+}
+
+void seetaface::restart_liveness() {
+    liveness_decision_ = LivenessDecision::PENDING;
+    liveness_started_ = false;
+    liveness_frames_ = 0;
+}
+
+void seetaface::set_detect_scale(float scale) {
+    detect_scale_ = std::clamp(scale, 0.25f, 1.0f);
+}
+
+float seetaface::detect_scale() const {
+    return detect_scale_;
+}
+
+void seetaface::set_num_threads(int threads) {
+    num_threads_ = std::max(0, threads);
+    if (num_threads_ == 0) return;
+    pFD->set(seeta::FaceDetector::PROPERTY_NUMBER_THREADS, num_threads_);
+    pFR->set(seeta::FaceRecognizer::PROPERTY_NUMBER_THREADS, num_threads_);
+    std::lock_guard<std::mutex> lock(fas_mutex_);
+    if (pFAS != nullptr) {
+        pFAS->set(seeta::FaceAntiSpoofing::PROPERTY_NUMBER_THREADS, num_threads_);
+    }
+}
+
+int seetaface::num_threads() const {
+    return num_threads_;
+}
+
+void seetaface::set_quality_gate(const QualityThresholds& thresholds) {
+    quality_gate_ = thresholds;
+}
+
+QualityThresholds seetaface::quality_gate() const {
+    return quality_gate_;
+}
+
+void seetaface::reset_session_state() {
+    set_tracking(TrackingOptions{});
+    set_liveness_session(LivenessSessionOptions{});
+    set_face_ranking(FaceRankOptions{});
+    quality_gate_ = QualityThresholds{};
+}
+
+/**
+ * @brief 在整帧的指定区域内检测人脸，结果为整帧坐标
+ *
+ * detect_scale_ < 1 时区域直接从整帧缩小到 scaled_buffer_（无需先裁剪）；
+ * 否则区域为整帧时原样送入检测器，为子区域时复制到 roi_buffer_。
+ * 缩小后短边过小会漏检小脸，此时放弃缩放。
+ *
+ * @param image 整帧图像
+ * @param region 检测区域（整帧坐标）
+ * @return std::vector<SeetaFaceInfo> 检测结果，已映射回整帧坐标
+ */
+std::vector<SeetaFaceInfo> seetaface::detect_region(const SeetaImageData& image, const SeetaRect& region) {
+    constexpr int kMinScaledSide = 80;  // 检测器最小人脸 20 像素，保证缩小后仍可容纳
+
+    const size_t pixel_stride = static_cast<size_t>(image.channels);
+    const size_t frame_row_bytes = static_cast<size_t>(image.width) * pixel_stride;
+    const unsigned char* region_origin = image.data + static_cast<size_t>(region.y) * frame_row_bytes +
+                                         static_cast<size_t>(region.x) * pixel_stride;
+    const bool whole_frame = region.x == 0 && region.y == 0 &&
+                             region.width == image.width && region.height == image.height;
+
+    SeetaImageData input{};
+    input.channels = image.channels;
+    const int scaled_width = static_cast<int>(std::lround(region.width * detect_scale_));
+    const int scaled_height = static_cast<int>(std::lround(region.height * detect_scale_));
+    if (detect_scale_ < 1.0f && image.channels == 3 &&
+        std::min(scaled_width, scaled_height) >= kMinScaledSide &&
+        scaled_width < region.width && scaled_height < region.height) {
+        scaled_buffer_.resize(static_cast<size_t>(scaled_width) * scaled_height * 3);
+        DownscaleRgb24(region_origin, static_cast<int>(frame_row_bytes), region.width, region.height,
+                       scaled_buffer_.data(), scaled_width * 3, scaled_width, scaled_height);
+        input.width = scaled_width;
+        input.height = scaled_height;
+        input.data = scaled_buffer_.data();
+    } else if (whole_frame) {
+        input = image;
+    } else {
+        const size_t row_bytes = static_cast<size_t>(region.width) * pixel_stride;
+        roi_buffer_.resize(row_bytes * region.height);
+        for (int y = 0; y < region.height; ++y) {
+            std::memcpy(roi_buffer_.data() + y * row_bytes, region_origin + y * frame_row_bytes, row_bytes);
+        }
+        input.width = region.width;
+        input.height = region.height;
+        input.data = roi_buffer_.data();
+    }
+
+    const SeetaFaceInfoArray detected = pFD->detect(input);
+    std::vector<SeetaFaceInfo> faces(detected.data, detected.data + std::max(0, detected.size));
+
+    // 检测坐标 -> 整帧坐标：先按缩放比例放大，再加上区域偏移，最后裁剪到画面内
+    const double scale_x = static_cast<double>(region.width) / input.width;
+    const double scale_y = static_cast<double>(region.height) / input.height;
+    for (auto& face : faces) {
+        SeetaRect& pos = face.pos;
+        const int x0 = std::clamp(region.x + static_cast<int>(std::lround(pos.x * scale_x)), 0, image.width);
+        const int y0 = std::clamp(region.y + static_cast<int>(std::lround(pos.y * scale_y)), 0, image.height);
+        const int x1 = std::clamp(region.x + static_cast<int>(std::lround((pos.x + pos.width) * scale_x)), 0, image.width);
+        const int y1 = std::clamp(region.y + static_cast<int>(std::lround((pos.y + pos.height) * scale_y)), 0, image.height);
+        pos = SeetaRect{x0, y0, x1 - x0, y1 - y0};
+    }
+    return faces;
+}
+
+/**
+ * @brief 按跟踪状态选择整帧检测或 ROI 检测
+ *
+ * ROI 为上一帧人脸框向四周外扩 roi_expand 倍后与画面求交，仅对该区域运行检测。
+ * ROI 未命中时同一帧立即回退整帧检测。两种检测都遵循 detect_scale_。
+ *
+ * @param image 整帧图像
+ * @param roi_used 输出：返回结果是否来自 ROI 检测
+ * @return std::vector<SeetaFaceInfo> 检测结果（整帧坐标）
+ */
+std::vector<SeetaFaceInfo> seetaface::detect_tracked(const SeetaImageData& image, bool& roi_used) {
+    using Clock = std::chrono::steady_clock;
+    roi_used = false;
+
+    auto full_detect = [&]() {
+        const auto start = Clock::now();
+        std::vector<SeetaFaceInfo> faces = detect_region(image, SeetaRect{0, 0, image.width, image.height});
+        frames_since_full_ = 0;
+        if (tracking_.enabled) {
+            ++tracking_stats_.full_detections;
+            tracking_stats_.full_detect_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+        return faces;
+    };
+
+    const bool refresh_due = ++frames_since_full_ >= tracking_.refresh_interval;
+    // 多人脸模式下上次整帧检测看到多张人脸时，ROI 会漏掉其余候选，继续整帧检测
+    const bool multi_face_in_view = ranking_.max_faces > 1 && last_face_count_ > 1;
+    if (!tracking_.enabled || !has_track_ || refresh_due || multi_face_in_view) {
+        return full_detect();
+    }
+
+    const int pad_x = static_cast<int>(last_face_.width * tracking_.roi_expand);
+    const int pad_y = static_cast<int>(last_face_.height * tracking_.roi_expand);
+    const int x0 = std::max(0, last_face_.x - pad_x);
+    const int y0 = std::max(0, last_face_.y - pad_y);
+    const int x1 = std::min(image.width, last_face_.x + last_face_.width + pad_x);
+    const int y1 = std::min(image.height, last_face_.y + last_face_.height + pad_y);
+    // ROI 覆盖大半画面时裁剪没有收益
+    if (x1 - x0 <= 0 || y1 - y0 <= 0 ||
+        static_cast<long long>(x1 - x0) * (y1 - y0) * 2 > static_cast<long long>(image.width) * image.height) {
+        return full_detect();
+    }
+
+    const auto roi_start = Clock::now();
+    std::vector<SeetaFaceInfo> faces = detect_region(image, SeetaRect{x0, y0, x1 - x0, y1 - y0});
+    ++tracking_stats_.roi_detections;
+    tracking_stats_.roi_detect_ms += std::chrono::duration<double, std::milli>(Clock::now() - roi_start).count();
+
+    if (!faces.empty()) {
+        ++tracking_stats_.roi_hits;
+        roi_used = true;
+        return faces;
+    }
+    return full_detect();
 }
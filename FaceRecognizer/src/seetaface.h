@@ -6,16 +6,191 @@
 #include <seeta/FaceRecognizer.h>
 #include <seeta/FaceLandmarker.h>
 #include <seeta/FaceAntiSpoofing.h>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "exceptions.h"
+#include "aligned_face.h"
+#include "face_quality.h"
+#include "face_ranking.h"
 
 
 // 活体检测模型
 seeta::FaceAntiSpoofing *new_fas_v2();
 
+/**
+ * @brief analyze() 需要执行的阶段
+ *
+ * 检测总是执行；LIVENESS / FEATURES / QUALITY_GATE 隐含 LANDMARKS。
+ * QUALITY_GATE：人脸质量未达到 set_quality_gate 设定的门限时跳过活体与特征提取。
+ */
+enum class AnalysisFlags : uint32_t {
+    DETECT_ONLY = 0,
+    LANDMARKS = 1u << 0,
+    LIVENESS = 1u << 1,
+    FEATURES = 1u << 2,
+    QUALITY_GATE = 1u << 3,
+    ALL = LANDMARKS | LIVENESS | FEATURES,
+};
+
+constexpr AnalysisFlags operator|(AnalysisFlags lhs, AnalysisFlags rhs) {
+    return static_cast<AnalysisFlags>(static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
+}
+
+constexpr bool HasFlag(AnalysisFlags flags, AnalysisFlags flag) {
+    return (static_cast<uint32_t>(flags) & static_cast<uint32_t>(flag)) != 0;
+}
+
+/**
+ * @brief 视频模式活体检测的结论
+ */
+enum class LivenessDecision : uint8_t {
+    PENDING = 0,  // 模型仍在累积帧（DETECTING / FUZZY）
+    REAL,
+    SPOOF,
+};
+
+const char* LivenessDecisionName(LivenessDecision decision);
+
+/**
+ * @brief 视频模式活体会话参数
+ *
+ * 启用后同一跟踪人脸的连续帧送入 FaceAntiSpoofing::PredictVideo 累积判定，复用本帧已算出的
+ * 检测框与关键点；模型给出 REAL / SPOOF，或送入帧数达到 frame_budget（按最后一帧分数判定）后
+ * 结论固定，此后该人脸不再运行活体推理。人脸丢失或人脸框与上一帧不重叠时视为新的人脸，重新累积。
+ */
+struct LivenessSessionOptions {
+    bool enabled = false;
+    int video_frames = 10;   // 模型判定所需的帧数（SetVideoFrameCount）
+    int frame_budget = 20;   // 单个人脸最多送入的帧数
+};
+
+/**
+ * @brief 视频模式活体统计
+ */
+struct LivenessSessionStats {
+    int sessions = 0;          // 开始累积的人脸数（含跟丢后重新开始）
+    int inferred_frames = 0;   // 实际运行活体推理的帧数
+    int skipped_frames = 0;    // 结论已定而跳过推理的帧数
+    int real = 0;
+    int spoof = 0;
+    int budget_decisions = 0;  // 帧预算用尽后按分数判定的次数
+    double liveness_ms = 0.0;  // 活体推理累计耗时
+};
+
+/**
+ * @brief 单帧各阶段耗时（毫秒）
+ */
+struct StageTimings {
+    double detect_ms = 0.0;
+    double landmark_ms = 0.0;
+    double align_ms = 0.0;
+    double quality_ms = 0.0;
+    double liveness_ms = 0.0;
+    double extract_ms = 0.0;
+    double candidates_ms = 0.0;  // 其余候选人脸的关键点、对齐、质量与特征提取
+    double total_ms = 0.0;
+};
+
+/**
+ * @brief 排在首位之外的候选人脸：只做关键点、对齐、质量与特征提取，不做活体
+ */
+struct FaceCandidate {
+    SeetaRect face{0, 0, 0, 0};
+    float face_score = 0.0f;
+    float rank_score = 0.0f;
+    std::vector<SeetaPointF> points;
+    bool quality_checked = false;
+    FaceQuality quality;
+    std::shared_ptr<const AlignedFace> aligned;
+    std::shared_ptr<float> features;  // 质量不达标时为空
+};
+
+/**
+ * @brief 单帧分析结果：检测 / 关键点只计算一次，供活体与特征提取共用
+ */
+struct FrameAnalysis {
+    bool face_found = false;
+    int faces_detected = 0;
+    SeetaRect face{0, 0, 0, 0};   // 排序首位的人脸，活体与特征均针对该人脸
+    float face_score = 0.0f;
+    float rank_score = 0.0f;
+    std::vector<SeetaPointF> points;
+    bool quality_checked = false;
+    FaceQuality quality;          // quality_checked 为 true 时有效
+    bool liveness_checked = false;
+    // 请求了活体但模型不可用（缺失或加载失败）：本帧不做后续阶段、不提取特征，调用方应按错误处理
+    bool liveness_unavailable = false;
+    bool is_real = false;
+    LivenessDecision liveness = LivenessDecision::PENDING;  // 视频模式下可能为 PENDING，is_real 为 false
+    bool liveness_inferred = false;  // 本帧实际运行了活体推理（视频模式结论已定时为 false）
+    int liveness_frames = 0;         // 视频模式下当前人脸已送入活体模型的帧数，1 表示换脸后重新累积
+    std::shared_ptr<float> features;
+    // 对齐人脸：请求质量门限或特征时生成一次，质量评估、特征提取与调用方（如录入缩略图）共用
+    std::shared_ptr<const AlignedFace> aligned;
+    bool roi_detection = false;  // 本帧检测仅在上一帧人脸附近的 ROI 内进行
+    // 排序第 2..max_faces 的人脸（请求 FEATURES 且 max_faces > 1 时），供调用方一次与图库比对
+    std::vector<FaceCandidate> candidates;
+    StageTimings timings;
+};
+
+/**
+ * @brief 帧间人脸跟踪参数
+ *
+ * 命中后下一帧只在上次人脸外扩的 ROI 内检测；ROI 未命中或每隔 refresh_interval 帧
+ * 回退到整帧检测，避免跟丢或漏掉新进入画面的人脸。
+ */
+struct TrackingOptions {
+    bool enabled = false;
+    int refresh_interval = 10;   // 每 N 帧强制整帧检测一次
+    float roi_expand = 0.5f;     // ROI 在人脸框四周各外扩的比例（相对人脸宽高）
+};
+
+/**
+ * @brief 跟踪统计：ROI 命中率与检测耗时对比
+ */
+struct TrackingStats {
+    int full_detections = 0;
+    int roi_detections = 0;
+    int roi_hits = 0;
+    double full_detect_ms = 0.0;  // 整帧检测累计耗时
+    double roi_detect_ms = 0.0;   // ROI 检测累计耗时（含裁剪）
+
+    double roi_hit_rate() const {
+        return roi_detections > 0 ? static_cast<double>(roi_hits) / roi_detections : 0.0;
+    }
+    double avg_full_ms() const {
+        return full_detections > 0 ? full_detect_ms / full_detections : 0.0;
+    }
+    double avg_roi_ms() const {
+        return roi_detections > 0 ? roi_detect_ms / roi_detections : 0.0;
+    }
+};
+
+/**
+ * @brief 各模型加载耗时（毫秒）
+ *
+ * 检测 / 关键点 / 识别模型并行加载，total_ms 为构造函数的实际等待时间；
+ * 活体模型在后台或首次使用时加载，不计入 total_ms。
+ */
+struct ModelLoadTimings {
+    double detector_ms = 0.0;
+    double landmarker_ms = 0.0;
+    double recognizer_ms = 0.0;
+    double anti_spoofing_ms = 0.0;
+    double total_ms = 0.0;
+};
+
 
 class seetaface {
 public:
-    seetaface();
+    /**
+     * @param preload_liveness 为 true 时在后台预加载活体模型（对应 config.liveness）；
+     *                         为 false 时仅在首次活体检测请求时加载
+     */
+    explicit seetaface(bool preload_liveness = true);
     ~seetaface();
 
     std::shared_ptr<float> img2features(SeetaImageData cap_img);
@@ -25,6 +200,49 @@ public:
     float feat_compare(std::shared_ptr<float> feat1, std::shared_ptr<float> feat2);
     bool anti_face(const SeetaImageData& image, float liveness_threshold);
     SeetaRect detect(SeetaImageData cap_img);
+    // 整帧检测并按 set_face_ranking 的权重排序，返回全部人脸
+    std::vector<RankedFace> detect_all(const SeetaImageData& image);
+    FrameAnalysis analyze(const SeetaImageData& image, AnalysisFlags flags, float liveness_threshold = 0.8f);
+    ModelLoadTimings load_timings() const;
+
+    // 帧间跟踪：每次识别会话开始时调用 set_tracking 会同时清空跟踪状态与统计
+    void set_tracking(const TrackingOptions& options);
+    void reset_tracking();
+    TrackingStats tracking_stats() const;
+
+    // 对齐人脸缓存：保留最近几次对齐结果并复用其缓冲区，每次识别会话开始时可清空
+    void reset_aligned_cache();
+    AlignedFaceCacheStats aligned_cache_stats() const;
+
+    // 视频模式活体：每次识别会话开始时调用，同时清空累积状态与统计；enabled 为 false 时回到单帧判定
+    void set_liveness_session(const LivenessSessionOptions& options);
+    void reset_liveness_session();
+    LivenessSessionStats liveness_session_stats() const;
+
+    // 检测缩放：检测器在按比例缩小的副本上运行，人脸框映射回原图后再做关键点与特征提取。
+    // 取值范围 [0.25, 1.0]，1.0 表示不缩放
+    void set_detect_scale(float scale);
+    float detect_scale() const;
+
+    // 单个引擎内部推理线程数（检测 / 识别 / 活体模型的 PROPERTY_NUMBER_THREADS），<= 0 表示保持 SeetaFace 默认值。
+    // 多引擎并行时应按 逻辑核数 / 引擎数 设置，避免线程超额订阅
+    void set_num_threads(int threads);
+    int num_threads() const;
+
+    // 多人脸：analyze 对排序前 max_faces 个人脸做特征提取；跟踪开启时首位人脸在后续帧中保持首位（focus），
+    // 调用方可用 focus_face 把另一张候选人脸提到首位（如与图库匹配的那张），clear_focus 恢复按权重排序
+    void set_face_ranking(const FaceRankOptions& options);
+    FaceRankOptions face_ranking() const;
+    void focus_face(const SeetaRect& face);
+    void clear_focus();
+
+    // 质量门限：仅对带 AnalysisFlags::QUALITY_GATE 的 analyze 调用生效
+    void set_quality_gate(const QualityThresholds& thresholds);
+    QualityThresholds quality_gate() const;
+
+    // 恢复会话级设置的默认值：关闭跟踪与视频模式活体、默认质量门限与多人脸排序，清空对齐缓存。
+    // 引擎归还引擎池时调用，下一个租约不会继承上一个会话的 ROI 或未结束的活体会话
+    void reset_session_state();
 
 private:
     seeta::FaceDetector* pFD = nullptr;
@@ -39,10 +257,64 @@ private:
     std::string model_path_fas1;
     std::string model_path_fas2;
 
-    std::shared_ptr<float> extract(const SeetaImageData& image, const std::vector<SeetaPointF>& points);
+    // 活体模型延迟加载状态
+    mutable std::mutex fas_mutex_;
+    std::future<seeta::FaceAntiSpoofing*> fas_future_;
+    double fas_background_ms_ = 0.0;  // 后台线程写入，future 就绪后才读取
+    bool fas_available_ = false;
+    ModelLoadTimings load_timings_;
+
+    bool ensure_anti_spoofing();
+
+    // 帧间跟踪状态
+    TrackingOptions tracking_;
+    TrackingStats tracking_stats_;
+    bool has_track_ = false;
+    SeetaRect last_face_{0, 0, 0, 0};
+    int frames_since_full_ = 0;
+    std::vector<unsigned char> roi_buffer_;
+
+    // 视频模式活体状态
+    LivenessSessionOptions liveness_session_;
+    LivenessSessionStats liveness_stats_;
+    LivenessDecision liveness_decision_ = LivenessDecision::PENDING;
+    bool liveness_started_ = false;
+    int liveness_frames_ = 0;
+    SeetaRect liveness_face_{0, 0, 0, 0};
+
+    int num_threads_ = 0;
+    AlignedFaceCache aligned_cache_;
+
+    // 多人脸排序状态
+    FaceRankOptions ranking_;
+    bool has_focus_ = false;
+    SeetaRect focus_{0, 0, 0, 0};
+    size_t last_face_count_ = 0;
+
+    // 缩放检测状态
+    float detect_scale_ = 1.0f;
+    std::vector<unsigned char> scaled_buffer_;
+
+    // 质量评估状态
+    QualityThresholds quality_gate_;
+    FaceQualityScorer quality_scorer_;
+
+    std::vector<SeetaFaceInfo> detect_tracked(const SeetaImageData& image, bool& roi_used);
+    std::vector<SeetaFaceInfo> detect_region(const SeetaImageData& image, const SeetaRect& region);
+
+    std::shared_ptr<const AlignedFace> align(const SeetaImageData& image, const SeetaRect& face,
+                                             const std::vector<SeetaPointF>& points);
+    std::shared_ptr<float> extract(const AlignedFace& aligned);
+    void analyze_candidates(const SeetaImageData& image, const std::vector<RankedFace>& ranked,
+                            bool want_quality, FrameAnalysis& result);
     std::vector<SeetaPointF> mark(const SeetaImageData& image, const SeetaRect& face);
     bool predict(const SeetaImageData& image,
                  const SeetaRect& face,
                  const SeetaPointF* points,
                  float liveness_threshold);
+    LivenessDecision predict_video(const SeetaImageData& image,
+                                   const SeetaRect& face,
+                                   const SeetaPointF* points,
+                                   float liveness_threshold);
+    void restart_liveness();
 };
@@ -0,0 +1,413 @@
+// kernel_tests.cpp
+// 纯计算内核的回归测试：像素转换、预览帧编解码、特征运算、多帧融合、质量评估与运动门控。
+// 不依赖识别模型与摄像头；任一检查失败时返回非零退出码（xmake test / CI 据此判定）。
+
+#include "embedding_fusion.h"
+#include "face_quality.h"
+#include "motion_gate.h"
+
+import pixel_convert;
+import frame_codec;
+import feature_math;
+import std;
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++g_failures;
+        std::println("[Test] FAIL {}", what);
+    }
+}
+
+std::vector<std::uint8_t> RandomBytes(std::mt19937& rng, std::size_t size) {
+    std::vector<std::uint8_t> bytes(size);
+    for (auto& b : bytes) b = static_cast<std::uint8_t>(rng());
+    return bytes;
+}
+
+std::vector<float> RandomFeature(std::mt19937& rng, std::size_t dim) {
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> feature(dim);
+    for (auto& v : feature) v = dist(rng);
+    return feature;
+}
+
+// 单一颜色的 RGB24 图像
+std::vector<std::uint8_t> SolidRgb(int width, int height, std::uint8_t value) {
+    return std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 3, value);
+}
+
+SeetaImageData ImageView(std::vector<std::uint8_t>& pixels, int width, int height) {
+    return SeetaImageData{width, height, 3, pixels.data()};
+}
+
+// ---------------------------------------------------------------- pixel_convert
+
+void TestPixelConvert() {
+    std::mt19937 rng(1);
+
+    // BT.601 有限范围参考值
+    {
+        const std::uint8_t yuy2[] = {16, 128, 235, 128, 81, 90, 81, 240};
+        std::uint8_t rgb[12] = {};
+        SetConvertIsa(ConvertIsa::Scalar);
+        Check(ConvertYuy2ToRgb24(yuy2, 4, rgb, 6, 2, 1), "yuy2 accepts valid args");
+        Check(rgb[0] == 0 && rgb[1] == 0 && rgb[2] == 0, "yuy2 black");
+        Check(rgb[3] == 255 && rgb[4] == 255 && rgb[5] == 255, "yuy2 white");
+        Check(ConvertYuy2ToRgb24(yuy2 + 4, 4, rgb + 6, 6, 2, 1) && rgb[6] == 255 && rgb[7] == 0 && rgb[8] == 0,
+              "yuy2 red");
+        Check(!ConvertYuy2ToRgb24(nullptr, 4, rgb, 6, 2, 1), "yuy2 rejects null source");
+    }
+
+    // BGR24 上下翻转 + 通道重排、BGRA32 丢弃 alpha、亮度
+    {
+        const std::uint8_t bgr[] = {1, 2, 3, 4, 5, 6};  // 1x2，每行一个像素
+        std::uint8_t rgb[6] = {};
+        Check(ConvertBgr24ToRgb24(bgr, 3, rgb, 3, 1, 2, true), "bgr24 flip accepts valid args");
+        Check(rgb[0] == 6 && rgb[1] == 5 && rgb[2] == 4 && rgb[3] == 3 && rgb[4] == 2 && rgb[5] == 1, "bgr24 flip order");
+
+        const std::uint8_t bgra[] = {10, 20, 30, 99};
+        Check(ConvertBgra32ToRgb24(bgra, 4, rgb, 3, 1, 1) && rgb[0] == 30 && rgb[1] == 20 && rgb[2] == 10,
+              "bgra32 order");
+
+        const std::uint8_t white[] = {255, 255, 255, 0, 0, 0};
+        std::uint8_t luma[2] = {};
+        Check(ConvertRgb24ToLuma(white, 6, luma, 2, 2, 1) && luma[0] == 255 && luma[1] == 0, "luma white / black");
+    }
+
+    // 所有可用指令集与标量实现逐位一致（宽度取非向量宽度整数倍，覆盖尾部处理）
+    constexpr int kWidth = 70;
+    constexpr int kHeight = 10;
+    const auto yuy2 = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight * 2);
+    const auto nv12 = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight * 3 / 2);
+    const auto bgra = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight * 4);
+    const auto rgb = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight * 3);
+    const std::uint8_t* uv = nv12.data() + static_cast<std::size_t>(kWidth) * kHeight;
+
+    auto run_all = [&]() {
+        std::vector<std::vector<std::uint8_t>> out(7);
+        out[0].resize(rgb.size());
+        ConvertYuy2ToRgb24(yuy2.data(), kWidth * 2, out[0].data(), kWidth * 3, kWidth, kHeight);
+        out[1].resize(rgb.size());
+        ConvertNv12ToRgb24(nv12.data(), kWidth, uv, kWidth, out[1].data(), kWidth * 3, kWidth, kHeight);
+        out[2].resize(rgb.size());
+        ConvertBgr24ToRgb24(rgb.data(), kWidth * 3, out[2].data(), kWidth * 3, kWidth, kHeight, true);
+        out[3].resize(rgb.size());
+        ConvertBgra32ToRgb24(bgra.data(), kWidth * 4, out[3].data(), kWidth * 3, kWidth, kHeight);
+        out[4].resize(static_cast<std::size_t>(kWidth) * kHeight);
+        ConvertRgb24ToLuma(rgb.data(), kWidth * 3, out[4].data(), kWidth, kWidth, kHeight);
+        out[5].resize(static_cast<std::size_t>(kWidth / 2) * (kHeight / 2) * 3);
+        DownscaleRgb24(rgb.data(), kWidth * 3, kWidth, kHeight, out[5].data(), kWidth / 2 * 3, kWidth / 2, kHeight / 2);
+        out[6].resize(static_cast<std::size_t>(kWidth * 3 / 4) * (kHeight * 3 / 4) * 3);
+        DownscaleRgb24(rgb.data(), kWidth * 3, kWidth, kHeight, out[6].data(), kWidth * 3 / 4 * 3,
+                       kWidth * 3 / 4, kHeight * 3 / 4);
+        return out;
+    };
+
+    SetConvertIsa(ConvertIsa::Scalar);
+    const auto reference = run_all();
+    for (const ConvertIsa isa : {ConvertIsa::SSSE3, ConvertIsa::AVX2, ConvertIsa::NEON}) {
+        if (SetConvertIsa(isa) != isa) continue;  // 当前 CPU 不支持
+        const auto output = run_all();
+        static constexpr const char* kNames[] = {"yuy2", "nv12", "bgr24-flip", "bgra32", "luma", "down-half", "down-3/4"};
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            Check(output[i] == reference[i], std::format("pixel_convert {} {} bit-exact vs scalar", kNames[i],
+                                                         ActiveConvertIsaName()));
+        }
+    }
+
+    // 缩小纯色图像仍为纯色；不放大
+    SetConvertIsa(ConvertIsa::Auto);
+    const auto solid = SolidRgb(kWidth, kHeight, 77);
+    std::vector<std::uint8_t> small(static_cast<std::size_t>(kWidth / 3) * (kHeight / 3) * 3);
+    Check(DownscaleRgb24(solid.data(), kWidth * 3, kWidth, kHeight, small.data(), kWidth / 3 * 3, kWidth / 3, kHeight / 3) &&
+              std::ranges::all_of(small, [](std::uint8_t v) { return v == 77; }),
+          "downscale keeps solid color");
+    Check(!DownscaleRgb24(solid.data(), kWidth * 3, kWidth, kHeight, small.data(), kWidth * 6, kWidth * 2, kHeight),
+          "downscale rejects upscaling");
+}
+
+// ---------------------------------------------------------------- frame_codec
+
+void TestFrameCodec() {
+    namespace codec = smile2unlock::codec;
+    std::mt19937 rng(2);
+
+    constexpr int kWidth = 37;
+    constexpr int kHeight = 5;
+    const auto src = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight * 3);
+    std::vector<std::uint8_t> packed(codec::Rgb565Bytes(kWidth, kHeight));
+    std::vector<std::uint8_t> decoded(src.size());
+
+    codec::SetCodecIsa(codec::CodecIsa::Scalar);
+    Check(codec::EncodeRgb565(src.data(), kWidth * 3, kWidth, kHeight, packed.data()), "rgb565 encode");
+    Check(codec::DecodeRgb565(packed.data(), kWidth, kHeight, decoded.data(), kWidth * 3), "rgb565 decode");
+    int max_error[3] = {};
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        max_error[i % 3] = std::max(max_error[i % 3], std::abs(static_cast<int>(src[i]) - static_cast<int>(decoded[i])));
+    }
+    Check(max_error[0] <= 7 && max_error[1] <= 3 && max_error[2] <= 7,
+          std::format("rgb565 round-trip error {}/{}/{}", max_error[0], max_error[1], max_error[2]));
+
+    // 纯白 / 纯黑无偏差
+    const std::uint8_t extremes[] = {255, 255, 255, 0, 0, 0};
+    std::uint8_t extremes_packed[4] = {};
+    std::uint8_t extremes_decoded[6] = {};
+    codec::EncodeRgb565(extremes, 6, 2, 1, extremes_packed);
+    codec::DecodeRgb565(extremes_packed, 2, 1, extremes_decoded, 6);
+    Check(std::ranges::equal(extremes, extremes_decoded), "rgb565 white / black exact");
+    Check(!codec::EncodeRgb565(src.data(), kWidth * 3 - 1, kWidth, kHeight, packed.data()), "rgb565 rejects short stride");
+
+    const auto reference_packed = packed;
+    const auto reference_decoded = decoded;
+    for (const codec::CodecIsa isa : {codec::CodecIsa::SSSE3, codec::CodecIsa::NEON}) {
+        if (codec::SetCodecIsa(isa) != isa) continue;
+        codec::EncodeRgb565(src.data(), kWidth * 3, kWidth, kHeight, packed.data());
+        codec::DecodeRgb565(reference_packed.data(), kWidth, kHeight, decoded.data(), kWidth * 3);
+        Check(packed == reference_packed && decoded == reference_decoded,
+              std::format("rgb565 {} bit-exact vs scalar", codec::ActiveCodecIsaName()));
+    }
+    codec::SetCodecIsa(codec::CodecIsa::Auto);
+}
+
+// ---------------------------------------------------------------- feature_math
+
+void TestFeatureMath() {
+    namespace feature = smile2unlock::feature;
+    std::mt19937 rng(3);
+
+    constexpr std::size_t kDim = 515;
+    constexpr std::size_t kGallery = 7;  // 4 + 3：覆盖 dot4 与尾部
+    const auto probe = RandomFeature(rng, kDim);
+    std::vector<float> gallery;
+    for (std::size_t g = 0; g < kGallery; ++g) {
+        auto row = RandomFeature(rng, kDim);
+        gallery.insert(gallery.end(), row.begin(), row.end());
+    }
+    double expected = 0.0;
+    for (std::size_t i = 0; i < kDim; ++i) expected += static_cast<double>(probe[i]) * gallery[i];
+
+    for (const feature::FeatureIsa isa : {feature::FeatureIsa::Scalar, feature::FeatureIsa::SSE2,
+                                          feature::FeatureIsa::AVX2, feature::FeatureIsa::NEON}) {
+        if (feature::SetFeatureIsa(isa) != isa) continue;
+        const std::string name = feature::ActiveFeatureIsaName();
+
+        const float dot = feature::Dot(probe.data(), gallery.data(), kDim);
+        Check(std::abs(dot - expected) <= 1e-3 * std::max(1.0, std::abs(expected)), std::format("dot {}", name));
+
+        std::vector<float> scores(kGallery);
+        feature::ScoreMatrix(probe.data(), 1, gallery.data(), kGallery, kDim, scores.data());
+        bool consistent = true;
+        for (std::size_t g = 0; g < kGallery; ++g) {
+            const float single = feature::Dot(probe.data(), gallery.data() + g * kDim, kDim);
+            consistent = consistent && std::abs(scores[g] - single) <= 1e-4f * std::max(1.0f, std::abs(single));
+        }
+        Check(consistent, std::format("score matrix matches dot {}", name));
+
+        std::vector<float> scaled = probe;
+        for (float& v : scaled) v *= 2.5f;
+        float similarity = 0.0f;
+        Check(feature::CosineSimilarity(probe.data(), scaled.data(), kDim, similarity) && similarity > 0.9999f,
+              std::format("cosine of scaled vector {}", name));
+        Check(feature::Normalize(scaled.data(), kDim) &&
+                  std::abs(feature::Dot(scaled.data(), scaled.data(), kDim) - 1.0f) < 1e-4f,
+              std::format("normalize {}", name));
+    }
+    feature::SetFeatureIsa(feature::FeatureIsa::Auto);
+
+    const std::vector<float> zero(kDim, 0.0f);
+    float similarity = 1.0f;
+    Check(!feature::CosineSimilarity(probe.data(), zero.data(), kDim, similarity) && similarity == 0.0f,
+          "cosine rejects zero vector");
+
+    std::vector<float> decoded;
+    Check(feature::DecodeFeatureHex("0000803f000000c0", decoded) && decoded.size() == 2 &&
+              decoded[0] == 1.0f && decoded[1] == -2.0f,
+          "decode feature hex");
+    Check(!feature::DecodeFeatureHex("0000803", decoded) && decoded.empty(), "decode feature hex rejects odd length");
+    Check(!feature::DecodeFeatureHex("0000803g", decoded), "decode feature hex rejects bad digit");
+}
+
+// ---------------------------------------------------------------- embedding_fusion
+
+void TestFusion() {
+    Check(std::abs(FusionWeight(0.9f, nullptr) - 0.9f) < 1e-6f, "fusion weight without quality");
+    FaceQuality quality;
+    quality.sharpness = 50.0f;
+    Check(std::abs(FusionWeight(0.9f, &quality) - 0.45f) < 1e-6f, "fusion weight halves at half sharpness");
+    quality.yaw = 0.5f;
+    Check(FusionWeight(0.9f, &quality) > 0.0f && FusionWeight(0.9f, &quality) < 0.01f, "fusion weight floor for side face");
+
+    const std::vector<float> e1 = {1.0f, 0.0f, 0.0f, 0.0f};
+    const std::vector<float> e2 = {0.0f, 1.0f, 0.0f, 0.0f};
+    const std::vector<float> noisy1 = {3.0f, 0.1f, 0.05f, 0.0f};  // 未归一化，接近 e1
+
+    // 有图库：最佳身份与领先量连续稳定 stable_frames 帧后提前结束
+    EmbeddingFusion fusion;
+    fusion.SetGallery({{1, e1}, {2, e2}});
+    FusionState state = fusion.Add(noisy1.data(), 4, 0.8f);
+    Check(state.has_gallery && state.best_label == 1 && state.decision == FusionDecision::CONTINUE,
+          "fusion first frame picks label");
+    state = fusion.Add(noisy1.data(), 4, 0.8f);
+    Check(state.decision == FusionDecision::CONFIDENT && state.frames == 2, "fusion confident after stable frames");
+    const auto& fused = fusion.fused();
+    const float norm = std::sqrt(std::inner_product(fused.begin(), fused.end(), fused.begin(), 0.0f));
+    Check(std::abs(norm - 1.0f) < 1e-4f, "fused feature is unit length");
+    Check(std::abs(fusion.MatchGallery({fused.data()}, 4).front().score - state.best_score) < 1e-6f,
+          "fused score matches candidate scoring");
+
+    // 维度不一致的帧被忽略
+    const float short_feature[] = {1.0f, 0.0f, 0.0f};
+    Check(fusion.Add(short_feature, 3, 1.0f).frames == 2, "fusion ignores dimension mismatch");
+
+    const std::vector<float> probe2 = {0.1f, 2.0f, 0.0f, 0.0f};
+    const auto matches = fusion.MatchGallery({probe2.data(), nullptr, noisy1.data()}, 4);
+    Check(matches.size() == 3 && matches[0].label == 2 && matches[1].label == -1 && matches[2].label == 1,
+          "match gallery per probe");
+
+    // 无图库：融合特征收敛后提前结束
+    EmbeddingFusion open_set;
+    FusionDecision decision = FusionDecision::CONTINUE;
+    int frames = 0;
+    while (decision == FusionDecision::CONTINUE && frames < 10) {
+        decision = open_set.Add(noisy1.data(), 4, 1.0f).decision;
+        ++frames;
+    }
+    Check(decision == FusionDecision::CONFIDENT && frames == 3, "fusion converges without gallery");
+
+    // 不稳定的输入在 max_frames 处结束
+    FusionOptions options;
+    options.max_frames = 4;
+    EmbeddingFusion unstable(options);
+    unstable.SetGallery({{1, e1}, {2, e2}});
+    const std::vector<float> ambiguous = {1.0f, 1.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 4; ++i) state = unstable.Add(ambiguous.data(), 4, 1.0f);
+    Check(state.decision == FusionDecision::EXHAUSTED, "fusion exhausts on ambiguous identity");
+}
+
+// ---------------------------------------------------------------- face_quality
+
+void TestQuality() {
+    constexpr int kSide = 160;
+    const SeetaRect face{16, 16, 128, 128};
+    QualityThresholds thresholds;
+    FaceQualityScorer scorer;
+
+    auto gray = SolidRgb(kSide, kSide, 128);
+    FaceQuality quality = scorer.Score(ImageView(gray, kSide, kSide), face, nullptr, 0, thresholds);
+    Check(quality.issue == QualityIssue::LOW_CONTRAST && std::abs(quality.brightness - 128.0f) < 0.5f &&
+              quality.contrast < 0.5f,
+          "quality flat gray is low contrast");
+
+    auto dark = SolidRgb(kSide, kSide, 10);
+    Check(scorer.Score(ImageView(dark, kSide, kSide), face, nullptr, 0, thresholds).issue == QualityIssue::TOO_DARK,
+          "quality dark frame");
+
+    const SeetaRect tiny{0, 0, 40, 40};
+    Check(!FaceQualityScorer::SizeAcceptable(tiny, thresholds) &&
+              scorer.Score(ImageView(gray, kSide, kSide), tiny, nullptr, 0, thresholds).issue == QualityIssue::TOO_SMALL,
+          "quality small face");
+
+    // 4 像素棋盘格：亮度居中、对比度与清晰度充足
+    std::vector<std::uint8_t> checker(static_cast<std::size_t>(kSide) * kSide * 3);
+    for (int y = 0; y < kSide; ++y) {
+        for (int x = 0; x < kSide; ++x) {
+            const std::uint8_t v = ((x / 4 + y / 4) % 2) ? 220 : 30;
+            std::fill_n(checker.data() + (static_cast<std::size_t>(y) * kSide + x) * 3, 3, v);
+        }
+    }
+    const SeetaPointF frontal[5] = {{50, 60}, {110, 60}, {80, 90}, {60, 120}, {100, 120}};
+    quality = scorer.Score(ImageView(checker, kSide, kSide), face, frontal, 5, thresholds);
+    Check(quality.passed(), std::format("quality checkerboard passes ({})", QualityIssueName(quality.issue)));
+
+    const SeetaPointF turned[5] = {{50, 60}, {110, 60}, {110, 90}, {60, 120}, {100, 120}};
+    quality = scorer.Score(ImageView(checker, kSide, kSide), face, turned, 5, thresholds);
+    Check(quality.issue == QualityIssue::POSE && std::abs(quality.yaw - 0.5f) < 1e-4f, "quality side face");
+
+    // SIMD 统计与标量逐位一致（均为整数累加）
+    std::mt19937 rng(4);
+    auto noise = RandomBytes(rng, static_cast<std::size_t>(kSide) * kSide * 3);
+    FaceQualityScorer scalar(false);
+    const FaceQuality a = scorer.Score(ImageView(noise, kSide, kSide), face, nullptr, 0, thresholds);
+    const FaceQuality b = scalar.Score(ImageView(noise, kSide, kSide), face, nullptr, 0, thresholds);
+    Check(a.brightness == b.brightness && a.contrast == b.contrast && a.sharpness == b.sharpness,
+          "quality simd matches scalar");
+}
+
+// ---------------------------------------------------------------- motion_gate
+
+void TestMotionGate() {
+    constexpr int kWidth = MotionGate::kPlaneWidth;
+    constexpr int kHeight = MotionGate::kPlaneHeight;
+    std::mt19937 rng(5);
+
+    const auto plane = RandomBytes(rng, static_cast<std::size_t>(kWidth) * kHeight);
+    auto changed = plane;
+    // 只改变第 (2, 1) 个 8x8 块，每个像素差 12
+    for (int y = 8; y < 16; ++y) {
+        for (int x = 16; x < 24; ++x) {
+            std::uint8_t& v = changed[static_cast<std::size_t>(y) * kWidth + x];
+            v = static_cast<std::uint8_t>(v >= 128 ? v - 12 : v + 12);
+        }
+    }
+    for (const bool simd : {false, true}) {
+        Check(MotionGate::MaxBlockDifference(plane.data(), plane.data(), kWidth, kHeight, simd) == 0.0f,
+              std::format("motion identical planes simd={}", simd));
+        Check(MotionGate::MaxBlockDifference(plane.data(), changed.data(), kWidth, kHeight, simd) == 12.0f,
+              std::format("motion single block simd={}", simd));
+    }
+    const auto other = RandomBytes(rng, plane.size());
+    Check(MotionGate::MaxBlockDifference(plane.data(), other.data(), kWidth, kHeight, true) ==
+              MotionGate::MaxBlockDifference(plane.data(), other.data(), kWidth, kHeight, false),
+          "motion simd matches scalar");
+
+    // 参考帧之后：静止跳过、变化放行、到期强制检测
+    constexpr int kFrameWidth = 160;
+    constexpr int kFrameHeight = 120;
+    auto still = SolidRgb(kFrameWidth, kFrameHeight, 100);
+    auto moved = SolidRgb(kFrameWidth, kFrameHeight, 140);
+    MotionGate gate;
+    const auto t0 = MotionGate::Clock::now();
+    Check(gate.ShouldInfer(ImageView(still, kFrameWidth, kFrameHeight), t0), "motion first frame infers");
+    gate.OnInferred(false, t0);
+    Check(!gate.ShouldInfer(ImageView(still, kFrameWidth, kFrameHeight), t0 + std::chrono::milliseconds(10)),
+          "motion still frame skipped");
+    Check(gate.ShouldInfer(ImageView(moved, kFrameWidth, kFrameHeight), t0 + std::chrono::milliseconds(20)),
+          "motion changed frame infers");
+    gate.OnInferred(false, t0 + std::chrono::milliseconds(20));
+    Check(gate.ShouldInfer(ImageView(moved, kFrameWidth, kFrameHeight), t0 + std::chrono::milliseconds(2000)),
+          "motion forced after interval");
+    const MotionGateStats stats = gate.stats();
+    Check(stats.checked == 3 && stats.skipped == 1 && stats.changed == 1 && stats.forced == 1, "motion stats");
+
+    // 检出人脸后清除参考：有人脸期间不做门控
+    gate.OnInferred(true, t0 + std::chrono::milliseconds(2000));
+    Check(gate.ShouldInfer(ImageView(moved, kFrameWidth, kFrameHeight), t0 + std::chrono::milliseconds(2010)),
+          "motion no gating while face present");
+}
+
+} // namespace
+
+int main() {
+    const std::pair<const char*, void (*)()> suites[] = {
+        {"pixel_convert", TestPixelConvert},
+        {"frame_codec", TestFrameCodec},
+        {"feature_math", TestFeatureMath},
+        {"embedding_fusion", TestFusion},
+        {"face_quality", TestQuality},
+        {"motion_gate", TestMotionGate},
+    };
+    for (const auto& [name, run] : suites) {
+        const int before = g_failures;
+        run();
+        std::println("[Test] {:<16} {}", name, g_failures == before ? "ok" : "FAILED");
+    }
+    if (g_failures > 0) {
+        std::println("[Test] {} 项检查失败", g_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include "models/gui_ipc_protocol.h"
 #include "ibackend_service.h"
 #include "utils/windows_security.h"
+#include "utils/shared_region.h"
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -69,8 +70,9 @@ private:
         }
     }
 
-    HANDLE preview_transport_mapping_{nullptr};
-    HANDLE capture_transport_mapping_{nullptr};
+    SharedRegion preview_transport_region_;
+    SharedRegion capture_transport_region_;
+    uint32_t mapping_generation_{0};
 
     static bool build_shared_mapping_security(SECURITY_ATTRIBUTES& sa, SECURITY_DESCRIPTOR& sd, PACL& acl) {
         return windows_security::BuildServiceIpcSecurityAttributes(sa, sd, acl);
@@ -89,70 +91,55 @@ private:
         return ss.str();
     }
 
-    void close_transport_mapping(HANDLE& mapping) {
-        if (mapping != nullptr) {
-            CloseHandle(mapping);
-            mapping = nullptr;
-        }
-    }
-
     bool serialize_preview_via_shared_mapping(
         const std::vector<unsigned char>& image_data,
         int width,
         int height,
         GuiIpcResponse& response,
-        HANDLE& mapping_slot,
+        SharedRegion& region,
         const char* mapping_tag
     ) {
-        close_transport_mapping(mapping_slot);
-
-        SECURITY_ATTRIBUTES sa{};
-        SECURITY_DESCRIPTOR sd{};
-        PACL acl = nullptr;
-        if (!build_shared_mapping_security(sa, sd, acl)) {
-            response.set_error(last_error_message("构建共享内存安全描述符失败").c_str());
-            return false;
-        }
-
-        const std::string mapping_name =
-            std::string("Local\\Smile2Unlock_GuiPreview_") +
-            mapping_tag + "_" + std::to_string(GetCurrentProcessId());
-
         // Validate size fits in DWORD to prevent truncation
         if (image_data.size() > std::numeric_limits<DWORD>::max()) {
             response.set_error("Image data too large for shared memory mapping");
             return false;
         }
-        const DWORD mapping_size = static_cast<DWORD>(image_data.size());
-        mapping_slot = CreateFileMappingA(
-            INVALID_HANDLE_VALUE,
-            &sa,
-            PAGE_READWRITE,
-            0,
-            mapping_size == 0 ? 1 : mapping_size,
-            mapping_name.c_str()
-        );
-        windows_security::FreeSecurityAcl(acl);
-        if (!mapping_slot) {
-            response.set_error(last_error_message("创建 GUI 预览共享内存失败").c_str());
-            return false;
-        }
 
-        void* view = MapViewOfFile(mapping_slot, FILE_MAP_ALL_ACCESS, 0, 0, mapping_size == 0 ? 1 : mapping_size);
-        if (!view) {
-            close_transport_mapping(mapping_slot);
-            response.set_error(last_error_message("映射 GUI 预览共享内存失败").c_str());
-            return false;
+        // 容量足够时复用上一帧的映射，避免每帧创建 / 映射 / 解除映射。
+        // 重建时换用新名称：GUI 可能仍持有旧映射，同名 Create 会失败
+        if (!region.valid() || region.size() < image_data.size()) {
+            region.Reset();
+            const std::string mapping_name =
+                std::string("Local\\Smile2Unlock_GuiPreview_") + mapping_tag + "_" +
+                std::to_string(GetCurrentProcessId()) + "_" + std::to_string(++mapping_generation_);
+
+            SECURITY_ATTRIBUTES sa{};
+            SECURITY_DESCRIPTOR sd{};
+            PACL acl = nullptr;
+            if (!build_shared_mapping_security(sa, sd, acl)) {
+                response.set_error(last_error_message("构建共享内存安全描述符失败").c_str());
+                return false;
+            }
+
+            SharedRegionOptions options;
+            options.security = &sa;
+            region = SharedRegion::Create(mapping_name, image_data.size(), options);
+            windows_security::FreeSecurityAcl(acl);
+            if (!region) {
+                std::ostringstream error;
+                error << "创建 GUI 预览共享内存失败 (GetLastError=" << region.error() << ")";
+                response.set_error(error.str().c_str());
+                return false;
+            }
         }
 
         if (!image_data.empty()) {
-            std::memcpy(view, image_data.data(), image_data.size());
+            std::memcpy(region.data(), image_data.data(), image_data.size());
         }
-        UnmapViewOfFile(view);
 
         std::ostringstream ss;
         ss << "transport=shared_memory\n";
-        ss << "map_name=" << mapping_name << "\n";
+        ss << "map_name=" << region.name() << "\n";
         ss << "width=" << width << "\n";
         ss << "height=" << height << "\n";
         ss << "channels=3\n";
@@ -198,6 +185,10 @@ private:
                 handle_capture_and_add_face(payload, response);
                 break;
                 
+            case GuiIpcCommand::IMPORT_FACE_BATCH:
+                handle_import_face_batch(payload, response);
+                break;
+                
             case GuiIpcCommand::START_CAMERA_PREVIEW:
                 handle_start_camera_preview(response);
                 break;
@@ -409,6 +400,21 @@ private:
             error);
     }
     
+    void handle_import_face_batch(const std::string& payload, GuiIpcResponse& response) {
+        if (payload.empty()) {
+            response.set_error("Empty batch path");
+            return;
+        }
+
+        std::string error;
+        bool success = backend_->ImportFaceBatch(payload, error);
+
+        set_response_text(
+            response,
+            success ? GuiIpcStatus::SUCCESS : GuiIpcStatus::SERVICE_ERROR,
+            error);
+    }
+    
     // ==================== 摄像头/预览 ====================
     
     void handle_start_camera_preview(GuiIpcResponse& response) {
@@ -434,7 +440,7 @@ private:
         std::string error;
         
         if (backend_->GetLatestCameraPreview(image_data, width, height, error)) {
-            serialize_preview_via_shared_mapping(image_data, width, height, response, preview_transport_mapping_, "stream");
+            serialize_preview_via_shared_mapping(image_data, width, height, response, preview_transport_region_, "stream");
         } else {
             set_response_text(response, GuiIpcStatus::SERVICE_ERROR, error);
         }
@@ -446,7 +452,7 @@ private:
         std::string error;
         
         if (backend_->CapturePreviewFrame(image_data, width, height, error)) {
-            serialize_preview_via_shared_mapping(image_data, width, height, response, capture_transport_mapping_, "capture");
+            serialize_preview_via_shared_mapping(image_data, width, height, response, capture_transport_region_, "capture");
         } else {
             set_response_text(response, GuiIpcStatus::SERVICE_ERROR, error);
         }
@@ -37,6 +37,8 @@ public:
     virtual bool GetLatestCameraPreview(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message) = 0;
     virtual bool CapturePreviewFrame(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message) = 0;
     virtual bool CaptureAndAddFace(int user_id, const std::string& remark, std::string& error_message) = 0;
+    // 导入 FaceRecognizer -m batch-extract 生成的特征文件，error_message 同时承载导入摘要
+    virtual bool ImportFaceBatch(const std::string& batch_path, std::string& error_message) = 0;
     virtual bool DeleteFace(int user_id, int face_id, std::string& error_message) = 0;
     virtual bool UpdateFaceRemark(int user_id, int face_id, const std::string& remark, std::string& error_message) = 0;
     virtual std::vector<FaceData> GetUserFaces(int user_id) = 0;
@@ -1,8 +1,10 @@
 #pragma once
 
+#ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN  // 避免 winsock.h 和 winsock2.h 冲突
+#endif
 
-#include "common/models/fr_command_packet.h"
+#include "models/fr_command_packet.h"
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
@@ -23,9 +25,13 @@ namespace managers {
  */
 class UdpClient {
 public:
-    UdpClient(const std::string& host = "127.0.0.1", uint16_t port = 51235)
-        : socket_(io_context_, udp::v4()),
+    /**
+     * @param auth_token 启动守护进程时传入的令牌，随每个命令包发送
+     */
+    UdpClient(const std::string& host, uint16_t port, std::string auth_token)
+        : socket_(io_context_, ::udp::v4()),
           endpoint_(asio::ip::make_address(host), port),
+          auth_token_(std::move(auth_token)),
           sequence_counter_(0) {
     }
 
@@ -52,6 +58,7 @@ public:
             cmd.version = FRCommandPacket::PROTOCOL_VERSION;
             cmd.command_type = static_cast<int32_t>(cmd_type);
             cmd.sequence_id = ++sequence_counter_;
+            strncpy_s(cmd.auth_token, sizeof(cmd.auth_token), auth_token_.c_str(), _TRUNCATE);
             
             memset(cmd.payload, 0, sizeof(cmd.payload));
             strncpy_s(cmd.payload, sizeof(cmd.payload), payload.c_str(), _TRUNCATE);
@@ -65,7 +72,7 @@ public:
 
             // 等待响应（设置超时）
             FRResponsePacket response;
-            udp::endpoint sender_endpoint;
+            ::udp::endpoint sender_endpoint;
             
             socket_.non_blocking(true);
             auto start_time = std::chrono::steady_clock::now();
@@ -79,11 +86,13 @@ public:
                     ec
                 );
 
-                if (!ec && len > 0) {
-                    // 验证响应
-                    if (response.magic_number == FRResponsePacket::MAGIC_NUMBER &&
+                if (!ec && len == sizeof(response)) {
+                    // 验证响应：只接受守护进程命令端口发回的包，其他本机进程伪造的回复直接丢弃
+                    if (sender_endpoint == endpoint_ &&
+                        response.magic_number == FRResponsePacket::MAGIC_NUMBER &&
                         response.sequence_id == cmd.sequence_id) {
                         
+                        response.result_data[sizeof(response.result_data) - 1] = '\0';
                         if (response.status_code == 0) {
                             response_data = std::string(response.result_data);
                             return true;
@@ -129,8 +138,9 @@ public:
 
 private:
     asio::io_context io_context_;
-    udp::socket socket_;
-    udp::endpoint endpoint_;
+    ::udp::socket socket_;
+    ::udp::endpoint endpoint_;
+    std::string auth_token_;
     std::atomic<int32_t> sequence_counter_;
 };
 
@@ -2,6 +2,7 @@
 
 #include "models/gui_ipc_protocol.h"
 #include "ibackend_service.h"
+#include "utils/shared_region.h"
 #include <windows.h>
 #include <string>
 #include <vector>
@@ -188,6 +189,17 @@ public:
         return response->status == static_cast<int32_t>(GuiIpcStatus::SUCCESS);
     }
     
+    bool ImportFaceBatch(const std::string& batch_path, std::string& error_message) override {
+        auto response = std::make_unique<GuiIpcResponse>();
+        
+        if (!send_request(GuiIpcCommand::IMPORT_FACE_BATCH, batch_path, *response)) {
+            error_message = response->payload;
+            return false;
+        }
+        error_message = response->payload;
+        return response->status == static_cast<int32_t>(GuiIpcStatus::SUCCESS);
+    }
+    
     bool DeleteFace(int user_id, int face_id, std::string& error_message) override {
         std::string payload = std::to_string(user_id) + "|" + std::to_string(face_id);
         auto response = std::make_unique<GuiIpcResponse>();
@@ -484,31 +496,20 @@ private:
                 return false;
             }
 
-            HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, map_name.c_str());
-            if (!mapping) {
+            // 映射整个区域并校验其不小于描述的字节数，避免越界读取
+            const SharedRegion region = SharedRegion::Open(map_name, image_bytes, SharedRegionAccess::ReadOnly);
+            if (!region) {
                 std::ostringstream err;
-                err << "OpenFileMapping failed (GetLastError=" << GetLastError() << ")";
+                err << "Open shared preview failed (GetLastError=" << region.error() << ")";
                 error_message = err.str();
                 return false;
             }
 
-            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, image_bytes == 0 ? 1 : image_bytes);
-            if (!view) {
-                std::ostringstream err;
-                err << "MapViewOfFile failed (GetLastError=" << GetLastError() << ")";
-                error_message = err.str();
-                CloseHandle(mapping);
-                return false;
-            }
-
             image_data.clear();
             if (image_bytes > 0) {
-                const auto* bytes = static_cast<const unsigned char*>(view);
+                const auto* bytes = region.as<const unsigned char>();
                 image_data.assign(bytes, bytes + image_bytes);
             }
-
-            UnmapViewOfFile(view);
-            CloseHandle(mapping);
             return true;
         }
 
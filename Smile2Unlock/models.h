@@ -50,6 +50,8 @@ struct FaceRecognizerConfig {
     bool debug{};
     std::string language{"zh-CN"};
     bool auto_update_check{true};
+    bool preview_rgb565{true};   // 实时预览以 RGB565 传输
+    int preview_downscale{1};    // 实时预览宽高各缩小的倍数
 };
 
 } // namespace smile2unlock
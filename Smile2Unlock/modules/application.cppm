@@ -126,6 +126,7 @@ private:
         int selected_user_id{};
         bool show_face_capture{};
         char face_remark[256]{};
+        char face_batch_path[512]{};
         bool save_face_success{};
         GLuint preview_texture{};
         int preview_width{};
@@ -1544,6 +1545,21 @@ void Application::RenderUsersPanel() {
         ui_state_.status_message_timer = 3.0f;
     }
 
+    ImGui::Spacing();
+    RenderSectionHeader(Tr("section_import"), Tr("import_face_batch_title"), Tr("face_batch_hint"));
+    ImGui::PushItemWidth(-1.0f);
+    ImGui::InputText(Tr("face_batch_path"), ui_state_.face_batch_path, sizeof(ui_state_.face_batch_path));
+    ImGui::PopItemWidth();
+    if (ImGui::Button(Tr("import_face_batch_button"), ImVec2(CalcButtonWidth(Tr("import_face_batch_button"), 180.0f), 0))) {
+        std::string summary;
+        if (backend_->ImportFaceBatch(ui_state_.face_batch_path, summary)) {
+            ui_state_.status_message = summary;
+        } else {
+            ui_state_.status_message = DynFormat(Tr("import_failed"), summary);
+        }
+        ui_state_.status_message_timer = 5.0f;
+    }
+
     const std::string edit_popup_name = std::string(Tr("edit_user_title")) + "###EditUserModal";
     if (ui_state_.show_edit_user) {
         ImGui::OpenPopup(edit_popup_name.c_str());
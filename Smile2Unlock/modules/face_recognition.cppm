@@ -6,10 +6,15 @@ module;
 #include <wincrypt.h>
 #include <boost/asio.hpp>
 #include "utils/windows_security.h"
+#include "utils/shared_region.h"
+#include "utils/frame_signal.h"
 
 // 使用统一的 UDP 管理头文件
 #include "managers/ipc/udp/udp_manager.h"
 #include "models/shared_frame_ipc.h"
+#include "models/shared_feature_block.h"
+#include "models/shared_gallery_ipc.h"
+#include "backend/managers/ipc/udp_client.h"
 
 export module smile2unlock.face_recognition;
 
@@ -17,15 +22,12 @@ import std;
 import service_runtime;
 import smile2unlock.models;
 import smile2unlock.database;
+import frame_codec;
 
 namespace fs = std::filesystem;
 
 namespace smile2unlock::managers {
 namespace {
-constexpr DWORD kSharedFrameMappingSize =
-    sizeof(smile2unlock::SharedFrameHeader) +
-    smile2unlock::SharedFrameHeader::MAX_IMAGE_BYTES +
-    smile2unlock::SharedFrameHeader::MAX_FEATURE_BYTES;
 
 const char* ToString(RecognitionStatus status) {
     switch (status) {
@@ -69,6 +71,43 @@ std::string LastErrorText(const char* prefix) {
     return ss.str();
 }
 
+// 本进程内唯一的共享内存名称；SharedRegion::Create 遇到同名区域会失败，不能只靠毫秒时间戳区分
+std::string UniqueMappingName(const char* kind) {
+    static std::atomic<uint32_t> counter{0};
+    return std::string("Local\\Smile2Unlock_") + kind + "_" + std::to_string(GetCurrentProcessId()) + "_" +
+           std::to_string(GetTickCount64()) + "_" + std::to_string(++counter);
+}
+
+// 守护进程命令令牌：每次启动随机生成，失败时返回空串
+std::string GenerateCommandToken() {
+    std::array<unsigned char, FRCommandPacket::AUTH_TOKEN_CHARS / 2> bytes{};
+    HCRYPTPROV provider = 0;
+    if (!CryptAcquireContextA(&provider, nullptr, nullptr, PROV_RSA_AES, CRYPT_VERIFYCONTEXT | CRYPT_SILENT)) {
+        return {};
+    }
+    const bool generated = CryptGenRandom(provider, static_cast<DWORD>(bytes.size()), bytes.data()) != FALSE;
+    CryptReleaseContext(provider, 0);
+    if (!generated) {
+        return {};
+    }
+
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string token;
+    token.reserve(bytes.size() * 2);
+    for (const unsigned char byte : bytes) {
+        token.push_back(kHex[byte >> 4]);
+        token.push_back(kHex[byte & 0x0F]);
+    }
+    return token;
+}
+
+// SharedRegion 失败时保存的 GetLastError
+std::string RegionErrorText(const char* prefix, const SharedRegion& region) {
+    std::ostringstream ss;
+    ss << prefix << " (GetLastError=" << region.error() << ")";
+    return ss.str();
+}
+
 // 使用统一 UDP 类的别名
 using UdpReceiverFromFR = ::smile2unlock::udp::StatusReceiver;
 using UdpSenderToCP = ::smile2unlock::udp::StatusSender;
@@ -80,6 +119,14 @@ constexpr uint16_t kFrStatusPort = ::smile2unlock::udp::UdpPorts::kFrStatusPort;
 constexpr uint16_t kCpStatusPort = ::smile2unlock::udp::UdpPorts::kCpStatusPort;
 constexpr uint16_t kAuthRequestPort = ::smile2unlock::udp::UdpPorts::kAuthRequestPort;
 constexpr uint16_t kPasswordPort = ::smile2unlock::udp::UdpPorts::kPasswordPort;
+constexpr uint16_t kFrCommandPort = ::smile2unlock::udp::UdpPorts::kFrCommandPort;
+
+// 守护进程首次启动需要加载全部模型
+constexpr int kFrDaemonStartupTimeoutMs = 30000;
+constexpr int kFrDaemonPingTimeoutMs = 500;
+constexpr int kFrCommandTimeoutMs = 3000;
+constexpr int kFrCaptureTimeoutMs = 15000;
+constexpr int kCaptureStatusPollMs = 20;
 
 } // anonymous namespace
 } // namespace smile2unlock::managers
@@ -102,7 +149,7 @@ public:
     bool IsPreviewStreamRunning() const;
     bool GetLatestPreviewFrame(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message);
     bool CaptureFrameImage(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message);
-    bool CaptureFrameAndFeature(std::vector<unsigned char>& image_data, int& width, int& height, std::string& feature, std::string& error_message);
+    bool CaptureFrameAndFeature(std::vector<unsigned char>& image_data, int& width, int& height, std::vector<float>& feature, std::string& error_message);
 
     RecognitionResult GetLastResult() const;
     std::string ExtractFaceFeature(const std::string& image_path);
@@ -121,24 +168,35 @@ private:
     PROCESS_INFORMATION fr_process_info_;
     HANDLE fr_stdout_read_;
     HANDLE fr_stderr_read_;
-    HANDLE recognition_result_mapping_;
-    void* recognition_result_view_;
+    SharedRegion recognition_result_region_;
     std::string recognition_result_map_name_;
     std::thread log_thread_;
     bool log_thread_running_;
     HANDLE preview_process_;
     PROCESS_INFORMATION preview_process_info_;
-    HANDLE preview_mapping_;
-    void* preview_view_;
+    SharedRegion preview_region_;
     std::string preview_map_name_;
-    uint32_t last_preview_sequence_;
+    uint32_t last_preview_sequence_;  // 最近一次交给调用方的帧号
+    FrameReadySignal preview_signal_;
+    std::thread preview_reader_thread_;
+    std::atomic<bool> preview_reader_running_;
+    std::mutex preview_frame_mutex_;
+    std::vector<unsigned char> preview_frame_;  // 读取线程最近解码出的 RGB24 帧
+    int preview_frame_width_;
+    int preview_frame_height_;
+    uint32_t preview_frame_sequence_;  // preview_frame_ 的帧号，0 表示尚无帧
+    std::string preview_frame_error_;  // 最近一帧无效时的原因
 
     void ReadSubProcessLogs();
+    void ReadPreviewFrames();
 
     std::unique_ptr<UdpReceiverFromCP> udp_receiver_cp_;
     std::unique_ptr<UdpReceiverFromFR> udp_receiver_fr_;
     std::unique_ptr<UdpSenderToCP> udp_sender_;
     std::unique_ptr<UdpPasswordSenderToCP> udp_password_sender_;
+    std::unique_ptr<UdpClient> fr_command_client_;
+    std::mutex fr_command_mutex_;
+    std::mutex fr_daemon_mutex_;
     std::unique_ptr<smile2unlock::managers::Database> database_;
     FaceRecognizerConfig config_;
 
@@ -146,14 +204,19 @@ private:
     std::string pending_username_hint_;
     std::string last_recognition_feature_;
 
+    bool ensure_fr_daemon(std::string& error_message);
+    bool send_fr_command(FRCommandType type, const std::string& payload, std::string& response, int timeout_ms);
+    void shutdown_fr_daemon();
     bool start_fr_process();
-    bool start_fr_capture_process(const std::string& map_name, bool extract_feature, std::string& error_message);
+    bool create_gallery_mapping(const std::string& username_hint, std::string& map_name, SharedRegion& region);
+    bool start_fr_capture_process(const std::string& map_name, const SharedFrameHeader* header, bool extract_feature, std::string& error_message);
+    bool run_fr_capture_process(const std::string& map_name, bool extract_feature, std::string& error_message);
     bool start_fr_preview_process(const std::string& map_name, std::string& error_message);
     void stop_fr_process();
     void cleanup_fr_process_handles();
     void on_cp_request_received(AuthRequestType type, const std::string& username_hint, uint32_t session_id);
     void on_fr_status_received(RecognitionStatus status, const std::string& username, uint32_t session_id, const std::string& feature);
-    bool capture_shared_payload(std::vector<unsigned char>& image_data, int& width, int& height, std::string* feature, std::string& error_message);
+    bool capture_shared_payload(std::vector<unsigned char>& image_data, int& width, int& height, std::vector<float>* feature, std::string& error_message);
     bool compare_features_on_su(const std::string& feature1, const std::string& feature2, float& similarity);
     std::string resolve_recognized_username(const std::string& probe_feature,
                                             const std::string& username_hint,
@@ -214,21 +277,30 @@ bool DecodeFeatureHex(const std::string& hex, std::vector<float>& feature) {
 
 FaceRecognition::FaceRecognition()
     : initialized_(false), is_running_(false), fr_process_(nullptr), current_session_id_(0),
-      fr_stdout_read_(nullptr), fr_stderr_read_(nullptr), recognition_result_mapping_(nullptr),
-      recognition_result_view_(nullptr), log_thread_running_(false),
-      preview_process_(nullptr), preview_mapping_(nullptr), preview_view_(nullptr), last_preview_sequence_(0) {}
+      fr_stdout_read_(nullptr), fr_stderr_read_(nullptr), log_thread_running_(false),
+      preview_process_(nullptr), last_preview_sequence_(0), preview_reader_running_(false),
+      preview_frame_width_(0), preview_frame_height_(0), preview_frame_sequence_(0) {}
 
 FaceRecognition::~FaceRecognition() {
     StopPreviewStream();
     StopRecognition();
-    stop_fr_process();
+    shutdown_fr_daemon();
 }
 
-bool FaceRecognition::start_fr_process() {
+bool FaceRecognition::ensure_fr_daemon(std::string& error_message) {
+    std::lock_guard<std::mutex> lock(fr_daemon_mutex_);
+    if (fr_process_ && IsProcessHandleActive(fr_process_) && fr_command_client_) {
+        return true;
+    }
+    if (fr_process_) {
+        cleanup_fr_process_handles();
+    }
+
     char exe_path[MAX_PATH];
     GetModuleFileNameA(nullptr, exe_path, MAX_PATH);
     fs::path fr_exe = fs::path(exe_path).parent_path() / "FaceRecognizer.exe";
     if (!fs::exists(fr_exe)) {
+        error_message = "FaceRecognizer.exe 不存在";
         std::cerr << "[FR Manager] FaceRecognizer.exe 不存在: " << fr_exe << std::endl;
         return false;
     }
@@ -236,10 +308,14 @@ bool FaceRecognition::start_fr_process() {
     SECURITY_ATTRIBUTES saAttr{sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
     HANDLE hStdoutWrite = NULL;
     HANDLE hStderrWrite = NULL;
-    if (!CreatePipe(&fr_stdout_read_, &hStdoutWrite, &saAttr, 0)) return false;
+    if (!CreatePipe(&fr_stdout_read_, &hStdoutWrite, &saAttr, 0)) {
+        error_message = LastErrorText("创建 FR 输出管道失败");
+        return false;
+    }
     SetHandleInformation(fr_stdout_read_, HANDLE_FLAG_INHERIT, 0);
     if (!CreatePipe(&fr_stderr_read_, &hStderrWrite, &saAttr, 0)) {
         CloseHandle(hStdoutWrite);
+        error_message = LastErrorText("创建 FR 错误管道失败");
         return false;
     }
     SetHandleInformation(fr_stderr_read_, HANDLE_FLAG_INHERIT, 0);
@@ -251,26 +327,36 @@ bool FaceRecognition::start_fr_process() {
     si.dwFlags |= STARTF_USESTDHANDLES;
     memset(&fr_process_info_, 0, sizeof(fr_process_info_));
 
+    // 令牌只经命令行交给子进程，不写入日志
+    const std::string command_token = GenerateCommandToken();
+    if (command_token.empty()) {
+        CloseHandle(hStdoutWrite);
+        CloseHandle(hStderrWrite);
+        error_message = LastErrorText("生成 FR 命令令牌失败");
+        return false;
+    }
+
     std::ostringstream cmd;
-    cmd << "\"" << fr_exe.string() << "\" -m recognize"
+    cmd << "\"" << fr_exe.string() << "\" -m daemon"
         << " --udp-port " << kFrStatusPort
+        << " --command-port " << kFrCommandPort
+        << " --command-token " << command_token
+        << " --parent-pid " << GetCurrentProcessId()
         << " --camera " << config_.camera
         << " --liveness-detection=" << (config_.liveness ? "true" : "false")
         << " --threshold face=" << config_.face_threshold
         << " --threshold liveness=" << config_.liveness_threshold
         << " --debug=" << (config_.debug ? "true" : "false");
     std::string cmd_line = cmd.str();
-    std::cout << "[SU] Starting FR recognize process"
-              << " session=" << current_session_id_
+    std::cout << "[SU] Starting FR daemon process"
               << " camera=" << config_.camera
               << " liveness=" << (config_.liveness ? 1 : 0)
-              << " face_threshold=" << config_.face_threshold
-              << " liveness_threshold=" << config_.liveness_threshold
-              << " debug=" << (config_.debug ? 1 : 0)
+              << " command_port=" << kFrCommandPort
               << std::endl;
     if (!CreateProcessA(nullptr, cmd_line.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &fr_process_info_)) {
         CloseHandle(hStdoutWrite);
         CloseHandle(hStderrWrite);
+        error_message = LastErrorText("启动 FaceRecognizer 守护进程失败");
         return false;
     }
 
@@ -279,11 +365,211 @@ bool FaceRecognition::start_fr_process() {
     CloseHandle(hStderrWrite);
     log_thread_running_ = true;
     log_thread_ = std::thread(&FaceRecognition::ReadSubProcessLogs, this);
-    Sleep(1500);
+    fr_command_client_ = std::make_unique<UdpClient>("127.0.0.1", kFrCommandPort, command_token);
+
+    // 模型加载完成后守护进程才开始监听命令端口，轮询 PING 直到就绪
+    const auto startup_begin = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startup_begin < std::chrono::milliseconds(kFrDaemonStartupTimeoutMs)) {
+        if (!IsProcessHandleActive(fr_process_)) {
+            error_message = "FaceRecognizer 守护进程启动后退出，请检查 FR 日志";
+            cleanup_fr_process_handles();
+            return false;
+        }
+        std::string response;
+        if (send_fr_command(FRCommandType::PING, "", response, kFrDaemonPingTimeoutMs)) {
+            std::cout << "[SU] FR daemon ready after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - startup_begin).count()
+                      << " ms" << std::endl;
+            return true;
+        }
+    }
+
+    error_message = "等待 FaceRecognizer 守护进程就绪超时";
+    TerminateProcess(fr_process_, 1);
+    cleanup_fr_process_handles();
+    return false;
+}
+
+bool FaceRecognition::send_fr_command(FRCommandType type, const std::string& payload, std::string& response, int timeout_ms) {
+    std::lock_guard<std::mutex> lock(fr_command_mutex_);
+    if (!fr_command_client_) {
+        response = "FR daemon not connected";
+        return false;
+    }
+    return fr_command_client_->send_command(type, payload, response, timeout_ms);
+}
+
+void FaceRecognition::shutdown_fr_daemon() {
+    if (fr_process_) {
+        std::string response;
+        if (IsProcessHandleActive(fr_process_)) {
+            send_fr_command(FRCommandType::SHUTDOWN, "", response, kFrDaemonPingTimeoutMs);
+            if (WaitForSingleObject(fr_process_, 1000) == WAIT_TIMEOUT) {
+                TerminateProcess(fr_process_, 0);
+            }
+        }
+    }
+    cleanup_fr_process_handles();
+}
+
+bool FaceRecognition::start_fr_process() {
+    std::string error_message;
+    if (!ensure_fr_daemon(error_message)) {
+        std::cerr << "[FR Manager] " << error_message << std::endl;
+        return false;
+    }
+
+    // 图库只在命令往返期间有效：FR 回复 START_RECOGNITION 前已完成拷贝
+    std::string gallery_map_name;
+    SharedRegion gallery_region;
+    create_gallery_mapping(pending_username_hint_, gallery_map_name, gallery_region);
+
+    std::ostringstream payload;
+    payload << "camera=" << config_.camera << "\n"
+            << "liveness=" << (config_.liveness ? 1 : 0) << "\n"
+            << "liveness_threshold=" << config_.liveness_threshold << "\n"
+            << "debug=" << (config_.debug ? 1 : 0) << "\n"
+            << "session=" << current_session_id_ << "\n";
+    if (!gallery_map_name.empty()) {
+        payload << "gallery=" << gallery_map_name << "\n";
+    }
+    std::cout << "[SU] Starting FR recognize session"
+              << " session=" << current_session_id_
+              << " camera=" << config_.camera
+              << " liveness=" << (config_.liveness ? 1 : 0)
+              << " face_threshold=" << config_.face_threshold
+              << " liveness_threshold=" << config_.liveness_threshold
+              << " debug=" << (config_.debug ? 1 : 0)
+              << std::endl;
+
+    std::string response;
+    const bool started = send_fr_command(FRCommandType::START_RECOGNITION, payload.str(), response, kFrCommandTimeoutMs);
+    gallery_region.Reset();
+    if (!started) {
+        std::cerr << "[FR Manager] 启动识别会话失败: " << response << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 把候选用户的人脸特征写入只读共享内存，供 FR 多帧融合判断匹配领先量是否稳定。
+// 指定用户存在时只包含该用户，否则包含全部用户；最终匹配仍由 resolve_recognized_username 完成。
+bool FaceRecognition::create_gallery_mapping(const std::string& username_hint, std::string& map_name, SharedRegion& region) {
+    map_name.clear();
+    region.Reset();
+    if (!database_) {
+        return false;
+    }
+
+    std::vector<User> users;
+    if (!username_hint.empty()) {
+        if (auto hinted_user = database_->GetUserByUsername(username_hint); hinted_user.has_value()) {
+            users.push_back(std::move(*hinted_user));
+        }
+    }
+    if (users.empty()) {
+        users = database_->GetAllUsers();
+    }
+
+    std::vector<std::pair<uint32_t, std::vector<float>>> entries;
+    uint32_t dim = 0;
+    for (size_t label = 0; label < users.size(); ++label) {
+        for (const auto& face : users[label].faces) {
+            if (entries.size() >= SharedGalleryHeader::MAX_ENTRIES) break;
+            std::vector<float> feature;
+            if (face.feature.empty() || !DecodeFeatureHex(face.feature, feature)) continue;
+            if (feature.size() > SharedGalleryHeader::MAX_DIM) continue;
+            if (dim == 0) dim = static_cast<uint32_t>(feature.size());
+            if (feature.size() != dim) continue;
+            entries.emplace_back(static_cast<uint32_t>(label), std::move(feature));
+        }
+    }
+    if (entries.empty()) {
+        return false;
+    }
+
+    SECURITY_ATTRIBUTES mapping_sa{};
+    SECURITY_DESCRIPTOR mapping_sd{};
+    PACL mapping_acl = nullptr;
+    if (!BuildSharedMappingSecurity(mapping_sa, mapping_sd, mapping_acl)) {
+        std::cerr << "[SU] " << LastErrorText("构建图库共享内存安全描述符失败") << std::endl;
+        return false;
+    }
+
+    SharedRegionOptions region_options;
+    region_options.security = &mapping_sa;
+    const std::string name = UniqueMappingName("Gallery");
+    SharedRegion gallery = SharedRegion::Create(
+        name, SharedGalleryBytes(static_cast<uint32_t>(entries.size()), dim), region_options);
+    windows_security::FreeSecurityAcl(mapping_acl);
+    if (!gallery) {
+        std::cerr << "[SU] " << RegionErrorText("创建图库共享内存失败", gallery) << std::endl;
+        return false;
+    }
+
+    auto* header = gallery.as<SharedGalleryHeader>();
+    *header = SharedGalleryHeader{};
+    header->entry_count = static_cast<uint32_t>(entries.size());
+    header->dim = dim;
+    header->match_threshold = config_.face_threshold > 0.0f ? config_.face_threshold : kRecognitionThreshold;
+    auto* cursor = reinterpret_cast<unsigned char*>(header + 1);
+    for (const auto& [label, feature] : entries) {
+        std::memcpy(cursor, &label, sizeof(label));
+        std::memcpy(cursor + sizeof(label), feature.data(), feature.size() * sizeof(float));
+        cursor += SharedGalleryEntryBytes(dim);
+    }
+
+    std::cout << "[SU] 识别图库已写入共享内存"
+              << " users=" << users.size()
+              << " entries=" << entries.size()
+              << " dim=" << dim
+              << std::endl;
+    map_name = name;
+    region = std::move(gallery);
     return true;
 }
 
-bool FaceRecognition::start_fr_capture_process(const std::string& map_name, bool extract_feature, std::string& error_message) {
+bool FaceRecognition::start_fr_capture_process(const std::string& map_name, const SharedFrameHeader* header, bool extract_feature, std::string& error_message) {
+    std::string daemon_error;
+    if (!ensure_fr_daemon(daemon_error)) {
+        std::cerr << "[SU] FR 守护进程不可用，回退到一次性抓拍进程: " << daemon_error << std::endl;
+        return run_fr_capture_process(map_name, extract_feature, error_message);
+    }
+
+    std::ostringstream payload;
+    payload << "map=" << map_name << "\n"
+            << "camera=" << config_.camera << "\n"
+            << "extract=" << (extract_feature ? 1 : 0) << "\n";
+    std::cout << "[SU] FR daemon capture"
+              << " camera=" << config_.camera
+              << " extract_feature=" << (extract_feature ? 1 : 0)
+              << std::endl;
+
+    std::string response;
+    if (!send_fr_command(FRCommandType::EXTRACT_FEATURE, payload.str(), response, kFrCommandTimeoutMs)) {
+        error_message = "FaceRecognizer 抓拍失败: " + response;
+        return false;
+    }
+
+    // 守护进程在工作线程上抓拍，命令立即返回；这里按共享内存状态等待结果，不占用命令通道，
+    // 期间锁屏的 STOP / 新的识别请求可以照常下发
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kFrCaptureTimeoutMs);
+    while (LoadSharedFrameStatus(header) == SharedFrameStatus::EMPTY) {
+        if (!IsProcessHandleActive(fr_process_)) {
+            error_message = "FaceRecognizer 守护进程在抓拍期间退出";
+            return false;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            error_message = "等待 FaceRecognizer 抓拍超时";
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(kCaptureStatusPollMs));
+    }
+    return true;
+}
+
+bool FaceRecognition::run_fr_capture_process(const std::string& map_name, bool extract_feature, std::string& error_message) {
     char exe_path[MAX_PATH];
     GetModuleFileNameA(nullptr, exe_path, MAX_PATH);
     fs::path fr_exe = fs::path(exe_path).parent_path() / "FaceRecognizer.exe";
@@ -365,9 +651,7 @@ bool FaceRecognition::start_fr_preview_process(const std::string& map_name, std:
     }
 
     preview_process_ = preview_process_info_.hProcess;
-    auto* header = (preview_view_ != nullptr)
-        ? static_cast<SharedFrameHeader*>(preview_view_)
-        : nullptr;
+    auto* header = preview_region_.as<SharedFrameHeader>();
 
     constexpr int kStartupProbeMs = 2000;
     constexpr int kProbeIntervalMs = 50;
@@ -386,20 +670,21 @@ bool FaceRecognition::start_fr_preview_process(const std::string& map_name, std:
         }
 
         if (header != nullptr) {
-            if (header->magic == SharedFrameHeader::MAGIC &&
-                header->version == SharedFrameHeader::VERSION &&
-                header->status_code == static_cast<int32_t>(SharedFrameStatus::READY) &&
-                header->image_bytes > 0) {
+            const SharedFrameStatus status = LoadSharedFrameStatus(header);
+            if (IsSharedFrameHeaderValid(header) &&
+                status == SharedFrameStatus::READY &&
+                LatestSharedFrameSequence(header) > 0) {
                 return true;
             }
-            if (header->status_code == static_cast<int32_t>(SharedFrameStatus::CAPTURE_FAILED)) {
+            if (status == SharedFrameStatus::CAPTURE_FAILED) {
                 error_message = "FaceRecognizer 已启动，但摄像头初始化/取帧失败";
-            } else if (header->status_code == static_cast<int32_t>(SharedFrameStatus::INVALID_FRAME)) {
+            } else if (status == SharedFrameStatus::INVALID_FRAME) {
                 error_message = "FaceRecognizer 已启动，但首帧数据无效";
             }
         }
 
-        Sleep(kProbeIntervalMs);
+        // 首帧发布时被提前唤醒
+        preview_signal_.WaitForChange(0, std::chrono::milliseconds(kProbeIntervalMs));
     }
 
     error_message = "FaceRecognizer 预览进程已启动，等待摄像头输出画面";
@@ -431,20 +716,26 @@ void FaceRecognition::ReadSubProcessLogs() {
 }
 
 void FaceRecognition::stop_fr_process() {
-    if (recognition_result_view_ != nullptr) {
-        auto* header = static_cast<SharedFrameHeader*>(recognition_result_view_);
-        header->stop_requested = 1;
+    if (recognition_result_region_) {
+        RequestSharedFrameStop(recognition_result_region_.as<SharedFrameHeader>());
     }
 
     if (fr_process_) {
         std::cout << "[SU] stop_fr_process session=" << current_session_id_
                   << " notifying PROCESS_ENDED" << std::endl;
         if (udp_sender_) udp_sender_->send_status(RecognitionStatus::PROCESS_ENDED, "", current_session_id_);
-        if (IsProcessHandleActive(fr_process_) && WaitForSingleObject(fr_process_, 500) == WAIT_TIMEOUT) {
-            TerminateProcess(fr_process_, 0);
+
+        // 只结束识别会话，守护进程与已加载模型保留给下一次请求
+        std::string response;
+        if (!IsProcessHandleActive(fr_process_) ||
+            !send_fr_command(FRCommandType::STOP_RECOGNITION, "", response, kFrCommandTimeoutMs)) {
+            std::cerr << "[SU] FR 守护进程无响应，强制结束: " << response << std::endl;
+            if (IsProcessHandleActive(fr_process_)) {
+                TerminateProcess(fr_process_, 0);
+            }
+            cleanup_fr_process_handles();
         }
     }
-    cleanup_fr_process_handles();
 }
 
 void FaceRecognition::cleanup_fr_process_handles() {
@@ -459,17 +750,14 @@ void FaceRecognition::cleanup_fr_process_handles() {
         fr_process_info_.hThread = nullptr;
     }
     fr_process_ = nullptr;
-    if (recognition_result_view_) {
-        UnmapViewOfFile(recognition_result_view_);
-        recognition_result_view_ = nullptr;
-    }
-    if (recognition_result_mapping_) {
-        CloseHandle(recognition_result_mapping_);
-        recognition_result_mapping_ = nullptr;
-    }
+    recognition_result_region_.Reset();
     recognition_result_map_name_.clear();
     if (fr_stdout_read_) { CloseHandle(fr_stdout_read_); fr_stdout_read_ = nullptr; }
     if (fr_stderr_read_) { CloseHandle(fr_stderr_read_); fr_stderr_read_ = nullptr; }
+    {
+        std::lock_guard<std::mutex> lock(fr_command_mutex_);
+        fr_command_client_.reset();
+    }
 }
 
 void FaceRecognition::on_fr_status_received(RecognitionStatus status,
@@ -580,6 +868,18 @@ bool FaceRecognition::Initialize(std::string& error_message) {
                                               const std::string& feature) {
             on_fr_status_received(status, username, session_id, feature);
         });
+        // FR 调度器的进度上报只记录耗时，不改变识别状态
+        udp_receiver_fr_->set_progress_callback([](uint32_t session_id, const UdpStatusBudget& budget) {
+            NotifyServiceActivity();
+            std::cout << "[SU] FR识别进度"
+                      << " session=" << session_id
+                      << " phase=" << (budget.phase == 0 ? "searching" : "verifying")
+                      << " elapsed=" << budget.elapsed_ms << "/" << budget.session_budget_ms << "ms"
+                      << " phase_elapsed=" << budget.phase_elapsed_ms << "/" << budget.phase_budget_ms << "ms"
+                      << " frames=" << budget.frames
+                      << " inference=" << budget.inference_ms << "ms"
+                      << std::endl;
+        });
         udp_receiver_fr_->start();
 
         udp_sender_ = std::make_unique<UdpSenderToCP>("127.0.0.1", kCpStatusPort);
@@ -601,7 +901,7 @@ bool FaceRecognition::StartRecognition() {
         cleanup_fr_process_handles();
     }
     last_recognition_feature_.clear();
-    if (!fr_process_ && !start_fr_process()) return false;
+    if (!start_fr_process()) return false;
     is_running_ = true;
     return true;
 }
@@ -611,10 +911,10 @@ bool FaceRecognition::CaptureFrameImage(std::vector<unsigned char>& image_data,
 }
 
 bool FaceRecognition::StartPreviewStream(std::string& error_message) {
-    if (IsPreviewStreamRunning() && preview_view_ && preview_mapping_) {
+    if (IsPreviewStreamRunning() && preview_region_) {
         return true;
     }
-    if (preview_process_ || preview_view_ || preview_mapping_) {
+    if (preview_process_ || preview_region_) {
         StopPreviewStream();
     }
 
@@ -626,39 +926,53 @@ bool FaceRecognition::StartPreviewStream(std::string& error_message) {
         return false;
     }
 
-    preview_map_name_ = "Local\\Smile2Unlock_Preview_" + std::to_string(GetCurrentProcessId()) + "_" + std::to_string(GetTickCount64());
-    preview_mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, &mapping_sa, PAGE_READWRITE, 0, kSharedFrameMappingSize, preview_map_name_.c_str());
-    windows_security::FreeSecurityAcl(mapping_acl);
-    if (!preview_mapping_) {
-        error_message = LastErrorText("创建预览共享内存失败");
-        return false;
-    }
-
-    preview_view_ = MapViewOfFile(preview_mapping_, FILE_MAP_ALL_ACCESS, 0, 0, kSharedFrameMappingSize);
-    if (!preview_view_) {
-        CloseHandle(preview_mapping_);
-        preview_mapping_ = nullptr;
-        error_message = LastErrorText("映射预览共享内存失败");
+    preview_map_name_ = UniqueMappingName("Preview");
+    SharedRegionOptions region_options;
+    region_options.security = &mapping_sa;
+    preview_region_ = SharedRegion::Create(preview_map_name_, SharedFrameMappingBytes(), region_options);
+    if (!preview_region_) {
+        windows_security::FreeSecurityAcl(mapping_acl);
+        error_message = RegionErrorText("创建预览共享内存失败", preview_region_);
         return false;
     }
 
-    auto* header = static_cast<SharedFrameHeader*>(preview_view_);
+    auto* header = preview_region_.as<SharedFrameHeader>();
     *header = SharedFrameHeader{};
+    SharedFrameEncoding encoding;
+    encoding.compression = config_.preview_rgb565 ? CompressionType::RGB565 : CompressionType::NONE;
+    encoding.downscale = static_cast<uint8_t>(std::clamp(config_.preview_downscale, 1, 4));
+    RequestSharedFrameEncoding(header, encoding);
     last_preview_sequence_ = 0;
 
+    // 新帧通知与共享内存使用同一安全描述符；创建失败时读取线程退回轮询帧号
+    preview_signal_ = FrameReadySignal::Create(preview_map_name_, &header->frame_sequence, region_options);
+    if (!preview_signal_.valid()) {
+        std::cerr << "[SU] 创建预览新帧通知失败 (GetLastError=" << preview_signal_.error() << ")" << std::endl;
+    }
+    windows_security::FreeSecurityAcl(mapping_acl);
+
     if (!start_fr_preview_process(preview_map_name_, error_message)) {
         StopPreviewStream();
         return false;
     }
 
+    preview_reader_running_ = true;
+    preview_reader_thread_ = std::thread(&FaceRecognition::ReadPreviewFrames, this);
+
     error_message = "摄像头已打开";
     return true;
 }
 
 void FaceRecognition::StopPreviewStream() {
-    if (preview_view_ != nullptr) {
-        auto* header = static_cast<SharedFrameHeader*>(preview_view_);
-        header->stop_requested = 1;
+    // 先停读取线程：它持有共享内存中的帧号地址
+    preview_reader_running_ = false;
+    preview_signal_.Notify();
+    if (preview_reader_thread_.joinable()) {
+        preview_reader_thread_.join();
+    }
+
+    if (preview_region_) {
+        RequestSharedFrameStop(preview_region_.as<SharedFrameHeader>());
     }
 
     if (preview_process_) {
@@ -671,16 +985,17 @@ void FaceRecognition::StopPreviewStream() {
         memset(&preview_process_info_, 0, sizeof(preview_process_info_));
     }
 
-    if (preview_view_) {
-        UnmapViewOfFile(preview_view_);
-        preview_view_ = nullptr;
-    }
-    if (preview_mapping_) {
-        CloseHandle(preview_mapping_);
-        preview_mapping_ = nullptr;
-    }
+    preview_signal_.Reset();
+    preview_region_.Reset();
     preview_map_name_.clear();
     last_preview_sequence_ = 0;
+
+    std::lock_guard<std::mutex> lock(preview_frame_mutex_);
+    preview_frame_.clear();
+    preview_frame_width_ = 0;
+    preview_frame_height_ = 0;
+    preview_frame_sequence_ = 0;
+    preview_frame_error_.clear();
 }
 
 bool FaceRecognition::IsPreviewStreamRunning() const {
@@ -696,42 +1011,104 @@ bool FaceRecognition::GetLatestPreviewFrame(std::vector<unsigned char>& image_da
     width = 0;
     height = 0;
 
-    if (!IsPreviewStreamRunning() || preview_view_ == nullptr) {
+    if (!IsPreviewStreamRunning() || !preview_region_) {
         error_message = "摄像头未开启";
         return false;
     }
 
-    auto* header = static_cast<SharedFrameHeader*>(preview_view_);
-    if (header->magic != SharedFrameHeader::MAGIC || header->version != SharedFrameHeader::VERSION) {
+    const auto* header = preview_region_.as<const SharedFrameHeader>();
+    if (!IsSharedFrameHeaderValid(header)) {
         error_message = "预览共享内存无效";
         return false;
     }
-    if (header->status_code != static_cast<int32_t>(SharedFrameStatus::READY)) {
+    if (LoadSharedFrameStatus(header) != SharedFrameStatus::READY) {
         error_message = "摄像头尚未输出可用画面";
         return false;
     }
-    if (header->image_bytes == 0 || header->image_bytes > SharedFrameHeader::MAX_IMAGE_BYTES) {
-        error_message = "预览帧数据无效";
+
+    // 帧由读取线程在发布时读出并解码，这里只取走比上次更新的一帧，不访问共享内存中的帧数据
+    std::lock_guard<std::mutex> lock(preview_frame_mutex_);
+    if (!preview_frame_error_.empty()) {
+        error_message = preview_frame_error_;
         return false;
     }
-    if (header->frame_sequence == last_preview_sequence_) {
+    if (preview_frame_sequence_ == 0) {
+        error_message = "摄像头尚未输出可用画面";
         return false;
     }
-
-    auto* bytes = reinterpret_cast<unsigned char*>(header + 1);
-    image_data.assign(bytes, bytes + header->image_bytes);
-    width = header->width;
-    height = header->height;
-    last_preview_sequence_ = header->frame_sequence;
+    if (preview_frame_sequence_ == last_preview_sequence_) {
+        return false;
+    }
+    image_data.swap(preview_frame_);
+    width = preview_frame_width_;
+    height = preview_frame_height_;
+    last_preview_sequence_ = preview_frame_sequence_;
     return true;
 }
 
-bool FaceRecognition::CaptureFrameAndFeature(std::vector<unsigned char>& image_data, int& width, int& height, std::string& feature, std::string& error_message) {
+void FaceRecognition::ReadPreviewFrames() {
+    // 超时只用于检查停止标志，新帧由 FR 发布后立即唤醒
+    constexpr auto kWaitTimeout = std::chrono::milliseconds(100);
+    const auto* header = preview_region_.as<const SharedFrameHeader>();
+    uint32_t last_sequence = 0;
+    std::vector<unsigned char> payload;  // 编码后的预览帧，解码前的暂存区
+    std::vector<unsigned char> decoded;
+
+    while (preview_reader_running_) {
+        if (!preview_signal_.WaitForChange(last_sequence, kWaitTimeout)) {
+            continue;
+        }
+
+        // seqlock 读取：写端同时写入的槽位会被校验出来并重读最新一帧，不会拿到撕裂的画面
+        SharedFrameSlot info;
+        const SharedFrameRead result = ReadLatestSharedFrame(header, last_sequence, info, payload);
+        if (result == SharedFrameRead::CONTENDED || result == SharedFrameRead::NO_NEW_FRAME ||
+            result == SharedFrameRead::EMPTY) {
+            continue;
+        }
+
+        std::string error;
+        if (result != SharedFrameRead::OK || info.image_bytes == 0 || info.width <= 0 || info.height <= 0) {
+            error = "预览帧数据无效";
+        } else {
+            // 写端按请求编码，实际格式以槽位为准；解码结果与原始帧一样是 24 位三通道
+            switch (info.compression) {
+                case CompressionType::NONE:
+                    decoded.swap(payload);
+                    break;
+                case CompressionType::RGB565:
+                    if (info.image_bytes != codec::Rgb565Bytes(info.width, info.height)) {
+                        error = "预览帧数据无效";
+                        break;
+                    }
+                    decoded.resize(static_cast<size_t>(info.width) * info.height * 3);
+                    codec::DecodeRgb565(payload.data(), info.width, info.height, decoded.data(), info.width * 3);
+                    break;
+                default:
+                    error = "不支持的预览帧编码";
+                    break;
+            }
+        }
+        // 无效帧也跳过，避免帧号未变时反复重读
+        last_sequence = result == SharedFrameRead::OK ? info.frame_sequence : LatestSharedFrameSequence(header);
+
+        std::lock_guard<std::mutex> lock(preview_frame_mutex_);
+        preview_frame_error_ = error;
+        if (error.empty()) {
+            preview_frame_.swap(decoded);
+            preview_frame_width_ = info.width;
+            preview_frame_height_ = info.height;
+            preview_frame_sequence_ = info.frame_sequence;
+        }
+    }
+}
+
+bool FaceRecognition::CaptureFrameAndFeature(std::vector<unsigned char>& image_data, int& width, int& height, std::vector<float>& feature, std::string& error_message) {
     feature.clear();
     return capture_shared_payload(image_data, width, height, &feature, error_message);
 }
 
-bool FaceRecognition::capture_shared_payload(std::vector<unsigned char>& image_data, int& width, int& height, std::string* feature, std::string& error_message) {
+bool FaceRecognition::capture_shared_payload(std::vector<unsigned char>& image_data, int& width, int& height, std::vector<float>* feature, std::string& error_message) {
     width = 0;
     height = 0;
     image_data.clear();
@@ -745,51 +1122,47 @@ bool FaceRecognition::capture_shared_payload(std::vector<unsigned char>& image_d
         error_message = LastErrorText("构建抓拍共享内存安全描述符失败");
         return false;
     }
-    const std::string map_name = "Local\\Smile2Unlock_Frame_" + std::to_string(GetCurrentProcessId()) + "_" + std::to_string(GetTickCount64());
-    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, &mapping_sa, PAGE_READWRITE, 0, kSharedFrameMappingSize, map_name.c_str());
+    const std::string map_name = UniqueMappingName("Frame");
+    SharedRegionOptions region_options;
+    region_options.security = &mapping_sa;
+    const SharedRegion region = SharedRegion::Create(map_name, SharedFrameMappingBytes(), region_options);
     windows_security::FreeSecurityAcl(mapping_acl);
-    if (!mapping) {
-        error_message = LastErrorText("创建共享内存失败");
-        return false;
-    }
-    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kSharedFrameMappingSize);
-    if (!view) {
-        CloseHandle(mapping);
-        error_message = LastErrorText("映射共享内存失败");
+    if (!region) {
+        error_message = RegionErrorText("创建共享内存失败", region);
         return false;
     }
-    auto* header = static_cast<SharedFrameHeader*>(view);
+    auto* header = region.as<SharedFrameHeader>();
     *header = SharedFrameHeader{};
     bool success = false;
-    if (start_fr_capture_process(map_name, feature != nullptr, error_message)) {
-        if (header->magic == SharedFrameHeader::MAGIC &&
-            header->version == SharedFrameHeader::VERSION &&
-            header->image_bytes > 0 &&
-            header->image_bytes <= SharedFrameHeader::MAX_IMAGE_BYTES) {
-            width = header->width;
-            height = header->height;
-            auto* bytes = reinterpret_cast<unsigned char*>(header + 1);
-            image_data.assign(bytes, bytes + header->image_bytes);
-
-            if (header->status_code == static_cast<int32_t>(SharedFrameStatus::READY)) {
+    if (start_fr_capture_process(map_name, header, feature != nullptr, error_message)) {
+        SharedFrameSlot info;
+        std::vector<unsigned char> feature_block;
+        const SharedFrameStatus status = LoadSharedFrameStatus(header);
+        if (ReadLatestSharedFrame(header, 0, info, image_data, &feature_block) == SharedFrameRead::OK &&
+            info.image_bytes > 0) {
+            width = info.width;
+            height = info.height;
+
+            if (status == SharedFrameStatus::READY) {
                 if (feature != nullptr) {
-                    if (header->feature_bytes == 0 || header->feature_bytes > SharedFrameHeader::MAX_FEATURE_BYTES) {
+                    // 校验后直接按 float 视图读取特征块，不经过 hex 文本
+                    const std::span<const float> view = SharedFeatureView(feature_block);
+                    if (view.empty()) {
                         error_message = "共享特征数据无效";
                     } else {
-                        const char* feature_bytes = reinterpret_cast<const char*>(bytes + header->image_bytes);
-                        feature->assign(feature_bytes, feature_bytes + header->feature_bytes);
+                        feature->assign(view.begin(), view.end());
                         success = true;
                     }
                 } else {
                     success = true;
                 }
-            } else if (header->status_code == static_cast<int32_t>(SharedFrameStatus::FEATURE_EXTRACTION_FAILED)) {
+            } else if (status == SharedFrameStatus::FEATURE_EXTRACTION_FAILED) {
                 error_message = "未检测到可录入的人脸，请调整角度后重试";
-            } else if (header->status_code == static_cast<int32_t>(SharedFrameStatus::FEATURE_TOO_LARGE)) {
+            } else if (status == SharedFrameStatus::FEATURE_TOO_LARGE) {
                 error_message = "人脸特征数据过大，无法保存";
-            } else if (header->status_code == static_cast<int32_t>(SharedFrameStatus::INVALID_FRAME)) {
+            } else if (status == SharedFrameStatus::INVALID_FRAME) {
                 error_message = "共享图像数据无效";
-            } else if (header->status_code == static_cast<int32_t>(SharedFrameStatus::CAPTURE_FAILED)) {
+            } else if (status == SharedFrameStatus::CAPTURE_FAILED) {
                 error_message = "FaceRecognizer 抓拍失败";
             } else {
                 error_message = "共享图像数据无效";
@@ -798,8 +1171,6 @@ bool FaceRecognition::capture_shared_payload(std::vector<unsigned char>& image_d
             error_message = "共享图像数据无效";
         }
     }
-    UnmapViewOfFile(view);
-    CloseHandle(mapping);
     return success;
 }
 
@@ -1000,8 +1371,8 @@ void FaceRecognition::on_cp_request_received(AuthRequestType type, const std::st
                           << " session=" << session_id << std::endl;
                 cleanup_fr_process_handles();
             }
-            if (!fr_process_ && !start_fr_process()) {
-                std::cout << "[SU] START_RECOGNITION 启动 FR 进程失败"
+            if (!start_fr_process()) {
+                std::cout << "[SU] START_RECOGNITION 启动 FR 识别会话失败"
                           << " session=" << session_id << std::endl;
                 if (udp_sender_) udp_sender_->send_status(RecognitionStatus::RECOGNITION_ERROR, "", session_id);
                 return;
@@ -1,6 +1,7 @@
 module;
 
 #include "models/gui_ipc_protocol.h"
+#include "models/feature_batch_file.h"
 #include "backend/ibackend_service.h"
 #include "exceptions.h"
 
@@ -43,6 +44,7 @@ public:
     bool GetLatestCameraPreview(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message);
     bool CapturePreviewFrame(std::vector<unsigned char>& image_data, int& width, int& height, std::string& error_message);
     bool CaptureAndAddFace(int user_id, const std::string& remark, std::string& error_message);
+    bool ImportFaceBatch(const std::string& batch_path, std::string& error_message);
     bool DeleteFace(int user_id, int face_id, std::string& error_message);
     bool UpdateFaceRemark(int user_id, int face_id, const std::string& remark, std::string& error_message);
     std::vector<FaceData> GetUserFaces(int user_id);
@@ -88,6 +90,42 @@ std::string EncryptPasswordForPersistence(const std::string& password, std::stri
     return encrypted_password;
 }
 
+// 与 FaceRecognizer 上报特征相同的大写十六进制编码
+std::string EncodeFeatureHex(std::span<const float> feature) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    const auto* bytes = reinterpret_cast<const unsigned char*>(feature.data());
+    const size_t size = feature.size() * sizeof(float);
+    std::string result(size * 2, '0');
+    for (size_t i = 0; i < size; ++i) {
+        result[i * 2] = kHex[(bytes[i] >> 4) & 0x0F];
+        result[i * 2 + 1] = kHex[bytes[i] & 0x0F];
+    }
+    return result;
+}
+
+// 已入库特征的维度：与 create_gallery_mapping 一致取第一条有效特征，无入库特征时为 0
+size_t EnrolledFeatureDim(const std::vector<User>& users) {
+    constexpr size_t kHexPerFloat = sizeof(float) * 2;
+    for (const auto& user : users) {
+        for (const auto& face : user.faces) {
+            if (!face.feature.empty() && face.feature.size() % kHexPerFloat == 0) {
+                return face.feature.size() / kHexPerFloat;
+            }
+        }
+    }
+    return 0;
+}
+
+// 含 NaN / Inf 或全零的特征无法参与余弦比对
+bool IsUsableFeature(std::span<const float> feature) {
+    float norm_sq = 0.0f;
+    for (const float value : feature) {
+        if (!std::isfinite(value)) return false;
+        norm_sq += value * value;
+    }
+    return std::isfinite(norm_sq) && norm_sq > 0.0f;
+}
+
 }
 
 BackendService::BackendService() : initialized_(false), dll_injector_(nullptr), database_(nullptr), face_recognition_(nullptr), config_manager_(nullptr) {
@@ -241,7 +279,7 @@ bool BackendService::CaptureAndAddFace(int user_id, const std::string& remark, s
     std::vector<unsigned char> image_data;
     int width = 0;
     int height = 0;
-    std::string feature;
+    std::vector<float> feature;
     const bool captured = face_recognition_->CaptureFrameAndFeature(image_data, width, height, feature, error_message);
 
     if (restart_preview) {
@@ -254,7 +292,85 @@ bool BackendService::CaptureAndAddFace(int user_id, const std::string& remark, s
         return false;
     }
 
-    return AddFace(user_id, feature, remark, error_message);
+    // 数据库仍以 hex 文本保存特征，只在入库时编码一次
+    return AddFace(user_id, EncodeFeatureHex(feature), remark, error_message);
+}
+
+bool BackendService::ImportFaceBatch(const std::string& batch_path, std::string& error_message) {
+    uint32_t dim = 0;
+    std::vector<FeatureBatchRecord> records;
+    if (!ReadFeatureBatchFile(batch_path, dim, records, error_message)) {
+        return false;
+    }
+
+    // 维度与已入库特征不同的文件整体拒绝，否则图库按首条特征取维度时会丢弃另一方
+    const size_t enrolled_dim = EnrolledFeatureDim(database_->GetAllUsers());
+    if (enrolled_dim != 0 && enrolled_dim != dim) {
+        error_message = "特征维度不匹配: 文件为 " + std::to_string(dim) + "，已入库特征为 " + std::to_string(enrolled_dim);
+        return false;
+    }
+
+    // 按用户名匹配已有用户（批量文件不含密码，不自动创建用户）；相同特征重复导入时跳过
+    std::unordered_map<std::string, std::optional<User>> users;
+    int imported = 0;
+    int duplicated = 0;
+    int failed = 0;
+    int invalid = 0;
+    std::set<std::string> unknown_users;
+    for (const auto& record : records) {
+        if (!IsUsableFeature(record.feature)) {
+            ++invalid;
+            continue;
+        }
+        auto [it, inserted] = users.try_emplace(record.username);
+        if (inserted) {
+            it->second = database_->GetUserByUsername(record.username);
+        }
+        if (!it->second.has_value()) {
+            unknown_users.insert(record.username);
+            continue;
+        }
+
+        User& user = *it->second;
+        const std::string feature = EncodeFeatureHex(record.feature);
+        const bool exists = std::any_of(user.faces.begin(), user.faces.end(),
+                                        [&feature](const FaceData& face) { return face.feature == feature; });
+        if (exists) {
+            ++duplicated;
+            continue;
+        }
+
+        FaceData face;
+        face.feature = feature;
+        face.remark = "批量导入: " + std::filesystem::path(record.source).filename().string();
+        if (database_->AddFace(user.id, face)) {
+            user.faces.push_back(std::move(face));
+            ++imported;
+        } else {
+            ++failed;
+        }
+    }
+
+    std::ostringstream summary;
+    summary << "导入 " << imported << " 条";
+    if (duplicated > 0) summary << "，重复跳过 " << duplicated << " 条";
+    if (invalid > 0) summary << "，无效特征跳过 " << invalid << " 条";
+    if (failed > 0) summary << "，写入失败 " << failed << " 条";
+    if (!unknown_users.empty()) {
+        summary << "，未知用户 " << unknown_users.size() << " 个:";
+        int listed = 0;
+        for (const auto& username : unknown_users) {
+            if (++listed > 5) {
+                summary << " ...";
+                break;
+            }
+            summary << " " << username;
+        }
+    }
+    error_message = summary.str();
+    std::cout << "[Service] 批量导入 " << batch_path << " (dim=" << dim << ", records=" << records.size() << "): "
+              << error_message << std::endl;
+    return imported > 0 || (duplicated > 0 && failed == 0 && unknown_users.empty());
 }
 
 bool BackendService::DeleteFace(int user_id, int face_id, std::string& error_message) {
@@ -324,13 +440,16 @@ bool BackendService::GetRecognizerConfig(FaceRecognizerConfig& config, std::stri
     config.debug = loaded.debug;
     config.language = loaded.language;
     config.auto_update_check = loaded.auto_update_check;
+    config.preview_rgb565 = loaded.preview_rgb565;
+    config.preview_downscale = loaded.preview_downscale;
     face_recognition_->SetConfig(config);
     error_message = "识别配置已加载";
     return true;
 }
 
 bool BackendService::SaveRecognizerConfig(const FaceRecognizerConfig& config, std::string& error_message) {
-    ConfigManager::CoreConfig core_config;
+    // 以已加载配置为基础，保留 GUI 未暴露的键（如 detect_scale）
+    ConfigManager::CoreConfig core_config = config_manager_->getConfig();
     core_config.camera = config.camera;
     core_config.liveness = config.liveness;
     core_config.face_threshold = config.face_threshold;
@@ -345,7 +464,11 @@ bool BackendService::SaveRecognizerConfig(const FaceRecognizerConfig& config, st
         return false;
     }
 
-    face_recognition_->SetConfig(config);
+    // 预览编码不在 GUI 中暴露，沿用配置文件中的值
+    FaceRecognizerConfig applied = config;
+    applied.preview_rgb565 = core_config.preview_rgb565;
+    applied.preview_downscale = core_config.preview_downscale;
+    face_recognition_->SetConfig(applied);
     error_message = "识别配置已保存";
     return true;
 }
@@ -13,6 +13,7 @@
  * - PasswordReceiver: 接收密码响应 (端口 51237)
  * - StatusSender: 发送状态到 SU (端口 51235)
  * - StatusReceiver: 接收状态从 FR (端口 51235)
+ * - FrCommandServer: FR 守护进程接收 SU 命令并回复 (端口 51238)
  */
 
 #include <winsock2.h>
@@ -34,6 +35,7 @@
 #include "models/udp_status_packet.h"
 #include "models/udp_auth_request_packet.h"
 #include "models/udp_password_packet.h"
+#include "models/fr_command_packet.h"
 
 namespace asio = boost::asio;
 using udp = asio::ip::udp;
@@ -48,6 +50,7 @@ struct UdpPorts {
     static constexpr uint16_t kFrStatusPort = 51235;      // SU 接收 FR 状态
     static constexpr uint16_t kAuthRequestPort = 51236;   // SU 接收 CP 认证请求
     static constexpr uint16_t kPasswordPort = 51237;      // CP 接收密码响应
+    static constexpr uint16_t kFrCommandPort = 51238;     // FR 守护进程接收 SU 命令
 };
 
 // ============================================================================
@@ -119,6 +122,7 @@ private:
 class StatusReceiver {
 public:
     using StatusCallback = std::function<void(RecognitionStatus, const std::string&, uint32_t, const std::string&)>;
+    using ProgressCallback = std::function<void(uint32_t, const UdpStatusBudget&)>;
 
     explicit StatusReceiver(uint16_t port = UdpPorts::kCpStatusPort)
         : socket_(io_context_, ::udp::endpoint(::udp::v4(), port)),
@@ -127,6 +131,8 @@ public:
     ~StatusReceiver() { stop(); }
 
     void set_callback(StatusCallback callback) { callback_ = std::move(callback); }
+    // 设置后，携带时间预算的进度包只交给该回调，不再作为状态变化处理
+    void set_progress_callback(ProgressCallback callback) { progress_callback_ = std::move(callback); }
 
     void start() {
         if (running_) return;
@@ -163,6 +169,11 @@ private:
                 if (ec || len != sizeof(UdpStatusPacket)) continue;
                 if (packet.magic_number != MAGIC_NUMBER || packet.version != PROTOCOL_VERSION) continue;
 
+                if (progress_callback_ && packet.budget.session_budget_ms != 0 &&
+                    static_cast<RecognitionStatus>(packet.status_code) == RecognitionStatus::RECOGNIZING) {
+                    progress_callback_(packet.session_id, packet.budget);
+                    continue;
+                }
                 if (callback_) {
                     std::string feature;
                     if (packet.feature_bytes > 0 && packet.feature_bytes <= sizeof(packet.feature)) {
@@ -186,6 +197,7 @@ private:
     std::atomic<bool> running_;
     std::thread recv_thread_;
     StatusCallback callback_;
+    ProgressCallback progress_callback_;
 };
 
 // ============================================================================
@@ -474,4 +486,107 @@ private:
     PasswordCallback callback_;
 };
 
+// ============================================================================
+// FR 命令服务端 (FR 守护进程接收 SU 命令)
+// ============================================================================
+class FrCommandServer {
+public:
+    // 返回响应状态码（0=成功，负数=错误），result 写入响应 result_data
+    using CommandHandler = std::function<int32_t(FRCommandType, const std::string&, std::string&)>;
+
+    explicit FrCommandServer(uint16_t port = UdpPorts::kFrCommandPort)
+        : socket_(io_context_, ::udp::endpoint(asio::ip::address_v4::loopback(), port)),
+          running_(false) {}
+
+    ~FrCommandServer() { stop(); }
+
+    void set_handler(CommandHandler handler) { handler_ = std::move(handler); }
+
+    // 只接受携带该令牌的命令包；未设置（或长度不符）时拒绝全部命令
+    void set_auth_token(std::string token) { auth_token_ = std::move(token); }
+
+    void start() {
+        if (running_) return;
+        running_ = true;
+        recv_thread_ = std::thread([this]() { receive_loop(); });
+    }
+
+    void stop() {
+        if (!running_) return;
+        running_ = false;
+        boost::system::error_code ec;
+        socket_.close(ec);
+        if (recv_thread_.joinable()) {
+            recv_thread_.join();
+        }
+    }
+
+    bool is_running() const { return running_; }
+
+private:
+    void receive_loop() {
+        FRCommandPacket packet{};
+        ::udp::endpoint sender_endpoint;
+
+        while (running_) {
+            try {
+                boost::system::error_code ec;
+                size_t len = socket_.receive_from(
+                    asio::buffer(&packet, sizeof(packet)), sender_endpoint, 0, ec);
+
+                if (ec == asio::error::operation_aborted || ec == asio::error::bad_descriptor) {
+                    break;
+                }
+                if (ec || len != sizeof(FRCommandPacket)) continue;
+                if (packet.magic_number != FRCommandPacket::MAGIC_NUMBER ||
+                    packet.version != FRCommandPacket::PROTOCOL_VERSION) continue;
+                // 令牌不符的包直接丢弃，不回复，避免向探测方暴露守护进程
+                if (!token_matches(packet)) continue;
+
+                packet.payload[sizeof(packet.payload) - 1] = '\0';
+                std::string result;
+                int32_t status_code = -1;
+                if (handler_) {
+                    status_code = handler_(static_cast<FRCommandType>(packet.command_type),
+                                           std::string(packet.payload), result);
+                } else {
+                    result = "no handler";
+                }
+
+                FRResponsePacket response{};
+                response.magic_number = FRResponsePacket::MAGIC_NUMBER;
+                response.version = FRCommandPacket::PROTOCOL_VERSION;
+                response.sequence_id = packet.sequence_id;
+                response.status_code = status_code;
+                strncpy_s(response.result_data, sizeof(response.result_data), result.c_str(), _TRUNCATE);
+                response.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+
+                socket_.send_to(asio::buffer(&response, sizeof(response)), sender_endpoint, 0, ec);
+            } catch (const std::exception&) {
+                if (running_) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+        }
+    }
+
+    // 定长比较，耗时与第一个不同字符的位置无关
+    bool token_matches(const FRCommandPacket& packet) const {
+        if (auth_token_.size() != FRCommandPacket::AUTH_TOKEN_CHARS) return false;
+        unsigned char diff = packet.auth_token[FRCommandPacket::AUTH_TOKEN_CHARS] == '\0' ? 0 : 1;
+        for (size_t i = 0; i < FRCommandPacket::AUTH_TOKEN_CHARS; ++i) {
+            diff |= static_cast<unsigned char>(packet.auth_token[i] ^ auth_token_[i]);
+        }
+        return diff == 0;
+    }
+
+    asio::io_context io_context_;
+    ::udp::socket socket_;
+    std::atomic<bool> running_;
+    std::thread recv_thread_;
+    CommandHandler handler_;
+    std::string auth_token_;
+};
+
 } // namespace smile2unlock::udp
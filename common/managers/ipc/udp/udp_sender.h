@@ -41,7 +41,8 @@ public:
     bool send_status(RecognitionStatus status,
                      const std::string& username = "",
                      uint32_t session_id = 0,
-                     const std::string& feature = "") {
+                     const std::string& feature = "",
+                     const UdpStatusBudget* budget = nullptr) {
         try {
             UdpStatusPacket packet{};
             packet.magic_number = MAGIC_NUMBER;
@@ -60,6 +61,9 @@ public:
                 packet.feature_bytes = static_cast<uint32_t>(feature.size());
                 memcpy(packet.feature, feature.data(), feature.size());
             }
+            if (budget != nullptr) {
+                packet.budget = *budget;
+            }
 
             packet.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()
@@ -80,6 +84,11 @@ public:
         }
     }
 
+    // 识别进度：RECOGNIZING + 时间预算，供 SU 跟踪会话耗时
+    bool send_progress(uint32_t session_id, const UdpStatusBudget& budget) {
+        return send_status(RecognitionStatus::RECOGNIZING, "", session_id, "", &budget);
+    }
+
 private:
     asio::io_context io_context_;
     udp::socket socket_;
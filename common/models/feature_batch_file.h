@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace smile2unlock {
+
+// FaceRecognizer -m batch-extract 输出、Smile2Unlock 批量导入的特征文件（小端）
+// 布局：FeatureBatchFileHeader，随后 record_count 条记录，每条为
+//   FeatureBatchRecordHeader + username (UTF-8) + source (UTF-8) + float[dim]
+struct FeatureBatchFileHeader {
+    static constexpr uint32_t MAGIC = 0x54424653; // 小端写入，文件中为 "SFBT"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MAX_DIM = 4096;
+    static constexpr uint32_t MAX_RECORDS = 1u << 20;
+    static constexpr uint32_t MAX_TEXT_BYTES = 1024;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t dim = 0;
+    uint32_t record_count = 0;
+};
+
+struct FeatureBatchRecordHeader {
+    uint16_t username_bytes = 0;
+    uint16_t source_bytes = 0;
+};
+
+struct FeatureBatchRecord {
+    std::string username;
+    std::string source;         // 原始图像路径，仅用于备注与排查
+    std::vector<float> feature;
+};
+
+inline bool WriteFeatureBatchFile(const std::string& path, uint32_t dim,
+                                  const std::vector<FeatureBatchRecord>& records, std::string& error_message) {
+    if (dim == 0 || dim > FeatureBatchFileHeader::MAX_DIM || records.size() > FeatureBatchFileHeader::MAX_RECORDS) {
+        error_message = "特征维度或记录数超出范围";
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error_message = "无法写入特征文件: " + path;
+        return false;
+    }
+
+    FeatureBatchFileHeader header;
+    header.dim = dim;
+    header.record_count = static_cast<uint32_t>(records.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& record : records) {
+        if (record.feature.size() != dim) {
+            error_message = "特征维度不一致: " + record.source;
+            return false;
+        }
+        FeatureBatchRecordHeader record_header;
+        record_header.username_bytes = static_cast<uint16_t>(
+            record.username.size() < FeatureBatchFileHeader::MAX_TEXT_BYTES ? record.username.size() : FeatureBatchFileHeader::MAX_TEXT_BYTES);
+        record_header.source_bytes = static_cast<uint16_t>(
+            record.source.size() < FeatureBatchFileHeader::MAX_TEXT_BYTES ? record.source.size() : FeatureBatchFileHeader::MAX_TEXT_BYTES);
+        out.write(reinterpret_cast<const char*>(&record_header), sizeof(record_header));
+        out.write(record.username.data(), record_header.username_bytes);
+        out.write(record.source.data(), record_header.source_bytes);
+        out.write(reinterpret_cast<const char*>(record.feature.data()), static_cast<std::streamsize>(dim * sizeof(float)));
+    }
+    if (!out) {
+        error_message = "写入特征文件失败: " + path;
+        return false;
+    }
+    return true;
+}
+
+inline bool ReadFeatureBatchFile(const std::string& path, uint32_t& dim,
+                                 std::vector<FeatureBatchRecord>& records, std::string& error_message) {
+    records.clear();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error_message = "无法打开特征文件: " + path;
+        return false;
+    }
+
+    FeatureBatchFileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != FeatureBatchFileHeader::MAGIC || header.version != FeatureBatchFileHeader::VERSION ||
+        header.dim == 0 || header.dim > FeatureBatchFileHeader::MAX_DIM ||
+        header.record_count > FeatureBatchFileHeader::MAX_RECORDS) {
+        error_message = "特征文件头部无效: " + path;
+        return false;
+    }
+
+    dim = header.dim;
+    // 记录数来自文件头，预留容量不超过剩余字节按最小记录长度能容纳的条数
+    const std::streamoff data_begin = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff data_end = in.tellg();
+    in.seekg(data_begin);
+    if (!in || data_end < data_begin) {
+        error_message = "无法读取特征文件: " + path;
+        return false;
+    }
+    const uint64_t min_record_bytes = sizeof(FeatureBatchRecordHeader) + uint64_t{dim} * sizeof(float);
+    const uint64_t max_fit = static_cast<uint64_t>(data_end - data_begin) / min_record_bytes;
+    records.reserve(static_cast<size_t>(max_fit < header.record_count ? max_fit : header.record_count));
+    for (uint32_t i = 0; i < header.record_count; ++i) {
+        FeatureBatchRecordHeader record_header;
+        in.read(reinterpret_cast<char*>(&record_header), sizeof(record_header));
+        if (!in || record_header.username_bytes > FeatureBatchFileHeader::MAX_TEXT_BYTES ||
+            record_header.source_bytes > FeatureBatchFileHeader::MAX_TEXT_BYTES) {
+            error_message = "特征文件记录无效: #" + std::to_string(i);
+            return false;
+        }
+        FeatureBatchRecord record;
+        record.username.resize(record_header.username_bytes);
+        record.source.resize(record_header.source_bytes);
+        record.feature.resize(dim);
+        in.read(record.username.data(), record_header.username_bytes);
+        in.read(record.source.data(), record_header.source_bytes);
+        in.read(reinterpret_cast<char*>(record.feature.data()), static_cast<std::streamsize>(dim * sizeof(float)));
+        if (!in) {
+            error_message = "特征文件被截断: #" + std::to_string(i);
+            return false;
+        }
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+} // namespace smile2unlock
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace smile2unlock {
@@ -9,8 +10,8 @@ namespace smile2unlock {
  */
 enum class FRCommandType : int32_t {
     PING = 0,                    // 心跳检测
-    EXTRACT_FEATURE = 1,         // 提取人脸特征（从文件）
-    COMPARE_FEATURES = 2,        // 比较两个特征
+    EXTRACT_FEATURE = 1,         // 抓拍一帧（可选提取特征）写入共享内存；立即回复，结果见共享内存状态
+    COMPARE_FEATURES = 2,        // 比较共享内存中的两个特征
     START_RECOGNITION = 3,       // 开始实时识别
     STOP_RECOGNITION = 4,        // 停止实时识别
     GET_STATUS = 5,              // 获取当前状态
@@ -19,16 +20,21 @@ enum class FRCommandType : int32_t {
 
 /**
  * @brief FR 命令包 (Smile2Unlock -> FaceRecognizer)
+ *
+ * auth_token 为 SU 每次启动守护进程时随机生成并经 --command-token 传入的令牌，
+ * 守护进程丢弃令牌不符的包且不回复，本机其他进程无法冒充 SU 下发命令。
  */
 struct FRCommandPacket {
     static constexpr uint32_t MAGIC_NUMBER = 0xFACE0001;
-    static constexpr int32_t PROTOCOL_VERSION = 1;
+    static constexpr int32_t PROTOCOL_VERSION = 2;    // v2：增加 auth_token
+    static constexpr size_t AUTH_TOKEN_CHARS = 32;    // 128 位随机数的十六进制
 
     uint32_t magic_number;       // 魔数，用于验证包完整性
     int32_t version;             // 协议版本
     int32_t command_type;        // 命令类型
     int32_t sequence_id;         // 序列号（用于匹配请求和响应）
-    char payload[1024];          // 负载数据（JSON 或路径字符串）
+    char auth_token[AUTH_TOKEN_CHARS + 1];  // 以 '\0' 结尾
+    char payload[1024];          // 负载数据（key=value 行）
     int64_t timestamp;           // 时间戳
 };
 
@@ -25,6 +25,7 @@ enum class GuiIpcCommand : int32_t {
     GET_USER_FACES = 200,
     DELETE_FACE = 201,
     CAPTURE_AND_ADD_FACE = 202,
+    IMPORT_FACE_BATCH = 203,
     
     // 摄像头/预览
     START_CAMERA_PREVIEW = 300,
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace smile2unlock {
+
+enum class FeatureDType : uint32_t {
+    FLOAT32 = 1,
+};
+
+// FR -> SU 的二进制特征块，写在共享帧槽位的特征区（替代 hex 文本，体积减半且无需编解码）。
+// 头部之后紧跟 dim 个 dtype 元素；checksum 为元素字节的 FNV-1a，用于发现截断或错位的数据。
+// 头部为 4 字节的整数倍，元素相对块起始保持 float 对齐。
+struct SharedFeatureBlock {
+    static constexpr uint32_t MAGIC = 0x4B424653; // 小端写入，内存中为 "SFBK"；须与特征批量文件的魔数不同
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MAX_DIM = 4096;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t dim = 0;
+    FeatureDType dtype = FeatureDType::FLOAT32;
+    uint32_t checksum = 0;
+    uint32_t reserved = 0;
+};
+
+inline constexpr size_t SharedFeatureBlockBytes(uint32_t dim) {
+    return sizeof(SharedFeatureBlock) + static_cast<size_t>(dim) * sizeof(float);
+}
+
+inline uint32_t SharedFeatureChecksum(const void* data, size_t bytes) {
+    uint32_t hash = 2166136261u;
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// 写端：把 float 特征打包成特征块；dim 为 0 或超出上限时返回空
+inline std::vector<unsigned char> EncodeSharedFeatureBlock(std::span<const float> feature) {
+    if (feature.empty() || feature.size() > SharedFeatureBlock::MAX_DIM) {
+        return {};
+    }
+    SharedFeatureBlock header;
+    header.dim = static_cast<uint32_t>(feature.size());
+    header.checksum = SharedFeatureChecksum(feature.data(), feature.size_bytes());
+
+    std::vector<unsigned char> block(SharedFeatureBlockBytes(header.dim));
+    std::memcpy(block.data(), &header, sizeof(header));
+    std::memcpy(block.data() + sizeof(header), feature.data(), feature.size_bytes());
+    return block;
+}
+
+/**
+ * 读端：校验特征块并返回指向其中元素的视图，不拷贝。
+ * 魔数、版本、类型、维度、长度或校验和不符，或元素未按 float 对齐时返回空视图。
+ * 视图的生命周期与 block 所指的缓冲区相同。
+ */
+inline std::span<const float> SharedFeatureView(std::span<const unsigned char> block) {
+    if (block.size() < sizeof(SharedFeatureBlock)) {
+        return {};
+    }
+    SharedFeatureBlock header;
+    std::memcpy(&header, block.data(), sizeof(header));
+    if (header.magic != SharedFeatureBlock::MAGIC ||
+        header.version != SharedFeatureBlock::VERSION ||
+        header.dtype != FeatureDType::FLOAT32 ||
+        header.dim == 0 || header.dim > SharedFeatureBlock::MAX_DIM ||
+        block.size() != SharedFeatureBlockBytes(header.dim)) {
+        return {};
+    }
+    const unsigned char* elements = block.data() + sizeof(header);
+    if (reinterpret_cast<uintptr_t>(elements) % alignof(float) != 0 ||
+        SharedFeatureChecksum(elements, static_cast<size_t>(header.dim) * sizeof(float)) != header.checksum) {
+        return {};
+    }
+    return {reinterpret_cast<const float*>(elements), header.dim};
+}
+
+} // namespace smile2unlock
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 namespace smile2unlock {
 
@@ -8,27 +12,47 @@ namespace smile2unlock {
 enum class CompressionType : uint8_t {
     NONE = 0,       // 无压缩 (原始 RGB/RGBA)
     JPEG = 1,       // JPEG 压缩 (预留)
-    RGB565 = 2,     // RGB565 格式 (节省 1/2 空间)
+    RGB565 = 2,     // RGB565 格式 (节省 1/2 空间)，编解码见 frame_codec 模块
 };
 
+// 单个帧槽位的元数据。sequence 为槽位的 seqlock：写入期间为奇数，写完为偶数
+struct SharedFrameSlot {
+    uint32_t sequence = 0;
+    uint32_t frame_sequence = 0;  // 写入该槽位的帧号（从 1 开始）
+    int32_t width = 0;
+    int32_t height = 0;
+    int32_t channels = 0;
+    uint32_t image_bytes = 0;
+    uint32_t feature_bytes = 0;
+    CompressionType compression = CompressionType::NONE;
+    uint8_t reserved[3] = {0};
+};
+
+// FR -> SU 的帧共享内存（v3：多槽位环）。
+// 头部之后紧跟 SLOT_COUNT 个数据区，每个 SLOT_BYTES 字节：图像在前，特征紧随其后
+// （抓拍时为二进制特征块，见 shared_feature_block.h；守护进程比对命令为两段 hex 文本）。
+// 写端（单一写者）每帧写入最新槽位之外的下一个槽位，写完后发布 latest_slot / frame_sequence，从不等待读端；
+// 读端按 seqlock 校验拷贝前后槽位序号一致，读到的总是完整的一帧。三个槽位保证读端有两帧的时间完成拷贝。
+// 并发访问的字段只通过下面的辅助函数（std::atomic_ref）读写，头部本身保持可平凡复制以便整体清零。
+// 预览编码由读端协商：读端写入 requested_encoding，写端每帧读取并据此编码，槽位的 compression /
+// width / height 描述实际写入的数据。
 struct SharedFrameHeader {
     static constexpr uint32_t MAGIC = 0x5346524D; // "SFRM"
-    static constexpr uint32_t VERSION = 2;        // 版本升级
+    static constexpr uint32_t VERSION = 3;        // v3：多槽位 seqlock 环
+    static constexpr uint32_t SLOT_COUNT = 3;
     static constexpr uint32_t MAX_IMAGE_BYTES = 8 * 1024 * 1024;
     static constexpr uint32_t MAX_FEATURE_BYTES = 64 * 1024;
+    static constexpr uint32_t SLOT_BYTES = MAX_IMAGE_BYTES + MAX_FEATURE_BYTES;
 
     uint32_t magic = MAGIC;
     uint32_t version = VERSION;
     int32_t status_code = 0;
-    int32_t width = 0;
-    int32_t height = 0;
-    int32_t channels = 0;
-    uint32_t image_bytes = 0;
-    uint32_t feature_bytes = 0;
-    uint32_t frame_sequence = 0;
     uint32_t stop_requested = 0;
-    CompressionType compression = CompressionType::NONE;  // 压缩类型
-    uint8_t reserved[3] = {0};  // 预留对齐
+    uint32_t slot_count = SLOT_COUNT;
+    uint32_t latest_slot = 0;     // 最近发布的槽位
+    uint32_t frame_sequence = 0;  // 最近发布的帧号，0 表示尚无帧
+    uint32_t requested_encoding = 0;  // 读端请求的预览编码，见 SharedFrameEncoding
+    SharedFrameSlot slots[SLOT_COUNT];
 };
 
 enum class SharedFrameStatus : int32_t {
@@ -41,4 +65,185 @@ enum class SharedFrameStatus : int32_t {
     COMPRESSION_FAILED = -5,
 };
 
+// 读端请求的预览编码。写端不支持所请求的编码时退回 NONE，读端始终以槽位的 compression 为准
+struct SharedFrameEncoding {
+    CompressionType compression = CompressionType::NONE;
+    uint8_t downscale = 1;  // 宽高各缩小的倍数（1~4）
+};
+
+inline constexpr size_t SharedFrameMappingBytes() {
+    return sizeof(SharedFrameHeader) +
+           static_cast<size_t>(SharedFrameHeader::SLOT_COUNT) * SharedFrameHeader::SLOT_BYTES;
+}
+
+inline unsigned char* SharedFrameSlotData(SharedFrameHeader* header, uint32_t slot) {
+    return reinterpret_cast<unsigned char*>(header + 1) + static_cast<size_t>(slot) * SharedFrameHeader::SLOT_BYTES;
+}
+
+inline const unsigned char* SharedFrameSlotData(const SharedFrameHeader* header, uint32_t slot) {
+    return reinterpret_cast<const unsigned char*>(header + 1) + static_cast<size_t>(slot) * SharedFrameHeader::SLOT_BYTES;
+}
+
+namespace detail {
+
+// 共享内存中的字段由另一进程并发读写；读端只持有 const 指针，atomic_ref 需要非 const 对象
+template <typename T>
+std::atomic_ref<T> SharedField(const T& field) {
+    return std::atomic_ref<T>(const_cast<T&>(field));
+}
+
+} // namespace detail
+
+inline bool IsSharedFrameHeaderValid(const SharedFrameHeader* header) {
+    return header != nullptr &&
+           header->magic == SharedFrameHeader::MAGIC &&
+           header->version == SharedFrameHeader::VERSION &&
+           header->slot_count == SharedFrameHeader::SLOT_COUNT;
+}
+
+inline void SetSharedFrameStatus(SharedFrameHeader* header, SharedFrameStatus status) {
+    detail::SharedField(header->status_code).store(static_cast<int32_t>(status), std::memory_order_release);
+}
+
+inline SharedFrameStatus LoadSharedFrameStatus(const SharedFrameHeader* header) {
+    return static_cast<SharedFrameStatus>(detail::SharedField(header->status_code).load(std::memory_order_acquire));
+}
+
+inline void RequestSharedFrameStop(SharedFrameHeader* header) {
+    detail::SharedField(header->stop_requested).store(1, std::memory_order_release);
+}
+
+inline bool SharedFrameStopRequested(const SharedFrameHeader* header) {
+    return detail::SharedField(header->stop_requested).load(std::memory_order_acquire) != 0;
+}
+
+// 压缩类型与缩小倍数打包为一个字，写端不会读到半新半旧的请求
+inline void RequestSharedFrameEncoding(SharedFrameHeader* header, SharedFrameEncoding encoding) {
+    const uint32_t packed = static_cast<uint32_t>(encoding.compression) |
+                            (static_cast<uint32_t>(encoding.downscale) << 8);
+    detail::SharedField(header->requested_encoding).store(packed, std::memory_order_release);
+}
+
+inline SharedFrameEncoding LoadRequestedSharedFrameEncoding(const SharedFrameHeader* header) {
+    const uint32_t packed = detail::SharedField(header->requested_encoding).load(std::memory_order_acquire);
+    SharedFrameEncoding encoding;
+    encoding.compression = static_cast<CompressionType>(packed & 0xFF);
+    encoding.downscale = static_cast<uint8_t>((packed >> 8) & 0xFF);
+    if (encoding.downscale < 1 || encoding.downscale > 4) encoding.downscale = 1;
+    return encoding;
+}
+
+// 最近发布的帧号，0 表示尚无帧
+inline uint32_t LatestSharedFrameSequence(const SharedFrameHeader* header) {
+    return detail::SharedField(header->frame_sequence).load(std::memory_order_acquire);
+}
+
+/**
+ * 写端：把一帧（图像 + 可选特征）写入最新槽位之外的下一个槽位并发布，返回本帧帧号。
+ * 只允许单一写者；不等待读端。image_bytes / feature_bytes 超出上限时不写入并返回 0。
+ * info 中的 sequence / frame_sequence 会被忽略。
+ */
+inline uint32_t PublishSharedFrame(SharedFrameHeader* header, const SharedFrameSlot& info,
+                                   const void* image, const void* feature = nullptr) {
+    if (info.image_bytes > SharedFrameHeader::MAX_IMAGE_BYTES ||
+        info.feature_bytes > SharedFrameHeader::MAX_FEATURE_BYTES ||
+        (info.image_bytes > 0 && image == nullptr) ||
+        (info.feature_bytes > 0 && feature == nullptr)) {
+        return 0;
+    }
+    auto latest = detail::SharedField(header->latest_slot);
+    auto published = detail::SharedField(header->frame_sequence);
+    const uint32_t frame_sequence = published.load(std::memory_order_relaxed) + 1;
+    const uint32_t slot_index = published.load(std::memory_order_relaxed) == 0
+        ? 0 : (latest.load(std::memory_order_relaxed) + 1) % SharedFrameHeader::SLOT_COUNT;
+    SharedFrameSlot& slot = header->slots[slot_index];
+    auto sequence = detail::SharedField(slot.sequence);
+
+    // 奇数：读端看到后放弃本槽位；release 栅栏保证数据写入不会被重排到奇数序号之前
+    const uint32_t begin = sequence.load(std::memory_order_relaxed) | 1u;
+    sequence.store(begin, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    unsigned char* data = SharedFrameSlotData(header, slot_index);
+    if (info.image_bytes > 0) std::memcpy(data, image, info.image_bytes);
+    if (info.feature_bytes > 0) std::memcpy(data + info.image_bytes, feature, info.feature_bytes);
+    slot.frame_sequence = frame_sequence;
+    slot.width = info.width;
+    slot.height = info.height;
+    slot.channels = info.channels;
+    slot.image_bytes = info.image_bytes;
+    slot.feature_bytes = info.feature_bytes;
+    slot.compression = info.compression;
+
+    sequence.store(begin + 1, std::memory_order_release);
+    latest.store(slot_index, std::memory_order_release);
+    published.store(frame_sequence, std::memory_order_release);
+    return frame_sequence;
+}
+
+enum class SharedFrameRead : uint8_t {
+    OK = 0,
+    EMPTY,          // 写端尚未发布任何帧
+    NO_NEW_FRAME,   // 最新帧号与 last_sequence 相同
+    INVALID,        // 头部或槽位元数据无效
+    CONTENDED,      // 重试次数内始终与写端冲突（写端持续超过读端两帧以上）
+};
+
+/**
+ * 读端：拷贝最新发布的一帧。seqlock 校验失败时重读最新槽位，最多 kMaxAttempts 次。
+ *
+ * @param last_sequence 调用方上次读到的帧号，相同则返回 NO_NEW_FRAME（传 0 总是读取）
+ * @param info 输出：该帧元数据（frame_sequence 为帧号）
+ * @param image 输出：图像数据
+ * @param feature 输出：特征区原始字节，为空指针时不拷贝
+ */
+inline SharedFrameRead ReadLatestSharedFrame(const SharedFrameHeader* header, uint32_t last_sequence,
+                                             SharedFrameSlot& info, std::vector<unsigned char>& image,
+                                             std::vector<unsigned char>* feature = nullptr) {
+    constexpr int kMaxAttempts = 8;
+    if (!IsSharedFrameHeaderValid(header)) return SharedFrameRead::INVALID;
+
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+        const uint32_t published = LatestSharedFrameSequence(header);
+        if (published == 0) return SharedFrameRead::EMPTY;
+        if (published == last_sequence) return SharedFrameRead::NO_NEW_FRAME;
+
+        const uint32_t slot_index = detail::SharedField(header->latest_slot).load(std::memory_order_acquire);
+        if (slot_index >= SharedFrameHeader::SLOT_COUNT) return SharedFrameRead::INVALID;
+        const SharedFrameSlot& slot = header->slots[slot_index];
+        auto sequence = detail::SharedField(slot.sequence);
+
+        const uint32_t begin = sequence.load(std::memory_order_acquire);
+        if (begin & 1u) continue;
+
+        info.frame_sequence = slot.frame_sequence;
+        info.width = slot.width;
+        info.height = slot.height;
+        info.channels = slot.channels;
+        info.image_bytes = slot.image_bytes;
+        info.feature_bytes = slot.feature_bytes;
+        info.compression = slot.compression;
+        // 元数据可能读到写了一半的值，越界前先校验，真正的一致性由下面的序号比较保证
+        if (info.image_bytes > SharedFrameHeader::MAX_IMAGE_BYTES ||
+            info.feature_bytes > SharedFrameHeader::MAX_FEATURE_BYTES) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != begin) continue;
+            return SharedFrameRead::INVALID;
+        }
+
+        const unsigned char* data = SharedFrameSlotData(header, slot_index);
+        image.resize(info.image_bytes);
+        if (info.image_bytes > 0) std::memcpy(image.data(), data, info.image_bytes);
+        if (feature != nullptr) {
+            feature->assign(data + info.image_bytes, data + info.image_bytes + info.feature_bytes);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != begin) continue;
+        if (info.frame_sequence == last_sequence) return SharedFrameRead::NO_NEW_FRAME;
+        return SharedFrameRead::OK;
+    }
+    return SharedFrameRead::CONTENDED;
+}
+
 } // namespace smile2unlock
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smile2unlock {
+
+// SU -> FR 的识别图库：START_RECOGNITION 期间只读映射，FR 在回复命令前完成拷贝。
+// 头部之后紧跟 entry_count 个条目，每个条目为 uint32_t label + float[dim]，label 相同即同一用户。
+struct SharedGalleryHeader {
+    static constexpr uint32_t MAGIC = 0x53474C59; // "SGLY"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MAX_ENTRIES = 256;
+    static constexpr uint32_t MAX_DIM = 4096;
+
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t entry_count = 0;
+    uint32_t dim = 0;
+    float match_threshold = 0.0f;  // SU 的 face_threshold
+    uint32_t reserved = 0;
+};
+
+inline constexpr size_t SharedGalleryEntryBytes(uint32_t dim) {
+    return sizeof(uint32_t) + static_cast<size_t>(dim) * sizeof(float);
+}
+
+inline constexpr size_t SharedGalleryBytes(uint32_t entry_count, uint32_t dim) {
+    return sizeof(SharedGalleryHeader) + static_cast<size_t>(entry_count) * SharedGalleryEntryBytes(dim);
+}
+
+} // namespace smile2unlock
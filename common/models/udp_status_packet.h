@@ -5,13 +5,25 @@
 #define MAGIC_NUMBER 0x8581DAF3
 
 // 协议版本
-#define PROTOCOL_VERSION 2
+#define PROTOCOL_VERSION 3
 
 // 本地回环链路上承载识别特征，预留 48 KiB 足够当前 hex 特征串传输
 #define UDP_STATUS_MAX_FEATURE_BYTES (48 * 1024)
 
 // UDP 数据包结构
 #pragma pack(push, 1)
+
+// 识别会话的时间预算（FR 调度器的进度上报）；session_budget_ms 为 0 表示数据包不携带预算
+struct UdpStatusBudget {
+    uint32_t elapsed_ms;         // 会话已用时间
+    uint32_t session_budget_ms;  // 会话截止时间
+    uint32_t phase;              // 0 搜索人脸，1 验证（活体 + 多帧融合）
+    uint32_t phase_elapsed_ms;   // 当前阶段已用时间
+    uint32_t phase_budget_ms;    // 当前阶段预算（不超过会话剩余时间）
+    uint32_t frames;             // 已推理帧数
+    uint32_t inference_ms;       // 推理累计耗时
+};
+
 struct UdpStatusPacket {
     uint32_t magic_number;  // 魔术字，用于验证数据包
     uint32_t version;       // 协议版本
@@ -20,6 +32,7 @@ struct UdpStatusPacket {
     uint32_t feature_bytes; // 特征字节数
     char username[64];      // 识别到的用户名（可选）
     char feature[UDP_STATUS_MAX_FEATURE_BYTES]; // 识别特征（可选，hex 字符串）
+    UdpStatusBudget budget;     // 时间预算（可选，仅 FR 进度上报）
     uint64_t timestamp;     // 时间戳
 };
 #pragma pack(pop)
@@ -19,6 +19,30 @@ import std;
  * face_threshold = 0.62f
  * liveness_threshold = 0.8f
  * debug = false
+ * detect_scale = 1.0
+ * quality_gate = true
+ * quality_min_face_size = 64
+ * quality_min_brightness = 40
+ * quality_max_brightness = 220
+ * quality_min_contrast = 15
+ * quality_min_sharpness = 25
+ * quality_max_yaw = 0.35
+ * fusion_frames = 3
+ * fusion_max_frames = 8
+ * fusion_min_margin = 0.05
+ * session_timeout_ms = 10000
+ * verify_budget_ms = 3000
+ * idle_interval_ms = 200
+ * liveness_video_frames = 10
+ * liveness_frame_budget = 20
+ * engine_pool_size = 1
+ * engine_threads = 0
+ * motion_gate = true
+ * motion_threshold = 6.0
+ * motion_force_interval_ms = 1000
+ * max_faces = 3
+ * preview_rgb565 = true
+ * preview_downscale = 1
  */
 export class ConfigManager {
 public:
@@ -33,6 +57,30 @@ public:
         bool debug;                 ///< 调试模式开关
         std::string language;       ///< UI language code, empty means auto-detect
         bool auto_update_check;     ///< check GitHub releases on startup
+        float detect_scale;         ///< 人脸检测输入缩放比例 (0.25~1.0)，关键点与特征仍使用原图
+        bool quality_gate;              ///< 识别前是否按人脸质量过滤帧
+        int quality_min_face_size;      ///< 人脸框短边下限（像素）
+        float quality_min_brightness;   ///< 人脸亮度均值下限
+        float quality_max_brightness;   ///< 人脸亮度均值上限
+        float quality_min_contrast;     ///< 人脸亮度标准差下限
+        float quality_min_sharpness;    ///< 人脸拉普拉斯方差下限
+        float quality_max_yaw;          ///< 偏航比例上限（鼻尖偏移 / 眼距）
+        int fusion_frames;              ///< 参与特征融合的最优帧数（1 = 不融合）
+        int fusion_max_frames;          ///< 单次识别最多累积的有效帧数
+        float fusion_min_margin;        ///< 提前结束所需的匹配得分领先量
+        int session_timeout_ms;         ///< 识别会话的总截止时间（毫秒，墙钟）
+        int verify_budget_ms;           ///< 首次检出人脸后完成活体与融合的预算（毫秒）
+        int idle_interval_ms;           ///< 画面中无人脸时两次推理的最小间隔（毫秒，0 = 不降频）
+        int liveness_video_frames;      ///< 视频模式活体判定所需的帧数（0 = 逐帧单独判定）
+        int liveness_frame_budget;      ///< 视频模式下同一人脸最多送入活体模型的帧数
+        int engine_pool_size;           ///< 守护进程加载的独立推理引擎数
+        int engine_threads;             ///< 每个引擎的推理线程数（0 = 逻辑核数 / 引擎数）
+        bool motion_gate;               ///< 画面与上次无人脸帧相比未变化时跳过检测
+        float motion_threshold;         ///< 8x8 块平均亮度差达到该值视为画面变化
+        int motion_force_interval_ms;   ///< 画面静止时仍强制检测的间隔（毫秒）
+        int max_faces;                  ///< 每帧提取特征并与图库比对的人脸数（按大小 / 得分 / 居中排序）
+        bool preview_rgb565;            ///< 实时预览以 RGB565 传输（数据量为 RGB24 的 2/3）
+        int preview_downscale;          ///< 实时预览宽高各缩小的倍数（1 = 原尺寸）
 
         CoreConfig()
             : camera(0)
@@ -41,7 +89,31 @@ public:
             , liveness_threshold(0.8f)
             , debug(false)
             , language()
-            , auto_update_check(true) {}
+            , auto_update_check(true)
+            , detect_scale(1.0f)
+            , quality_gate(true)
+            , quality_min_face_size(64)
+            , quality_min_brightness(40.0f)
+            , quality_max_brightness(220.0f)
+            , quality_min_contrast(15.0f)
+            , quality_min_sharpness(25.0f)
+            , quality_max_yaw(0.35f)
+            , fusion_frames(3)
+            , fusion_max_frames(8)
+            , fusion_min_margin(0.05f)
+            , session_timeout_ms(10000)
+            , verify_budget_ms(3000)
+            , idle_interval_ms(200)
+            , liveness_video_frames(10)
+            , liveness_frame_budget(20)
+            , engine_pool_size(1)
+            , engine_threads(0)
+            , motion_gate(true)
+            , motion_threshold(6.0f)
+            , motion_force_interval_ms(1000)
+            , max_faces(3)
+            , preview_rgb565(true)
+            , preview_downscale(1) {}
     };
 
     /**
@@ -52,12 +124,14 @@ public:
         uint16_t fr_status_port;       ///< SU 接收 FR 状态端口
         uint16_t auth_request_port;    ///< SU 接收认证请求端口
         uint16_t password_port;        ///< CP 接收密码响应端口
+        uint16_t fr_command_port;      ///< FR 守护进程接收 SU 命令端口
 
         UdpPortConfig()
             : cp_status_port(51234)
             , fr_status_port(51235)
             , auth_request_port(51236)
-            , password_port(51237) {}
+            , password_port(51237)
+            , fr_command_port(51238) {}
     };
 
     /**
@@ -122,6 +196,30 @@ ConfigManager::ConfigManager(const std::string& filename)
     m_config.debug = false;
     m_config.language.clear();
     m_config.auto_update_check = true;
+    m_config.detect_scale = 1.0f;
+    m_config.quality_gate = true;
+    m_config.quality_min_face_size = 64;
+    m_config.quality_min_brightness = 40.0f;
+    m_config.quality_max_brightness = 220.0f;
+    m_config.quality_min_contrast = 15.0f;
+    m_config.quality_min_sharpness = 25.0f;
+    m_config.quality_max_yaw = 0.35f;
+    m_config.fusion_frames = 3;
+    m_config.fusion_max_frames = 8;
+    m_config.fusion_min_margin = 0.05f;
+    m_config.session_timeout_ms = 10000;
+    m_config.verify_budget_ms = 3000;
+    m_config.idle_interval_ms = 200;
+    m_config.liveness_video_frames = 10;
+    m_config.liveness_frame_budget = 20;
+    m_config.engine_pool_size = 1;
+    m_config.engine_threads = 0;
+    m_config.motion_gate = true;
+    m_config.motion_threshold = 6.0f;
+    m_config.motion_force_interval_ms = 1000;
+    m_config.max_faces = 3;
+    m_config.preview_rgb565 = true;
+    m_config.preview_downscale = 1;
 }
 
 bool ConfigManager::loadConfig() {
@@ -246,6 +344,94 @@ bool ConfigManager::loadConfig() {
         }
     }
 
+    if (core_section.isKeyExist("detect_scale")) {
+        try {
+            const float value = static_cast<float>(core_section.toDouble("detect_scale"));
+            if (value >= 0.25f && value <= 1.0f) {
+                m_config.detect_scale = value;
+            } else {
+                std::cerr << "Warning: 'detect_scale' out of range [0.25, 1.0] (" << value << "). Using default value (" << m_config.detect_scale << ")." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse 'detect_scale' value: " << e.what() << ". Using default value (" << m_config.detect_scale << ")." << std::endl;
+        }
+    }
+
+    // 质量门限为可选键，缺失时静默使用默认值
+    auto read_optional_bool = [&core_section](const char* key, bool& value) {
+        if (!core_section.isKeyExist(key)) return;
+        try {
+            const std::string text = core_section.toString(key);
+            if (text == "true" || text == "True" || text == "TRUE" || text == "1") {
+                value = true;
+            } else if (text == "false" || text == "False" || text == "FALSE" || text == "0") {
+                value = false;
+            } else {
+                std::cerr << "Warning: Invalid value for '" << key << "' ('" << text << "'). Using default value (" << value << ")." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse '" << key << "' value: " << e.what() << ". Using default value (" << value << ")." << std::endl;
+        }
+    };
+    auto read_optional_float = [&core_section](const char* key, float& value, float min_value, float max_value) {
+        if (!core_section.isKeyExist(key)) return;
+        try {
+            const float parsed = static_cast<float>(core_section.toDouble(key));
+            if (parsed >= min_value && parsed <= max_value) {
+                value = parsed;
+            } else {
+                std::cerr << "Warning: '" << key << "' out of range [" << min_value << ", " << max_value << "] (" << parsed << "). Using default value (" << value << ")." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse '" << key << "' value: " << e.what() << ". Using default value (" << value << ")." << std::endl;
+        }
+    };
+
+    read_optional_bool("quality_gate", m_config.quality_gate);
+    if (core_section.isKeyExist("quality_min_face_size")) {
+        try {
+            m_config.quality_min_face_size = std::max(0, core_section.toInt("quality_min_face_size"));
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse 'quality_min_face_size' value: " << e.what() << ". Using default value (" << m_config.quality_min_face_size << ")." << std::endl;
+        }
+    }
+    read_optional_float("quality_min_brightness", m_config.quality_min_brightness, 0.0f, 255.0f);
+    read_optional_float("quality_max_brightness", m_config.quality_max_brightness, 0.0f, 255.0f);
+    read_optional_float("quality_min_contrast", m_config.quality_min_contrast, 0.0f, 128.0f);
+    read_optional_float("quality_min_sharpness", m_config.quality_min_sharpness, 0.0f, 100000.0f);
+    read_optional_float("quality_max_yaw", m_config.quality_max_yaw, 0.0f, 1.0f);
+
+    // 多帧融合为可选键
+    auto read_optional_int = [&core_section](const char* key, int& value, int min_value, int max_value) {
+        if (!core_section.isKeyExist(key)) return;
+        try {
+            const int parsed = core_section.toInt(key);
+            if (parsed >= min_value && parsed <= max_value) {
+                value = parsed;
+            } else {
+                std::cerr << "Warning: '" << key << "' out of range [" << min_value << ", " << max_value << "] (" << parsed << "). Using default value (" << value << ")." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Failed to parse '" << key << "' value: " << e.what() << ". Using default value (" << value << ")." << std::endl;
+        }
+    };
+    read_optional_int("fusion_frames", m_config.fusion_frames, 1, 16);
+    read_optional_int("fusion_max_frames", m_config.fusion_max_frames, 1, 64);
+    read_optional_float("fusion_min_margin", m_config.fusion_min_margin, 0.0f, 1.0f);
+    read_optional_int("session_timeout_ms", m_config.session_timeout_ms, 1000, 120000);
+    read_optional_int("verify_budget_ms", m_config.verify_budget_ms, 200, 60000);
+    read_optional_int("idle_interval_ms", m_config.idle_interval_ms, 0, 2000);
+    read_optional_int("liveness_video_frames", m_config.liveness_video_frames, 0, 30);
+    read_optional_int("liveness_frame_budget", m_config.liveness_frame_budget, 1, 120);
+    read_optional_int("engine_pool_size", m_config.engine_pool_size, 1, 8);
+    read_optional_int("engine_threads", m_config.engine_threads, 0, 64);
+    read_optional_bool("motion_gate", m_config.motion_gate);
+    read_optional_float("motion_threshold", m_config.motion_threshold, 1.0f, 64.0f);
+    read_optional_int("motion_force_interval_ms", m_config.motion_force_interval_ms, 100, 10000);
+    read_optional_int("max_faces", m_config.max_faces, 1, 8);
+    read_optional_bool("preview_rgb565", m_config.preview_rgb565);
+    read_optional_int("preview_downscale", m_config.preview_downscale, 1, 4);
+
     return true;
 }
 
@@ -281,6 +467,30 @@ bool ConfigManager::createDefaultConfig() const {
         file << "language=" << m_config.language << "\n";
     }
     file << "auto_update_check=" << (m_config.auto_update_check ? "true" : "false") << "\n";
+    file << "detect_scale=" << m_config.detect_scale << "\n";
+    file << "quality_gate=" << (m_config.quality_gate ? "true" : "false") << "\n";
+    file << "quality_min_face_size=" << m_config.quality_min_face_size << "\n";
+    file << "quality_min_brightness=" << m_config.quality_min_brightness << "\n";
+    file << "quality_max_brightness=" << m_config.quality_max_brightness << "\n";
+    file << "quality_min_contrast=" << m_config.quality_min_contrast << "\n";
+    file << "quality_min_sharpness=" << m_config.quality_min_sharpness << "\n";
+    file << "quality_max_yaw=" << m_config.quality_max_yaw << "\n";
+    file << "fusion_frames=" << m_config.fusion_frames << "\n";
+    file << "fusion_max_frames=" << m_config.fusion_max_frames << "\n";
+    file << "fusion_min_margin=" << m_config.fusion_min_margin << "\n";
+    file << "session_timeout_ms=" << m_config.session_timeout_ms << "\n";
+    file << "verify_budget_ms=" << m_config.verify_budget_ms << "\n";
+    file << "idle_interval_ms=" << m_config.idle_interval_ms << "\n";
+    file << "liveness_video_frames=" << m_config.liveness_video_frames << "\n";
+    file << "liveness_frame_budget=" << m_config.liveness_frame_budget << "\n";
+    file << "engine_pool_size=" << m_config.engine_pool_size << "\n";
+    file << "engine_threads=" << m_config.engine_threads << "\n";
+    file << "motion_gate=" << (m_config.motion_gate ? "true" : "false") << "\n";
+    file << "motion_threshold=" << m_config.motion_threshold << "\n";
+    file << "motion_force_interval_ms=" << m_config.motion_force_interval_ms << "\n";
+    file << "max_faces=" << m_config.max_faces << "\n";
+    file << "preview_rgb565=" << (m_config.preview_rgb565 ? "true" : "false") << "\n";
+    file << "preview_downscale=" << m_config.preview_downscale << "\n";
 
     file.close();
     std::cout << "Default config created: " << m_filename << std::endl;
@@ -311,6 +521,30 @@ bool ConfigManager::saveConfig() const {
         file << "language=" << m_config.language << "\n";
     }
     file << "auto_update_check=" << (m_config.auto_update_check ? "true" : "false") << "\n";
+    file << "detect_scale=" << m_config.detect_scale << "\n";
+    file << "quality_gate=" << (m_config.quality_gate ? "true" : "false") << "\n";
+    file << "quality_min_face_size=" << m_config.quality_min_face_size << "\n";
+    file << "quality_min_brightness=" << m_config.quality_min_brightness << "\n";
+    file << "quality_max_brightness=" << m_config.quality_max_brightness << "\n";
+    file << "quality_min_contrast=" << m_config.quality_min_contrast << "\n";
+    file << "quality_min_sharpness=" << m_config.quality_min_sharpness << "\n";
+    file << "quality_max_yaw=" << m_config.quality_max_yaw << "\n";
+    file << "fusion_frames=" << m_config.fusion_frames << "\n";
+    file << "fusion_max_frames=" << m_config.fusion_max_frames << "\n";
+    file << "fusion_min_margin=" << m_config.fusion_min_margin << "\n";
+    file << "session_timeout_ms=" << m_config.session_timeout_ms << "\n";
+    file << "verify_budget_ms=" << m_config.verify_budget_ms << "\n";
+    file << "idle_interval_ms=" << m_config.idle_interval_ms << "\n";
+    file << "liveness_video_frames=" << m_config.liveness_video_frames << "\n";
+    file << "liveness_frame_budget=" << m_config.liveness_frame_budget << "\n";
+    file << "engine_pool_size=" << m_config.engine_pool_size << "\n";
+    file << "engine_threads=" << m_config.engine_threads << "\n";
+    file << "motion_gate=" << (m_config.motion_gate ? "true" : "false") << "\n";
+    file << "motion_threshold=" << m_config.motion_threshold << "\n";
+    file << "motion_force_interval_ms=" << m_config.motion_force_interval_ms << "\n";
+    file << "max_faces=" << m_config.max_faces << "\n";
+    file << "preview_rgb565=" << (m_config.preview_rgb565 ? "true" : "false") << "\n";
+    file << "preview_downscale=" << m_config.preview_downscale << "\n";
 
     file.close();
     return true;
@@ -0,0 +1,110 @@
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SMILE2UNLOCK_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+export module cpu_features;
+
+import std;
+
+// 运行时 CPU 特性检测，供各 SIMD 内核选择实现
+
+export namespace smile2unlock::cpu {
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool neon = false;
+};
+
+} // namespace smile2unlock::cpu
+
+namespace {
+
+#if defined(SMILE2UNLOCK_CPU_X86)
+void QueryCpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned int>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// 操作系统是否保存 YMM 寄存器状态（AVX 可用的前提）
+bool OsSupportsYmm() {
+#if defined(_MSC_VER)
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (eax & 0x6) == 0x6;
+#endif
+}
+#endif
+
+smile2unlock::cpu::CpuFeatures DetectCpuFeatures() {
+    smile2unlock::cpu::CpuFeatures features;
+#if defined(SMILE2UNLOCK_CPU_X86)
+    unsigned int regs[4] = {};
+    QueryCpuid(0, 0, regs);
+    const unsigned int max_leaf = regs[0];
+    if (max_leaf >= 1) {
+        QueryCpuid(1, 0, regs);
+        features.sse2 = (regs[3] & (1u << 26)) != 0;
+        features.ssse3 = (regs[2] & (1u << 9)) != 0;
+        features.sse41 = (regs[2] & (1u << 19)) != 0;
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        const bool avx = (regs[2] & (1u << 28)) != 0;
+        const bool fma = (regs[2] & (1u << 12)) != 0;
+        features.fma = fma && osxsave && avx && OsSupportsYmm();
+        if (max_leaf >= 7 && osxsave && avx && OsSupportsYmm()) {
+            QueryCpuid(7, 0, regs);
+            features.avx2 = (regs[1] & (1u << 5)) != 0;
+        }
+    }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    features.neon = true;  // AArch64 强制要求 NEON
+#endif
+    return features;
+}
+
+} // namespace
+
+export namespace smile2unlock::cpu {
+
+// 进程内只检测一次
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+std::string DescribeCpuFeatures() {
+    const auto& f = GetCpuFeatures();
+    std::string text;
+    auto append = [&text](bool enabled, const char* name) {
+        if (!enabled) return;
+        if (!text.empty()) text += ' ';
+        text += name;
+    };
+    append(f.sse2, "sse2");
+    append(f.ssse3, "ssse3");
+    append(f.sse41, "sse4.1");
+    append(f.avx2, "avx2");
+    append(f.fma, "fma");
+    append(f.neon, "neon");
+    return text.empty() ? "scalar" : text;
+}
+
+} // namespace smile2unlock::cpu
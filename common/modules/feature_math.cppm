@@ -0,0 +1,324 @@
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FEATURE_MATH_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FEATURE_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集；MSVC 允许直接使用内建函数
+#if defined(FEATURE_MATH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FEATURE_MATH_TARGET_SSE2 __attribute__((target("sse2")))
+#define FEATURE_MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define FEATURE_MATH_TARGET_SSE2
+#define FEATURE_MATH_TARGET_AVX2
+#endif
+
+export module feature_math;
+
+import std;
+import cpu_features;
+
+// 人脸特征向量运算：点积、余弦相似度与分数矩阵，不依赖识别模型
+//
+// SeetaFace 提取的特征与 Smile2Unlock 的比对都以余弦相似度为准；分数矩阵要求各行已 L2 归一化，
+// 此时点积即余弦相似度。SIMD 实现按运行时 CPU 特性选择，与标量实现的差异仅来自浮点求和顺序。
+
+export namespace smile2unlock::feature {
+
+enum class FeatureIsa {
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+} // namespace smile2unlock::feature
+
+namespace {
+
+using smile2unlock::feature::FeatureIsa;
+
+using DotFn = float (*)(const float* a, const float* b, std::size_t n);
+// 一个探针与 4 个图库向量的点积：探针只读取一遍
+using Dot4Fn = void (*)(const float* probe, const float* const* rows, std::size_t n, float* out);
+
+struct FeatureKernels {
+    FeatureIsa isa;
+    const char* name;
+    DotFn dot;
+    Dot4Fn dot4;
+};
+
+// ---------------------------------------------------------------- 标量
+
+float DotScalar(const float* a, const float* b, std::size_t n) {
+    // 4 路部分和，与 SIMD 的求和顺序接近，也便于编译器自动向量化
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+void Dot4Scalar(const float* probe, const float* const* rows, std::size_t n, float* out) {
+    for (int r = 0; r < 4; ++r) out[r] = DotScalar(probe, rows[r], n);
+}
+
+constexpr FeatureKernels kScalarKernels{FeatureIsa::Scalar, "scalar", DotScalar, Dot4Scalar};
+
+// ---------------------------------------------------------------- SSE2 / AVX2
+
+#if defined(FEATURE_MATH_X86)
+
+FEATURE_MATH_TARGET_SSE2
+inline float HorizontalSumSse2(__m128 v) {
+    const __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128 sums = _mm_add_ps(v, shuf);
+    return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(shuf, sums)));
+}
+
+FEATURE_MATH_TARGET_SSE2
+float DotSse2(const float* a, const float* b, std::size_t n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float sum = HorizontalSumSse2(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+FEATURE_MATH_TARGET_SSE2
+void Dot4Sse2(const float* probe, const float* const* rows, std::size_t n, float* out) {
+    __m128 acc[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 p = _mm_loadu_ps(probe + i);
+        for (int r = 0; r < 4; ++r) acc[r] = _mm_add_ps(acc[r], _mm_mul_ps(p, _mm_loadu_ps(rows[r] + i)));
+    }
+    for (int r = 0; r < 4; ++r) {
+        float sum = HorizontalSumSse2(acc[r]);
+        for (std::size_t j = i; j < n; ++j) sum += probe[j] * rows[r][j];
+        out[r] = sum;
+    }
+}
+
+constexpr FeatureKernels kSse2Kernels{FeatureIsa::SSE2, "sse2", DotSse2, Dot4Sse2};
+
+FEATURE_MATH_TARGET_AVX2
+inline float HorizontalSumAvx2(__m256 v) {
+    const __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 shuf = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128 sums = _mm_add_ps(sum, shuf);
+    return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(shuf, sums)));
+}
+
+FEATURE_MATH_TARGET_AVX2
+float DotAvx2(const float* a, const float* b, std::size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    float sum = HorizontalSumAvx2(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+FEATURE_MATH_TARGET_AVX2
+void Dot4Avx2(const float* probe, const float* const* rows, std::size_t n, float* out) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 p = _mm256_loadu_ps(probe + i);
+        acc0 = _mm256_fmadd_ps(p, _mm256_loadu_ps(rows[0] + i), acc0);
+        acc1 = _mm256_fmadd_ps(p, _mm256_loadu_ps(rows[1] + i), acc1);
+        acc2 = _mm256_fmadd_ps(p, _mm256_loadu_ps(rows[2] + i), acc2);
+        acc3 = _mm256_fmadd_ps(p, _mm256_loadu_ps(rows[3] + i), acc3);
+    }
+    out[0] = HorizontalSumAvx2(acc0);
+    out[1] = HorizontalSumAvx2(acc1);
+    out[2] = HorizontalSumAvx2(acc2);
+    out[3] = HorizontalSumAvx2(acc3);
+    for (; i < n; ++i) {
+        for (int r = 0; r < 4; ++r) out[r] += probe[i] * rows[r][i];
+    }
+}
+
+constexpr FeatureKernels kAvx2Kernels{FeatureIsa::AVX2, "avx2", DotAvx2, Dot4Avx2};
+
+#endif // FEATURE_MATH_X86
+
+// ---------------------------------------------------------------- NEON
+
+#if defined(FEATURE_MATH_NEON)
+
+float DotNeon(const float* a, const float* b, std::size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+void Dot4Neon(const float* probe, const float* const* rows, std::size_t n, float* out) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f)};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t p = vld1q_f32(probe + i);
+        for (int r = 0; r < 4; ++r) acc[r] = vfmaq_f32(acc[r], p, vld1q_f32(rows[r] + i));
+    }
+    for (int r = 0; r < 4; ++r) {
+        float sum = vaddvq_f32(acc[r]);
+        for (std::size_t j = i; j < n; ++j) sum += probe[j] * rows[r][j];
+        out[r] = sum;
+    }
+}
+
+constexpr FeatureKernels kNeonKernels{FeatureIsa::NEON, "neon", DotNeon, Dot4Neon};
+
+#endif // FEATURE_MATH_NEON
+
+const FeatureKernels* ResolveKernels(FeatureIsa isa) {
+    const auto& cpu = smile2unlock::cpu::GetCpuFeatures();
+#if defined(FEATURE_MATH_X86)
+    if ((isa == FeatureIsa::Auto || isa == FeatureIsa::AVX2) && cpu.avx2 && cpu.fma) return &kAvx2Kernels;
+    if ((isa == FeatureIsa::Auto || isa == FeatureIsa::SSE2 || isa == FeatureIsa::AVX2) && cpu.sse2) {
+        return &kSse2Kernels;
+    }
+#elif defined(FEATURE_MATH_NEON)
+    if ((isa == FeatureIsa::Auto || isa == FeatureIsa::NEON) && cpu.neon) return &kNeonKernels;
+#endif
+    (void)cpu;
+    return &kScalarKernels;
+}
+
+std::atomic<const FeatureKernels*>& ActiveKernelsSlot() {
+    static std::atomic<const FeatureKernels*> active{ResolveKernels(FeatureIsa::Auto)};
+    return active;
+}
+
+const FeatureKernels& ActiveKernels() {
+    return *ActiveKernelsSlot().load(std::memory_order_relaxed);
+}
+
+int HexValue(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return 10 + (ch - 'a');
+    if (ch >= 'A' && ch <= 'F') return 10 + (ch - 'A');
+    return -1;
+}
+
+} // namespace
+
+export namespace smile2unlock::feature {
+
+// 选择运算实现；请求的指令集不可用时回退到可用的最佳实现。返回实际生效的指令集
+FeatureIsa SetFeatureIsa(FeatureIsa isa) {
+    const FeatureKernels* kernels = ResolveKernels(isa);
+    ActiveKernelsSlot().store(kernels, std::memory_order_relaxed);
+    return kernels->isa;
+}
+
+const char* ActiveFeatureIsaName() {
+    return ActiveKernels().name;
+}
+
+float Dot(const float* a, const float* b, std::size_t n) {
+    if (a == nullptr || b == nullptr || n == 0) return 0.0f;
+    return ActiveKernels().dot(a, b, n);
+}
+
+// 余弦相似度；任一向量为零向量或含 NaN/Inf 时返回 false
+bool CosineSimilarity(const float* a, const float* b, std::size_t n, float& similarity) {
+    similarity = 0.0f;
+    if (a == nullptr || b == nullptr || n == 0) return false;
+    const auto& kernels = ActiveKernels();
+    const float norm = std::sqrt(kernels.dot(a, a, n)) * std::sqrt(kernels.dot(b, b, n));
+    if (!(norm > 0.0f) || !std::isfinite(norm)) return false;
+    const float value = kernels.dot(a, b, n) / norm;
+    if (!std::isfinite(value)) return false;
+    similarity = std::clamp(value, -1.0f, 1.0f);
+    return true;
+}
+
+// L2 归一化；零向量或含 NaN/Inf 时返回 false 且不修改
+bool Normalize(float* v, std::size_t n) {
+    if (v == nullptr || n == 0) return false;
+    const float norm = std::sqrt(ActiveKernels().dot(v, v, n));
+    if (!(norm > 0.0f) || !std::isfinite(norm)) return false;
+    const float inv = 1.0f / norm;
+    for (std::size_t i = 0; i < n; ++i) v[i] *= inv;
+    return true;
+}
+
+/**
+ * 分数矩阵：scores[p * gallery_count + g] = dot(probes[p], gallery[g])
+ *
+ * probes / gallery 为按行紧密排列的 dim 维向量，调用方负责预先归一化。
+ * 每次用一个探针同时与 4 个图库向量计算，探针数据只从缓存读取一遍。
+ */
+void ScoreMatrix(const float* probes, std::size_t probe_count,
+                 const float* gallery, std::size_t gallery_count,
+                 std::size_t dim, float* scores) {
+    if (probes == nullptr || gallery == nullptr || scores == nullptr || dim == 0) return;
+    const auto& kernels = ActiveKernels();
+    for (std::size_t p = 0; p < probe_count; ++p) {
+        const float* probe = probes + p * dim;
+        float* row = scores + p * gallery_count;
+        std::size_t g = 0;
+        for (; g + 4 <= gallery_count; g += 4) {
+            const float* rows[4] = {gallery + g * dim, gallery + (g + 1) * dim,
+                                    gallery + (g + 2) * dim, gallery + (g + 3) * dim};
+            kernels.dot4(probe, rows, dim, row + g);
+        }
+        for (; g < gallery_count; ++g) {
+            row[g] = kernels.dot(probe, gallery + g * dim, dim);
+        }
+    }
+}
+
+// 十六进制特征串（float 小端字节）-> 特征向量；长度或字符非法时返回 false
+bool DecodeFeatureHex(std::string_view hex, std::vector<float>& feature) {
+    feature.clear();
+    if (hex.empty() || hex.size() % (2 * sizeof(float)) != 0) {
+        return false;
+    }
+    std::vector<unsigned char> bytes(hex.size() / 2);
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        const int high = HexValue(hex[i * 2]);
+        const int low = HexValue(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes[i] = static_cast<unsigned char>((high << 4) | low);
+    }
+    feature.resize(bytes.size() / sizeof(float));
+    std::memcpy(feature.data(), bytes.data(), bytes.size());
+    return true;
+}
+
+} // namespace smile2unlock::feature
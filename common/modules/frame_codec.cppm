@@ -0,0 +1,325 @@
+module;
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FRAME_CODEC_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FRAME_CODEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集；MSVC 允许直接使用内建函数
+#if defined(FRAME_CODEC_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FRAME_CODEC_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define FRAME_CODEC_TARGET_SSSE3
+#endif
+
+export module frame_codec;
+
+import std;
+import cpu_features;
+
+// 预览帧编码：24 位三通道 <-> RGB565
+//
+// 编码按字节顺序打包，不区分 RGB / BGR：第 0 字节取高 5 位放入 bit 11-15，第 1 字节取高 6 位放入 bit 5-10，
+// 第 2 字节取高 5 位放入 bit 0-4，小端 uint16 存储。解码做位复制（5 位 x -> (x << 3) | (x >> 2)），
+// 纯白 / 纯黑无偏差，其余每通道误差不超过 7（绿色不超过 3）。所有 SIMD 实现与标量实现逐位一致。
+
+export namespace smile2unlock::codec {
+
+enum class CodecIsa {
+    Auto,
+    Scalar,
+    SSSE3,
+    NEON,
+};
+
+} // namespace smile2unlock::codec
+
+namespace {
+
+using smile2unlock::codec::CodecIsa;
+
+using EncodeRowFn = void (*)(const std::uint8_t* src, std::uint8_t* dst, int width);
+using DecodeRowFn = void (*)(const std::uint8_t* src, std::uint8_t* dst, int width);
+
+struct CodecKernels {
+    CodecIsa isa;
+    const char* name;
+    EncodeRowFn encode_rgb565;
+    DecodeRowFn decode_rgb565;
+};
+
+// ---------------------------------------------------------------- 标量
+
+inline std::uint16_t PackRgb565(std::uint8_t c0, std::uint8_t c1, std::uint8_t c2) {
+    return static_cast<std::uint16_t>(((c0 & 0xF8) << 8) | ((c1 & 0xFC) << 3) | (c2 >> 3));
+}
+
+// 以下标量行函数从 begin 开始处理，兼作 SIMD 实现的尾部
+void EncodeRgb565RowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const std::uint16_t v = PackRgb565(src[x * 3], src[x * 3 + 1], src[x * 3 + 2]);
+        dst[x * 2] = static_cast<std::uint8_t>(v & 0xFF);
+        dst[x * 2 + 1] = static_cast<std::uint8_t>(v >> 8);
+    }
+}
+
+void DecodeRgb565RowScalarFrom(const std::uint8_t* src, std::uint8_t* dst, int begin, int width) {
+    for (int x = begin; x < width; ++x) {
+        const int v = src[x * 2] | (src[x * 2 + 1] << 8);
+        const int c0 = v >> 11;
+        const int c1 = (v >> 5) & 0x3F;
+        const int c2 = v & 0x1F;
+        dst[x * 3] = static_cast<std::uint8_t>((c0 << 3) | (c0 >> 2));
+        dst[x * 3 + 1] = static_cast<std::uint8_t>((c1 << 2) | (c1 >> 4));
+        dst[x * 3 + 2] = static_cast<std::uint8_t>((c2 << 3) | (c2 >> 2));
+    }
+}
+
+void EncodeRgb565RowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    EncodeRgb565RowScalarFrom(src, dst, 0, width);
+}
+
+void DecodeRgb565RowScalar(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    DecodeRgb565RowScalarFrom(src, dst, 0, width);
+}
+
+constexpr CodecKernels kScalarKernels{
+    CodecIsa::Scalar, "scalar", EncodeRgb565RowScalar, DecodeRgb565RowScalar};
+
+#if defined(FRAME_CODEC_X86)
+
+// ---------------------------------------------------------------- SSSE3
+// 每次处理 16 个像素（48 字节）：pshufb 在交错的三通道与三个平面之间重排，掩码在编译期生成
+
+// 交错字节 [16*chunk, 16*chunk+16) 中属于通道 channel 的字节 -> 平面中的位置
+constexpr std::array<std::int8_t, 16> PlaneGatherMask(int channel, int chunk) {
+    std::array<std::int8_t, 16> mask{};
+    for (int p = 0; p < 16; ++p) {
+        const int source = p * 3 + channel - chunk * 16;
+        mask[p] = (source >= 0 && source < 16) ? static_cast<std::int8_t>(source) : static_cast<std::int8_t>(-128);
+    }
+    return mask;
+}
+
+// 平面 channel -> 交错字节 [16*chunk, 16*chunk+16) 中该通道的位置
+constexpr std::array<std::int8_t, 16> InterleaveMask(int channel, int chunk) {
+    std::array<std::int8_t, 16> mask{};
+    for (int j = 0; j < 16; ++j) {
+        const int byte = chunk * 16 + j;
+        mask[j] = (byte % 3 == channel) ? static_cast<std::int8_t>(byte / 3) : static_cast<std::int8_t>(-128);
+    }
+    return mask;
+}
+
+template <int Channel, int Chunk>
+struct GatherMask {
+    static constexpr std::array<std::int8_t, 16> value = PlaneGatherMask(Channel, Chunk);
+};
+
+template <int Channel, int Chunk>
+struct ScatterMask {
+    static constexpr std::array<std::int8_t, 16> value = InterleaveMask(Channel, Chunk);
+};
+
+template <typename Mask>
+FRAME_CODEC_TARGET_SSSE3 inline __m128i LoadMask() {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Mask::value.data()));
+}
+
+template <int Channel>
+FRAME_CODEC_TARGET_SSSE3 inline __m128i GatherPlane(__m128i a, __m128i b, __m128i c) {
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, LoadMask<GatherMask<Channel, 0>>()),
+                                     _mm_shuffle_epi8(b, LoadMask<GatherMask<Channel, 1>>())),
+                        _mm_shuffle_epi8(c, LoadMask<GatherMask<Channel, 2>>()));
+}
+
+template <int Chunk>
+FRAME_CODEC_TARGET_SSSE3 inline __m128i InterleaveChunk(__m128i p0, __m128i p1, __m128i p2) {
+    return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(p0, LoadMask<ScatterMask<0, Chunk>>()),
+                                     _mm_shuffle_epi8(p1, LoadMask<ScatterMask<1, Chunk>>())),
+                        _mm_shuffle_epi8(p2, LoadMask<ScatterMask<2, Chunk>>()));
+}
+
+FRAME_CODEC_TARGET_SSSE3 void EncodeRgb565RowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask5 = _mm_set1_epi8(static_cast<char>(0xF8));
+    const __m128i mask6 = _mm_set1_epi8(static_cast<char>(0xFC));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const std::uint8_t* p = src + x * 3;
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+        const __m128i c0 = _mm_and_si128(GatherPlane<0>(a, b, c), mask5);
+        const __m128i c1 = _mm_and_si128(GatherPlane<1>(a, b, c), mask6);
+        const __m128i c2 = GatherPlane<2>(a, b, c);
+
+        // c0 直接作为高字节；c1 左移 3 位跨越两个字节；c2 右移 3 位落在低字节
+        const __m128i lo = _mm_or_si128(_mm_or_si128(_mm_unpacklo_epi8(zero, c0),
+                                                     _mm_slli_epi16(_mm_unpacklo_epi8(c1, zero), 3)),
+                                        _mm_srli_epi16(_mm_unpacklo_epi8(c2, zero), 3));
+        const __m128i hi = _mm_or_si128(_mm_or_si128(_mm_unpackhi_epi8(zero, c0),
+                                                     _mm_slli_epi16(_mm_unpackhi_epi8(c1, zero), 3)),
+                                        _mm_srli_epi16(_mm_unpackhi_epi8(c2, zero), 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2 + 16), hi);
+    }
+    EncodeRgb565RowScalarFrom(src, dst, x, width);
+}
+
+// 8 个 16 位像素 -> 三个通道（各 8 个 16 位值，已按位复制扩展到 8 位）
+FRAME_CODEC_TARGET_SSSE3 inline void ExpandRgb565(__m128i v, __m128i& c0, __m128i& c1, __m128i& c2) {
+    const __m128i m5 = _mm_set1_epi16(0x1F);
+    const __m128i m6 = _mm_set1_epi16(0x3F);
+    const __m128i r = _mm_srli_epi16(v, 11);
+    const __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), m6);
+    const __m128i b = _mm_and_si128(v, m5);
+    c0 = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+    c1 = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+    c2 = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+}
+
+FRAME_CODEC_TARGET_SSSE3 void DecodeRgb565RowSsse3(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2 + 16));
+        __m128i a0, a1, a2, b0, b1, b2;
+        ExpandRgb565(v0, a0, a1, a2);
+        ExpandRgb565(v1, b0, b1, b2);
+        const __m128i p0 = _mm_packus_epi16(a0, b0);
+        const __m128i p1 = _mm_packus_epi16(a1, b1);
+        const __m128i p2 = _mm_packus_epi16(a2, b2);
+        std::uint8_t* out = dst + x * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), InterleaveChunk<0>(p0, p1, p2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), InterleaveChunk<1>(p0, p1, p2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), InterleaveChunk<2>(p0, p1, p2));
+    }
+    DecodeRgb565RowScalarFrom(src, dst, x, width);
+}
+
+constexpr CodecKernels kSsse3Kernels{
+    CodecIsa::SSSE3, "ssse3", EncodeRgb565RowSsse3, DecodeRgb565RowSsse3};
+
+#endif // FRAME_CODEC_X86
+
+#if defined(FRAME_CODEC_NEON)
+
+// ---------------------------------------------------------------- NEON
+
+void EncodeRgb565RowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    const uint8x16_t mask5 = vdupq_n_u8(0xF8);
+    const uint8x16_t mask6 = vdupq_n_u8(0xFC);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16x3_t p = vld3q_u8(src + x * 3);
+        const uint8x16_t c0 = vandq_u8(p.val[0], mask5);
+        const uint8x16_t c1 = vandq_u8(p.val[1], mask6);
+        const uint8x16_t c2 = vshrq_n_u8(p.val[2], 3);
+        uint16x8_t lo = vshll_n_u8(vget_low_u8(c0), 8);
+        lo = vorrq_u16(lo, vshll_n_u8(vget_low_u8(c1), 3));
+        lo = vorrq_u16(lo, vmovl_u8(vget_low_u8(c2)));
+        uint16x8_t hi = vshll_n_u8(vget_high_u8(c0), 8);
+        hi = vorrq_u16(hi, vshll_n_u8(vget_high_u8(c1), 3));
+        hi = vorrq_u16(hi, vmovl_u8(vget_high_u8(c2)));
+        vst1q_u8(dst + x * 2, vreinterpretq_u8_u16(lo));
+        vst1q_u8(dst + x * 2 + 16, vreinterpretq_u8_u16(hi));
+    }
+    EncodeRgb565RowScalarFrom(src, dst, x, width);
+}
+
+// 8 个 16 位像素 -> 三个 8 位通道
+inline void ExpandRgb565(uint16x8_t v, uint8x8_t& c0, uint8x8_t& c1, uint8x8_t& c2) {
+    const uint8x8_t r = vand_u8(vshrn_n_u16(v, 8), vdup_n_u8(0xF8));
+    const uint8x8_t g = vand_u8(vshrn_n_u16(v, 3), vdup_n_u8(0xFC));
+    const uint8x8_t b = vshl_n_u8(vmovn_u16(v), 3);
+    c0 = vorr_u8(r, vshr_n_u8(r, 5));
+    c1 = vorr_u8(g, vshr_n_u8(g, 6));
+    c2 = vorr_u8(b, vshr_n_u8(b, 5));
+}
+
+void DecodeRgb565RowNeon(const std::uint8_t* src, std::uint8_t* dst, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const uint16x8_t v0 = vreinterpretq_u16_u8(vld1q_u8(src + x * 2));
+        const uint16x8_t v1 = vreinterpretq_u16_u8(vld1q_u8(src + x * 2 + 16));
+        uint8x8_t a0, a1, a2, b0, b1, b2;
+        ExpandRgb565(v0, a0, a1, a2);
+        ExpandRgb565(v1, b0, b1, b2);
+        uint8x16x3_t out;
+        out.val[0] = vcombine_u8(a0, b0);
+        out.val[1] = vcombine_u8(a1, b1);
+        out.val[2] = vcombine_u8(a2, b2);
+        vst3q_u8(dst + x * 3, out);
+    }
+    DecodeRgb565RowScalarFrom(src, dst, x, width);
+}
+
+constexpr CodecKernels kNeonKernels{
+    CodecIsa::NEON, "neon", EncodeRgb565RowNeon, DecodeRgb565RowNeon};
+
+#endif // FRAME_CODEC_NEON
+
+const CodecKernels* ResolveKernels(CodecIsa isa) {
+    const auto& cpu = smile2unlock::cpu::GetCpuFeatures();
+#if defined(FRAME_CODEC_X86)
+    if ((isa == CodecIsa::Auto || isa == CodecIsa::SSSE3) && cpu.ssse3) return &kSsse3Kernels;
+#elif defined(FRAME_CODEC_NEON)
+    if ((isa == CodecIsa::Auto || isa == CodecIsa::NEON) && cpu.neon) return &kNeonKernels;
+#endif
+    (void)cpu;
+    return &kScalarKernels;
+}
+
+std::atomic<const CodecKernels*>& ActiveKernelsSlot() {
+    static std::atomic<const CodecKernels*> active{ResolveKernels(CodecIsa::Auto)};
+    return active;
+}
+
+const CodecKernels& ActiveKernels() {
+    return *ActiveKernelsSlot().load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+export namespace smile2unlock::codec {
+
+// 选择编解码实现；请求的指令集不可用时回退到可用的最佳实现。返回实际生效的指令集
+CodecIsa SetCodecIsa(CodecIsa isa) {
+    const CodecKernels* kernels = ResolveKernels(isa);
+    ActiveKernelsSlot().store(kernels, std::memory_order_relaxed);
+    return kernels->isa;
+}
+
+const char* ActiveCodecIsaName() {
+    return ActiveKernels().name;
+}
+
+constexpr std::size_t Rgb565Bytes(int width, int height) {
+    return (width > 0 && height > 0) ? static_cast<std::size_t>(width) * height * 2 : 0;
+}
+
+// 24 位三通道 -> RGB565，输出按行紧密排列（行跨度 width * 2）
+bool EncodeRgb565(const std::uint8_t* src, int src_stride, int width, int height, std::uint8_t* dst) {
+    if (src == nullptr || dst == nullptr || width <= 0 || height <= 0 || src_stride < width * 3) return false;
+    const auto row = ActiveKernels().encode_rgb565;
+    for (int y = 0; y < height; ++y) {
+        row(src + static_cast<std::ptrdiff_t>(y) * src_stride, dst + static_cast<std::ptrdiff_t>(y) * width * 2, width);
+    }
+    return true;
+}
+
+// RGB565（行跨度 width * 2）-> 24 位三通道
+bool DecodeRgb565(const std::uint8_t* src, int width, int height, std::uint8_t* dst, int dst_stride) {
+    if (src == nullptr || dst == nullptr || width <= 0 || height <= 0 || dst_stride < width * 3) return false;
+    const auto row = ActiveKernels().decode_rgb565;
+    for (int y = 0; y < height; ++y) {
+        row(src + static_cast<std::ptrdiff_t>(y) * width * 2, dst + static_cast<std::ptrdiff_t>(y) * dst_stride, width);
+    }
+    return true;
+}
+
+} // namespace smile2unlock::codec
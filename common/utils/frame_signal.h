@@ -0,0 +1,190 @@
+#pragma once
+
+#include "utils/shared_region.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace smile2unlock {
+
+/**
+ * @brief 共享区域的新帧通知（与 SharedRegion 配对使用）
+ *
+ * 等待条件是共享区域内的一个 32 位帧号字：写端发布新帧（帧号递增）后调用 Notify()，
+ * 读端 WaitForChange() 阻塞到帧号不等于上次读到的值或超时。
+ * - Windows：名为 "<区域名>_FrameReady" 的自动重置事件，由创建共享区域的一方创建，
+ *   每个事件只应有一个等待者（SU 的预览读取线程）
+ * - Linux：直接在共享内存中的帧号字上做进程间 futex 等待 / 唤醒，不需要额外的内核对象
+ * - 其他平台：按短间隔轮询帧号
+ * 事件创建 / 打开失败（包括创建时同名事件已存在）时 valid() 为 false，
+ * WaitForChange() 退回轮询，Notify() 无操作。
+ */
+class FrameReadySignal {
+public:
+    FrameReadySignal() = default;
+
+    ~FrameReadySignal() {
+        Reset();
+    }
+
+    FrameReadySignal(FrameReadySignal&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    FrameReadySignal& operator=(FrameReadySignal&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            word_ = std::exchange(other.word_, nullptr);
+            error_ = std::exchange(other.error_, 0);
+#if defined(_WIN32)
+            event_ = std::exchange(other.event_, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    FrameReadySignal(const FrameReadySignal&) = delete;
+    FrameReadySignal& operator=(const FrameReadySignal&) = delete;
+
+    /**
+     * @brief 创建通知（读端，即共享区域的创建方）
+     *
+     * @param region_name 配对的共享区域名称
+     * @param word 共享区域内的帧号字，须 4 字节对齐且在本对象存续期间保持映射
+     * @param options 仅使用其中的安全描述符
+     */
+    static FrameReadySignal Create(const std::string& region_name, const std::uint32_t* word,
+                                   const SharedRegionOptions& options = {}) {
+        FrameReadySignal signal;
+        signal.word_ = word;
+#if defined(_WIN32)
+        signal.event_ = CreateEventA(options.security, FALSE, FALSE, EventName(region_name).c_str());
+        if (signal.event_ == nullptr) {
+            signal.error_ = static_cast<int>(GetLastError());
+        } else if (GetLastError() == ERROR_ALREADY_EXISTS) {
+            // 同名事件已被他人抢先创建（安全描述符不是我们的），与 SharedRegion::Create 一样拒绝使用
+            CloseHandle(signal.event_);
+            signal.event_ = nullptr;
+            signal.error_ = ERROR_ALREADY_EXISTS;
+        }
+#else
+        (void)region_name;
+        (void)options;
+#endif
+        return signal;
+    }
+
+    // 打开读端创建的通知（写端）；读端未创建时 valid() 为 false
+    static FrameReadySignal Open(const std::string& region_name, const std::uint32_t* word) {
+        FrameReadySignal signal;
+        signal.word_ = word;
+#if defined(_WIN32)
+        signal.event_ = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, EventName(region_name).c_str());
+        if (signal.event_ == nullptr) {
+            signal.error_ = static_cast<int>(GetLastError());
+        }
+#else
+        (void)region_name;
+#endif
+        return signal;
+    }
+
+    void Reset() {
+#if defined(_WIN32)
+        if (event_ != nullptr) CloseHandle(event_);
+        event_ = nullptr;
+#endif
+        word_ = nullptr;
+    }
+
+    bool valid() const {
+#if defined(_WIN32)
+        return word_ != nullptr && event_ != nullptr;
+#elif defined(__linux__)
+        return word_ != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    int error() const { return error_; }
+
+    // 帧号字已更新后调用，唤醒等待中的读端
+    void Notify() const {
+        if (!valid()) return;
+#if defined(_WIN32)
+        SetEvent(event_);
+#elif defined(__linux__)
+        syscall(SYS_futex, const_cast<std::uint32_t*>(word_), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    /**
+     * @brief 等待帧号变化
+     *
+     * @param last_seen 上次读到的帧号；当前帧号已不同时立即返回
+     * @param timeout 最长等待时间
+     * @return 帧号是否已不等于 last_seen（超时或被 Notify() 唤醒但帧号未变时为 false）
+     */
+    bool WaitForChange(std::uint32_t last_seen, std::chrono::milliseconds timeout) const {
+        if (word_ == nullptr) return false;
+        if (Load() != last_seen) return true;
+        if (timeout.count() <= 0) return false;
+#if defined(_WIN32)
+        if (event_ != nullptr) {
+            // 自动重置事件：检查与等待之间发布的帧会让事件保持有信号，不会丢失唤醒
+            WaitForSingleObject(event_, static_cast<DWORD>(timeout.count()));
+            return Load() != last_seen;
+        }
+#elif defined(__linux__)
+        timespec ts{};
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+        // 帧号已不等于 last_seen 时内核立即返回 EAGAIN；被唤醒、超时或 EINTR 后统一重新读取
+        syscall(SYS_futex, const_cast<std::uint32_t*>(word_), FUTEX_WAIT, last_seen, &ts, nullptr, 0);
+        return Load() != last_seen;
+#endif
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(kPollInterval);
+            if (Load() != last_seen) return true;
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::chrono::milliseconds kPollInterval{2};
+
+#if defined(_WIN32)
+    static std::string EventName(const std::string& region_name) {
+        return region_name + "_FrameReady";
+    }
+#endif
+
+    std::uint32_t Load() const {
+        return std::atomic_ref<std::uint32_t>(const_cast<std::uint32_t&>(*word_)).load(std::memory_order_acquire);
+    }
+
+    const std::uint32_t* word_ = nullptr;
+    int error_ = 0;
+#if defined(_WIN32)
+    HANDLE event_ = nullptr;
+#endif
+};
+
+} // namespace smile2unlock
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace smile2unlock {
+
+enum class SharedRegionAccess {
+    ReadOnly,
+    ReadWrite,
+};
+
+struct SharedRegionOptions {
+#if defined(_WIN32)
+    SECURITY_ATTRIBUTES* security = nullptr;  // 为空时使用默认安全描述符
+#endif
+    bool huge_pages = false;  // 大页提示：不可用（权限 / 系统配置）时静默退回普通页
+};
+
+/**
+ * @brief 具名共享内存区域（RAII）
+ *
+ * Windows 为页面文件支持的文件映射；其他平台为 shm_open + mmap，名称中的 '\\' 替换为 '_' 并加 '/' 前缀，
+ * 创建方析构时 shm_unlink，已映射的读端不受影响（与 Windows 最后一个句柄关闭时释放的语义接近）。
+ * 打开失败时 valid() 为 false，error() 为 GetLastError / errno。
+ */
+class SharedRegion {
+public:
+    SharedRegion() = default;
+
+    ~SharedRegion() {
+        Reset();
+    }
+
+    SharedRegion(SharedRegion&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    SharedRegion& operator=(SharedRegion&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            name_ = std::move(other.name_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            error_ = std::exchange(other.error_, 0);
+            huge_pages_ = std::exchange(other.huge_pages_, false);
+#if defined(_WIN32)
+            handle_ = std::exchange(other.handle_, nullptr);
+#else
+            owner_ = std::exchange(other.owner_, false);
+#endif
+        }
+        return *this;
+    }
+
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    /**
+     * @brief 创建新区域并以读写方式映射
+     *
+     * 同名区域已存在时失败（error() 为 ERROR_ALREADY_EXISTS / EEXIST），不会附着到他人预先创建、
+     * 安全描述符可能更宽松的区域，也不会截断或删除它。调用方应使用每次唯一的名称。
+     *
+     * @param bytes 区域大小，0 按 1 字节处理；使用大页时向上取整到大页大小
+     */
+    static SharedRegion Create(const std::string& name, std::size_t bytes, const SharedRegionOptions& options = {}) {
+        SharedRegion region;
+        region.name_ = name;
+        bytes = bytes == 0 ? 1 : bytes;
+#if defined(_WIN32)
+        if (options.huge_pages) {
+            const SIZE_T large_page = GetLargePageMinimum();
+            if (large_page > 0) {
+                const std::size_t rounded = (bytes + large_page - 1) / large_page * large_page;
+                region.handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, options.security,
+                                                    PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES,
+                                                    HighDword(rounded), LowDword(rounded), name.c_str());
+                if (region.handle_ != nullptr && GetLastError() == ERROR_ALREADY_EXISTS) {
+                    region.FailAlreadyExists();
+                    return region;
+                }
+                if (region.handle_ != nullptr) {
+                    bytes = rounded;
+                    region.huge_pages_ = true;
+                }
+            }
+        }
+        if (region.handle_ == nullptr) {
+            region.handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, options.security, PAGE_READWRITE,
+                                                HighDword(bytes), LowDword(bytes), name.c_str());
+            if (region.handle_ != nullptr && GetLastError() == ERROR_ALREADY_EXISTS) {
+                region.FailAlreadyExists();
+                return region;
+            }
+        }
+        if (region.handle_ == nullptr) {
+            region.error_ = static_cast<int>(GetLastError());
+            return region;
+        }
+        DWORD map_flags = FILE_MAP_ALL_ACCESS;
+#if defined(FILE_MAP_LARGE_PAGES)
+        if (region.huge_pages_) map_flags |= FILE_MAP_LARGE_PAGES;
+#endif
+        region.data_ = MapViewOfFile(region.handle_, map_flags, 0, 0, bytes);
+        if (region.data_ == nullptr) {
+            region.error_ = static_cast<int>(GetLastError());
+            region.Reset();
+            return region;
+        }
+        region.size_ = bytes;
+#else
+        const std::string path = PosixName(name);
+        const int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            region.error_ = errno;
+            return region;
+        }
+        region.owner_ = true;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            region.error_ = errno;
+            close(fd);
+            region.Reset();
+            return region;
+        }
+        void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            region.error_ = errno;
+            region.Reset();
+            return region;
+        }
+        region.data_ = mapped;
+        region.size_ = bytes;
+#if defined(MADV_HUGEPAGE)
+        if (options.huge_pages) {
+            region.huge_pages_ = madvise(mapped, bytes, MADV_HUGEPAGE) == 0;
+        }
+#endif
+#endif
+        return region;
+    }
+
+    /**
+     * @brief 打开已有区域并映射整个区域
+     *
+     * @param min_bytes 区域至少应有的大小，不足时视为失败
+     * @param attempts 打开失败时的尝试次数（创建方可能尚未就绪），每次间隔 retry_interval
+     */
+    static SharedRegion Open(const std::string& name, std::size_t min_bytes, SharedRegionAccess access,
+                             int attempts = 1,
+                             std::chrono::milliseconds retry_interval = std::chrono::milliseconds(50)) {
+        SharedRegion region;
+        region.name_ = name;
+        const bool writable = access == SharedRegionAccess::ReadWrite;
+#if defined(_WIN32)
+        const DWORD desired = writable ? (FILE_MAP_READ | FILE_MAP_WRITE) : FILE_MAP_READ;
+        for (int attempt = 0; attempt < attempts && region.handle_ == nullptr; ++attempt) {
+            if (attempt > 0) std::this_thread::sleep_for(retry_interval);
+            region.handle_ = OpenFileMappingA(desired, FALSE, name.c_str());
+        }
+        if (region.handle_ == nullptr) {
+            region.error_ = static_cast<int>(GetLastError());
+            return region;
+        }
+        region.data_ = MapViewOfFile(region.handle_, desired, 0, 0, 0);
+        if (region.data_ == nullptr) {
+            region.error_ = static_cast<int>(GetLastError());
+            region.Reset();
+            return region;
+        }
+        MEMORY_BASIC_INFORMATION info{};
+        region.size_ = VirtualQuery(region.data_, &info, sizeof(info)) != 0 ? info.RegionSize : 0;
+#else
+        const std::string path = PosixName(name);
+        int fd = -1;
+        for (int attempt = 0; attempt < attempts && fd < 0; ++attempt) {
+            if (attempt > 0) std::this_thread::sleep_for(retry_interval);
+            fd = shm_open(path.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+        }
+        if (fd < 0) {
+            region.error_ = errno;
+            return region;
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            region.error_ = errno != 0 ? errno : EINVAL;
+            close(fd);
+            return region;
+        }
+        const auto bytes = static_cast<std::size_t>(st.st_size);
+        void* mapped = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            region.error_ = errno;
+            return region;
+        }
+        region.data_ = mapped;
+        region.size_ = bytes;
+#endif
+        if (region.size_ < min_bytes) {
+#if defined(_WIN32)
+            region.error_ = ERROR_INVALID_DATA;
+#else
+            region.error_ = EINVAL;
+#endif
+            region.Reset();
+        }
+        return region;
+    }
+
+    // 解除映射并关闭；创建方在 POSIX 下同时删除名称
+    void Reset() {
+#if defined(_WIN32)
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (handle_ != nullptr) CloseHandle(handle_);
+        handle_ = nullptr;
+#else
+        if (data_ != nullptr) munmap(data_, size_);
+        if (owner_) shm_unlink(PosixName(name_).c_str());
+        owner_ = false;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        huge_pages_ = false;
+    }
+
+    bool valid() const { return data_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string& name() const { return name_; }
+    int error() const { return error_; }
+    bool huge_pages() const { return huge_pages_; }
+
+    template <typename T>
+    T* as() const {
+        return static_cast<T*>(data_);
+    }
+
+private:
+#if defined(_WIN32)
+    // CreateFileMapping 打开了同名的已有映射：关闭句柄并按失败处理
+    void FailAlreadyExists() {
+        CloseHandle(handle_);
+        handle_ = nullptr;
+        error_ = ERROR_ALREADY_EXISTS;
+    }
+
+    static DWORD HighDword(std::size_t value) {
+        return static_cast<DWORD>(static_cast<std::uint64_t>(value) >> 32);
+    }
+
+    static DWORD LowDword(std::size_t value) {
+        return static_cast<DWORD>(static_cast<std::uint64_t>(value) & 0xFFFFFFFFu);
+    }
+#else
+    static std::string PosixName(const std::string& name) {
+        std::string path = "/";
+        for (const char ch : name) {
+            path += (ch == '\\' || ch == '/') ? '_' : ch;
+        }
+        return path;
+    }
+#endif
+
+    std::string name_;
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    int error_ = 0;
+    bool huge_pages_ = false;
+#if defined(_WIN32)
+    HANDLE handle_ = nullptr;
+#else
+    bool owner_ = false;
+#endif
+};
+
+} // namespace smile2unlock
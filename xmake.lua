@@ -95,6 +95,10 @@ target("FaceRecognizer")
     add_includedirs("FaceRecognizer/src", {public = false})
     add_includedirs("common", {public = false})
     apply_common_windows_settings("0x0A00")
+    if is_plat("windows", "mingw") then
+        add_links("windowscodecs")  -- image_io 通过 WIC 解码 JPEG / PNG
+        add_links("psapi")          -- -m test 报告峰值内存
+    end
 
     add_packages("seetaface6open")
     add_packages("cxxopts")
@@ -143,6 +147,25 @@ target("FaceRecognizer")
         batchcmds:cp("$(projectdir)/FaceRecognizer/resources", target:targetdir())
     end)
 
+-- 纯计算内核的回归测试（xmake test），不依赖模型与摄像头
+target("FaceRecognizerKernelTests")
+    apply_common_module_binary_target()
+    set_default(false)
+    add_files("FaceRecognizer/tests/*.cpp")
+    add_files(
+        "FaceRecognizer/src/modules/pixel_convert.cppm",
+        "common/modules/cpu_features.cppm",
+        "common/modules/feature_math.cppm",
+        "common/modules/frame_codec.cppm",
+        "FaceRecognizer/src/embedding_fusion.cpp",
+        "FaceRecognizer/src/face_quality.cpp",
+        "FaceRecognizer/src/motion_gate.cpp"
+    )
+    add_includedirs("FaceRecognizer/src", {public = false})
+    add_includedirs("common", {public = false})
+    add_packages("seetaface6open")  -- 仅使用 seeta/Common/CStruct.h
+    add_tests("default")
+
 
 
 target("SampleV2CredentialProvider")